@@ -4,6 +4,7 @@
 #include <numeric>
 #include <utility>
 
+#include "calendar.h"
 #include "item.h"
 #include "item_pocket.h"
 #include "safe_reference.h"
@@ -32,20 +33,9 @@ bool active_item_cache::add( item &it, point location, item *parent,
     if( speed == item::NO_PROCESSING ) {
         return ret;
     }
-    std::unordered_map<item *, safe_reference<item>> &target_index = active_items_index[speed];
-    std::list<item_reference> &target_list = active_items[speed];
-    if( target_index.empty() && !target_index.empty() ) {
-        // If the index has been cleared, rebuild it first.
-        for( item_reference &iter : target_list ) {
-            // Omit those expired references
-            if( iter.item_ref ) {
-                target_index.emplace( iter.item_ref.get(), iter.item_ref );
-            }
-        }
-    }
     // If the item is already in the cache for some reason, don't add a second reference
-    auto iter = target_index.find( &it );
-    if( iter != target_index.end() ) {
+    auto iter = active_items_index.find( &it );
+    if( iter != active_items_index.end() ) {
         // Ensure it's really what we want, and hasn't expired
         if( iter->second && iter->second.get() == &it ) {
             return true;
@@ -58,60 +48,145 @@ bool active_item_cache::add( item &it, point location, item *parent,
     if( it.get_use( "explosion" ) ) {
         special_items[special_item_type::explosive].emplace_back( ref );
     }
-    target_list.emplace_back( std::move( ref ) );
-    target_index.emplace( &it, it.get_safe_reference() );
+    if( speed <= 1 ) {
+        every_turn.push_back( { std::move( ref ), &it, speed, 0 } );
+    } else {
+        const int now = to_turn<int>( calendar::turn );
+        if( !wheels ) {
+            wheels = cata::make_value<timing_wheels>();
+        }
+        if( wheel_items == 0 ) {
+            next_turn = now;
+        }
+        // Items are spread over their processing interval by location, so that all
+        // items in one place are due together and can share their temperature lookups.
+        const size_t hash = std::hash<point>()( location );
+        const int phase = static_cast<int>( hash % static_cast<size_t>( speed ) );
+        const int offset = ( ( phase - now ) % speed + speed ) % speed;
+        item_list added;
+        added.push_back( { std::move( ref ), &it, speed, now + offset } );
+        wheel_items++;
+        schedule( added, added.begin() );
+    }
+    active_items_index[&it] = it.get_safe_reference();
     return true;
 }
 
+// The first turn from @p from on that is a whole number of @p speed turns away from
+// @p wake, so an item that missed some turns keeps its place in its interval.
+static int first_in_phase( const int wake, const int speed, const int from )
+{
+    return from + ( ( wake - from ) % speed + speed ) % speed;
+}
+
+void active_item_cache::schedule( item_list &from, const item_list::iterator it )
+{
+    it->wake_turn = std::max( it->wake_turn, next_turn );
+    const int wake = it->wake_turn;
+    item_list *to = &wheels->beyond;
+    if( wake - next_turn < wheel_size ) {
+        to = &wheels->near[wake % wheel_size];
+    } else if( wake / wheel_size - next_turn / wheel_size < wheel_size ) {
+        to = &wheels->far[wake / wheel_size % wheel_size];
+    }
+    to->splice( to->end(), from, it );
+}
+
+void active_item_cache::advance( const int now, std::vector<item_reference> &due )
+{
+    if( next_turn % wheel_size == 0 ) {
+        // A new block of turns begins: the items due in it move to the near wheel.
+        const int block = next_turn / wheel_size;
+        item_list moving;
+        if( block % wheel_size == 0 ) {
+            moving.splice( moving.end(), wheels->beyond );
+        }
+        moving.splice( moving.end(), wheels->far[block % wheel_size] );
+        while( !moving.empty() ) {
+            schedule( moving, moving.begin() );
+        }
+    }
+    item_list handing_out;
+    handing_out.splice( handing_out.end(), wheels->near[next_turn % wheel_size] );
+    const int turn = next_turn++;
+    for( item_list::iterator it = handing_out.begin(); it != handing_out.end(); ) {
+        if( !it->ref.item_ref ) {
+            it = erase( handing_out, it );
+            continue;
+        }
+        due.push_back( it->ref );
+        // When catching up on several turns, hand out each item only once.
+        it->wake_turn = first_in_phase( turn + it->speed, it->speed, now + 1 );
+        schedule( handing_out, it++ );
+    }
+}
+
+void active_item_cache::take_valid( item_list &list, std::vector<item_reference> &out )
+{
+    for( item_list::iterator it = list.begin(); it != list.end(); ) {
+        if( it->ref.item_ref ) {
+            out.push_back( it->ref );
+            ++it;
+        } else {
+            it = erase( list, it );
+        }
+    }
+}
+
+active_item_cache::item_list::iterator active_item_cache::erase( item_list &list,
+        const item_list::iterator it )
+{
+    // The address may have been reused by an item added since.
+    const auto indexed = active_items_index.find( it->key );
+    if( indexed != active_items_index.end() && !indexed->second ) {
+        active_items_index.erase( indexed );
+    }
+    if( &list != &every_turn ) {
+        wheel_items--;
+    }
+    return list.erase( it );
+}
+
 bool active_item_cache::empty() const
 {
-    return std::all_of( active_items.begin(), active_items.end(), []( const auto & active_queue ) {
-        return active_queue.second.empty();
-    } );
+    return every_turn.empty() && wheel_items == 0;
 }
 
 std::vector<item_reference> active_item_cache::get()
 {
     std::vector<item_reference> all_cached_items;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        for( std::list<item_reference>::iterator it = kv.second.begin(); it != kv.second.end(); ) {
-            if( it->item_ref ) {
-                all_cached_items.emplace_back( *it );
-                ++it;
-            } else {
-                active_items_index[kv.first].clear();
-                it = kv.second.erase( it );
-            }
-        }
-    }
+    for_each_list( [&]( item_list & list ) {
+        take_valid( list, all_cached_items );
+    } );
     return all_cached_items;
 }
 
 std::vector<item_reference> active_item_cache::get_for_processing()
 {
     std::vector<item_reference> items_to_process;
-    items_to_process.reserve( std::accumulate( active_items.begin(), active_items.end(), std::size_t{ 0 },
-    []( size_t prev, const auto & kv ) {
-        return prev + kv.second.size() / static_cast<size_t>( kv.first );
-    } ) );
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        // Rely on iteration logic to make sure the number is sane.
-        int num_to_process = kv.second.size() / kv.first;
-        std::list<item_reference>::iterator it = kv.second.begin();
-        for( ; it != kv.second.end() && num_to_process >= 0; ) {
-            if( it->item_ref ) {
-                items_to_process.push_back( *it );
-                --num_to_process;
-                ++it;
-            } else {
-                // The item has been destroyed, so remove the reference from the cache
-                active_items_index[kv.first].clear();
-                it = kv.second.erase( it );
+    take_valid( every_turn, items_to_process );
+    if( wheel_items == 0 ) {
+        wheels.reset();
+        return items_to_process;
+    }
+    const int now = to_turn<int>( calendar::turn );
+    if( now < next_turn - 1 || now - next_turn >= wheel_size ) {
+        // Nothing was processed for a long time, or the clock was turned back.  Rather
+        // than stepping through every turn, move every item to its next turn in phase.
+        item_list all;
+        for_each_list( [&]( item_list & list ) {
+            if( &list != &every_turn ) {
+                all.splice( all.end(), list );
             }
+        } );
+        next_turn = now;
+        while( !all.empty() ) {
+            all.front().wake_turn = first_in_phase( all.front().wake_turn, all.front().speed, now );
+            schedule( all, all.begin() );
         }
-        // Rotate the returned items to the end of their list so that the items that weren't
-        // returned this time will be first in line on the next call
-        kv.second.splice( kv.second.end(), kv.second, kv.second.begin(), it );
+    }
+    while( next_turn <= now ) {
+        advance( now, items_to_process );
     }
     return items_to_process;
 }
@@ -133,31 +208,31 @@ std::vector<item_reference> active_item_cache::get_special( special_item_type ty
 
 void active_item_cache::subtract_locations( const point &delta )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            ir.location -= delta;
+    for_each_list( [&]( item_list & list ) {
+        for( scheduled_item &scheduled : list ) {
+            scheduled.ref.location -= delta;
         }
-    }
+    } );
 }
 
 void active_item_cache::rotate_locations( int turns, const point &dim )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
-            ir.location = ir.location.rotate( turns, dim );
+    for_each_list( [&]( item_list & list ) {
+        for( scheduled_item &scheduled : list ) {
+            scheduled.ref.location = scheduled.ref.location.rotate( turns, dim );
         }
-    }
+    } );
 }
 
 void active_item_cache::mirror( const point &dim, bool horizontally )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
+    for_each_list( [&]( item_list & list ) {
+        for( scheduled_item &scheduled : list ) {
             if( horizontally ) {
-                ir.location.x = dim.x - 1 - ir.location.x;
+                scheduled.ref.location.x = dim.x - 1 - scheduled.ref.location.x;
             } else {
-                ir.location.y = dim.y - 1 - ir.location.y;
+                scheduled.ref.location.y = dim.y - 1 - scheduled.ref.location.y;
             }
         }
-    }
+    } );
 }
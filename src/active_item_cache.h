@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_ACTIVE_ITEM_CACHE_H
 #define CATA_SRC_ACTIVE_ITEM_CACHE_H
 
+#include <array>
 #include <cstddef>
 #include <list>
 #include <unordered_map>
@@ -9,6 +10,7 @@
 
 #include "point.h"
 #include "safe_reference.h"
+#include "value_ptr.h"
 
 class item;
 class item_pocket;
@@ -47,12 +49,71 @@ struct hash<special_item_type> {
 };
 } // namespace std
 
+/**
+ * Active items on a submap or vehicle, scheduled by when they next need processing.
+ *
+ * Items that process every turn are kept in one list that is returned on every call
+ * of @ref get_for_processing.  All others wait in a hierarchical timing wheel until
+ * the turn they are due, so a turn only costs as much as the items actually due in it,
+ * no matter how many items are waiting.  An item that is due is rescheduled
+ * item::processing_speed() turns later.
+ */
 class active_item_cache
 {
     private:
-        std::unordered_map<int, std::list<item_reference>> active_items;
+        struct scheduled_item {
+            item_reference ref;
+            // The item ref pointed to when it was added, its key in active_items_index.
+            item *key;
+            int speed;
+            int wake_turn;
+        };
+        using item_list = std::list<scheduled_item>;
+
+        static constexpr int wheel_size = 128;
+        // The near wheel has a slot for each of the next wheel_size turns, the far
+        // wheel one for each of the next wheel_size blocks of wheel_size turns.  Items
+        // due further in the future wait in beyond.
+        struct timing_wheels {
+            std::array<item_list, wheel_size> near;
+            std::array<item_list, wheel_size> far;
+            item_list beyond;
+        };
+
+        item_list every_turn;
+        // Only allocated while there are items in them, most submaps have none.
+        cata::value_ptr<timing_wheels> wheels;
+        // The first turn whose items haven't been handed out yet.  All items in the
+        // wheels are due in it or later.
+        int next_turn = 0;
+        int wheel_items = 0;
+
         std::unordered_map<special_item_type, std::list<item_reference>> special_items;
-        std::unordered_map<int, std::unordered_map<item *, safe_reference<item>>> active_items_index;
+        std::unordered_map<item *, safe_reference<item>> active_items_index;
+
+        // Moves the item at it from the list from into the slot for its wake_turn.
+        void schedule( item_list &from, item_list::iterator it );
+        // Hands out the items due in next_turn (up to now) and moves on to the turn after it.
+        void advance( int now, std::vector<item_reference> &due );
+        // Hands out the items from list that are still valid, removing the others.
+        void take_valid( item_list &list, std::vector<item_reference> &out );
+        // Removes the cache entries of a destroyed item.
+        item_list::iterator erase( item_list &list, item_list::iterator it );
+
+        template<typename F>
+        void for_each_list( F f ) {
+            f( every_turn );
+            if( !wheels ) {
+                return;
+            }
+            for( item_list &list : wheels->near ) {
+                f( list );
+            }
+            for( item_list &list : wheels->far ) {
+                f( list );
+            }
+            f( wheels->beyond );
+        }
     public:
         /**
          * Adds the reference to the cache. Does nothing if the reference is already in the cache.
@@ -73,9 +134,12 @@ class active_item_cache
         std::vector<item_reference> get();
 
         /**
-         * Returns the first size() / processing_speed() elements of each list, rounded up.
-         * Items returned are rotated to the back of their respective lists, otherwise only the
-         * first n items will ever be processed.
+         * Returns the items due for processing at calendar::turn: all that process every
+         * turn, and once per turn those whose time has come since the last call.  These
+         * are rescheduled processing_speed() turns later.  After a long time without
+         * calls (the submap was out of the reality bubble), overdue items are moved to the
+         * first turn from now on that keeps their place in their interval, so they stay
+         * spread out instead of all coming due at once.
          * Broken references encountered when collecting the items to be processed are removed from
          * the cache.
          * Relies on the fact that item::processing_speed() is a constant.
@@ -1,10 +1,14 @@
 #include "cached_options.h"
 
 int fov_3d_z_range;
+bool hierarchical_pathfinding;
+bool horde_flow_fields;
 bool keycode_mode;
 bool log_from_top;
 int message_ttl;
 int message_cooldown;
+bool parallel_fields;
+bool parallel_map_cache;
 bool test_mode;
 int prevent_occlusion;
 bool prevent_occlusion_retract;
@@ -11,10 +11,14 @@
 // options.cpp).
 
 extern int fov_3d_z_range;
+extern bool hierarchical_pathfinding;
+extern bool horde_flow_fields;
 extern bool keycode_mode;
 extern bool log_from_top;
 extern int message_ttl;
 extern int message_cooldown;
+extern bool parallel_fields;
+extern bool parallel_map_cache;
 extern int prevent_occlusion;
 extern bool prevent_occlusion_retract;
 extern bool prevent_occlusion_transp;
@@ -54,6 +54,7 @@
 #include "overlay_ordering.h"
 #include "path_info.h"
 #include "pixel_minimap.h"
+#include "profiler.h"
 #include "rect_range.h"
 #include "scent_map.h"
 #include "sdl_utils.h"
@@ -334,6 +335,8 @@ void cata_tiles::load_tileset( const std::string &tileset_id, const bool prechec
     tileset_mutation_overlay_ordering.clear();
 
     tileset_ptr = cache.load_tileset( tileset_id, renderer, precheck, force, pump_events );
+    terrain_tiles.clear();
+    furniture_tiles.clear();
 
     set_draw_scale( 16 );
 
@@ -1259,6 +1262,7 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
     if( !g ) {
         return;
     }
+    CATA_PROFILE_ZONE( "cata_tiles::draw" );
 
 #if defined(__ANDROID__)
     // Attempted bugfix for Google Play crash - prevent divide-by-zero if no tile
@@ -2155,6 +2159,23 @@ bool cata_tiles::draw_from_id_string( const std::string &id, TILE_CATEGORY categ
             ll, -1, apply_night_vision_goggles, height_3d, intensity_level,
             variant, offset );
 }
+
+bool cata_tiles::draw_from_int_id( const ter_id &id, const tripoint &pos, int subtile, int rota,
+                                   lit_level ll, bool apply_night_vision_goggles, int &height_3d )
+{
+    return draw_from_id_string_internal( id.id().str(), TILE_CATEGORY::TERRAIN, empty_string, pos,
+                                         subtile, rota, ll, -1, apply_night_vision_goggles,
+                                         height_3d, 0, "", point(), &find_tile_looks_like( id ) );
+}
+
+bool cata_tiles::draw_from_int_id( const furn_id &id, const tripoint &pos, int subtile, int rota,
+                                   lit_level ll, bool apply_night_vision_goggles, int &height_3d )
+{
+    return draw_from_id_string_internal( id.id().str(), TILE_CATEGORY::FURNITURE, empty_string, pos,
+                                         subtile, rota, ll, -1, apply_night_vision_goggles,
+                                         height_3d, 0, "", point(), &find_tile_looks_like( id ) );
+}
+
 bool cata_tiles::draw_from_id_string_internal( const std::string &id, const tripoint &pos,
         int subtile,
         int rota,
@@ -2303,6 +2324,28 @@ cata_tiles::find_tile_looks_like( const std::string &id, TILE_CATEGORY category,
     }
 }
 
+const std::optional<tile_lookup_res> &cata_tiles::find_tile_looks_like( const ter_id &id )
+{
+    int_id_tile_lookup<ter_t>::entry &found = terrain_tiles.at(
+                season_of_year( calendar::turn ), id, get_all_ter_types() );
+    if( !found.resolved ) {
+        found.tile = find_tile_looks_like( id.id().str(), TILE_CATEGORY::TERRAIN, "" );
+        found.resolved = true;
+    }
+    return found.tile;
+}
+
+const std::optional<tile_lookup_res> &cata_tiles::find_tile_looks_like( const furn_id &id )
+{
+    int_id_tile_lookup<furn_t>::entry &found = furniture_tiles.at(
+                season_of_year( calendar::turn ), id, get_all_furn_types() );
+    if( !found.resolved ) {
+        found.tile = find_tile_looks_like( id.id().str(), TILE_CATEGORY::FURNITURE, "" );
+        found.resolved = true;
+    }
+    return found.tile;
+}
+
 bool cata_tiles::find_overlay_looks_like( const bool male, const std::string &overlay,
         const std::string &variant, std::string &draw_id )
 {
@@ -2374,7 +2417,7 @@ bool cata_tiles::draw_from_id_string_internal( const std::string &id, TILE_CATEG
         int subtile, int rota, lit_level ll, int retract,
         bool apply_night_vision_goggles, int &height_3d,
         int intensity_level, const std::string &variant,
-        const point &offset )
+        const point &offset, const std::optional<tile_lookup_res> *found )
 {
     bool nv_color_active = apply_night_vision_goggles && get_option<bool>( "NV_GREEN_TOGGLE" );
     // If the ID string does not produce a drawable tile
@@ -2423,7 +2466,7 @@ bool cata_tiles::draw_from_id_string_internal( const std::string &id, TILE_CATEG
     }
     // if a tile with intensity hasn't already been found then fall back to a base tile
     if( !res ) {
-        res = find_tile_looks_like( id, category, variant );
+        res = found != nullptr ? *found : find_tile_looks_like( id, category, variant );
         if( res ) {
             tt = &res -> tile();
         }
@@ -3177,8 +3220,8 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
         if( !neighborhood_overridden ) {
             return memorize_only
                    ? false
-                   : draw_from_id_string( tname, TILE_CATEGORY::TERRAIN, empty_string, p, subtile,
-                                          rotation, ll, nv_goggles_activated, height_3d );
+                   : draw_from_int_id( t, p, subtile, rotation, ll, nv_goggles_activated,
+                                       height_3d );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -3197,15 +3240,13 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
             } else {
                 get_terrain_orientation( p, rotation, subtile, terrain_override, invisible, rotate_group );
             }
-            const std::string &tname = t2.id().str();
             // tile overrides are never memorized
             // tile overrides are always shown with full visibility
             const lit_level lit = overridden ? lit_level::LIT : ll;
             const bool nv = overridden ? false : nv_goggles_activated;
             return memorize_only
                    ? false
-                   : draw_from_id_string( tname, TILE_CATEGORY::TERRAIN, empty_string, p, subtile,
-                                          rotation, lit, nv, height_3d );
+                   : draw_from_int_id( t2, p, subtile, rotation, lit, nv, height_3d );
         }
     } else if( invisible[0] ) {
         // try drawing memory if invisible and not overridden
@@ -3266,8 +3307,8 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
         if( !neighborhood_overridden ) {
             return memorize_only
                    ? false
-                   : draw_from_id_string( fname, TILE_CATEGORY::FURNITURE, empty_string, p, subtile,
-                                          rotation, ll, nv_goggles_activated, height_3d );
+                   : draw_from_int_id( f, p, subtile, rotation, ll, nv_goggles_activated,
+                                       height_3d );
         }
     }
     if( invisible[0] ? overridden : neighborhood_overridden ) {
@@ -3298,15 +3339,13 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
                 get_tile_values_with_ter( p, f.to_i(), neighborhood, subtile, rotation, rotate_group );
             }
             get_tile_values_with_ter( p, f2.to_i(), neighborhood, subtile, rotation, 0 );
-            const std::string &fname = f2.id().str();
             // tile overrides are never memorized
             // tile overrides are always shown with full visibility
             const lit_level lit = overridden ? lit_level::LIT : ll;
             const bool nv = overridden ? false : nv_goggles_activated;
             return memorize_only
                    ? false
-                   : draw_from_id_string( fname, TILE_CATEGORY::FURNITURE, empty_string, p, subtile,
-                                          rotation, lit, nv, height_3d );
+                   : draw_from_int_id( f2, p, subtile, rotation, lit, nv, height_3d );
         }
     } else if( invisible[0] ) {
         // try drawing memory if invisible and not overridden
@@ -3467,7 +3506,7 @@ bool cata_tiles::draw_field_or_item( const tripoint &p, const lit_level ll, int
     if( !fld_overridden ) {
         const maptile &tile = here.maptile_at( p );
 
-        for( const std::pair<const field_type_id, field_entry> &fd_pr : here.field_at( p ) ) {
+        for( const field::value_type &fd_pr : here.field_at( p ) ) {
             const field_type_id &fld = fd_pr.first;
             if( !invisible[0] && fld.obj().display_field ) {
                 const lit_level lit = ll;
@@ -3476,7 +3515,7 @@ bool cata_tiles::draw_field_or_item( const tripoint &p, const lit_level ll, int
                 auto has_field = [&]( field_type_id fld, const tripoint & q, const bool invis ) -> field_type_id {
                     // go through the fields and see if they are equal
                     field_type_id found = fd_null;
-                    for( std::pair<const field_type_id, field_entry> &this_fld : here.field_at( q ) )
+                    for( field::value_type &this_fld : here.field_at( q ) )
                     {
                         if( this_fld.first == fld ) {
                             found = fld;
@@ -3803,7 +3842,8 @@ bool cata_tiles::draw_vpart( const tripoint &p, lit_level ll, int &height_3d,
             avatar &you = get_avatar();
             if( !veh.forward_velocity() && !veh.player_in_control( you )
                 && !( you.get_grab_type() == object_type::VEHICLE
-                      && veh.get_points().count( you.pos() + you.grab_point ) )
+                      && std::binary_search( veh.get_points().begin(), veh.get_points().end(),
+                                             you.pos() + you.grab_point ) )
                 && here.memory_cache_dec_is_dirty( p ) ) {
                 you.memorize_decoration( here.getglobal( p ), vd.get_tileset_id(), subtile, rotation );
             }
@@ -2,9 +2,11 @@
 #ifndef CATA_SRC_CATA_TILES_H
 #define CATA_SRC_CATA_TILES_H
 
+#include <array>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -16,6 +18,7 @@
 #include "creature.h"
 #include "cuboid_rectangle.h"
 #include "enums.h"
+#include "generic_factory.h"
 #include "lightmap.h"
 #include "line.h"
 #include "map_memory.h"
@@ -111,6 +114,45 @@ class tile_lookup_res
         }
 };
 
+/**
+ * Remembers the tiles found for the plain ids of one type with an int_id (terrain or
+ * furniture), by season and index.  Drawing them then indexes an array instead of hashing
+ * the string id and following looks_like every frame.  Forgets everything when the types
+ * are reloaded, the owner must @ref clear it when the tileset changes.
+ */
+template<typename T>
+class int_id_tile_lookup
+{
+    public:
+        struct entry {
+            bool resolved = false;
+            std::optional<tile_lookup_res> tile;
+        };
+
+        entry &at( const season_type season, const int_id<T> &id, generic_factory<T> &types ) {
+            if( !types.is_valid( types_version ) ) {
+                clear();
+                types_version = types.get_version();
+            }
+            std::vector<entry> &by_id = entries[season];
+            const size_t index = static_cast<size_t>( id.to_i() );
+            if( index >= by_id.size() ) {
+                by_id.resize( index + 1 );
+            }
+            return by_id[index];
+        }
+
+        void clear() {
+            for( std::vector<entry> &by_id : entries ) {
+                by_id.clear();
+            }
+        }
+
+    private:
+        typename generic_factory<T>::Version types_version;
+        std::array<std::vector<entry>, NUM_SEASONS> entries;
+};
+
 class texture
 {
     private:
@@ -457,6 +499,9 @@ class cata_tiles
         std::optional<tile_lookup_res>
         find_tile_looks_like( const std::string &id, TILE_CATEGORY category, const std::string &variant,
                               int looks_like_jumps_limit = 10 ) const;
+        // find_tile_looks_like for the plain id, remembered in terrain_tiles / furniture_tiles.
+        const std::optional<tile_lookup_res> &find_tile_looks_like( const ter_id &id );
+        const std::optional<tile_lookup_res> &find_tile_looks_like( const furn_id &id );
 
         // this templated method is used only from it's own cpp file, so it's ok to declare it here
         template<typename T>
@@ -493,10 +538,17 @@ class cata_tiles
         bool draw_from_id_string_internal( const std::string &id, const tripoint &pos, int subtile,
                                            int rota,
                                            lit_level ll, int retract, bool apply_night_vision_goggles, int &height_3d );
+        // Draws the terrain / furniture like draw_from_id_string, without looking up its id.
+        bool draw_from_int_id( const ter_id &id, const tripoint &pos, int subtile, int rota,
+                               lit_level ll, bool apply_night_vision_goggles, int &height_3d );
+        bool draw_from_int_id( const furn_id &id, const tripoint &pos, int subtile, int rota,
+                               lit_level ll, bool apply_night_vision_goggles, int &height_3d );
+        // found is the result of find_tile_looks_like( id, category, variant ) if already known.
         bool draw_from_id_string_internal( const std::string &id, TILE_CATEGORY category,
                                            const std::string &subcategory, const tripoint &pos, int subtile, int rota,
                                            lit_level ll, int retract, bool apply_night_vision_goggles, int &height_3d, int intensity_level,
-                                           const std::string &variant, const point &offset );
+                                           const std::string &variant, const point &offset,
+                                           const std::optional<tile_lookup_res> *found = nullptr );
         bool draw_sprite_at(
             const tile_type &tile, const weighted_int_list<std::vector<int>> &svlist,
             const point &, unsigned int loc_rand, bool rota_fg, int rota, lit_level ll,
@@ -735,6 +787,8 @@ class cata_tiles
         const GeometryRenderer_Ptr &geometry;
         tileset_cache &cache;
         std::shared_ptr<const tileset> tileset_ptr;
+        int_id_tile_lookup<ter_t> terrain_tiles;
+        int_id_tile_lookup<furn_t> furniture_tiles;
 
         // the scaled default sprite width and height. in non-isometric mode,
         // the basic tile width and height equal the default sprite width and
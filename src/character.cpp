@@ -13,6 +13,7 @@
 #include <numeric>
 #include <tuple>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -8026,7 +8027,7 @@ bool Character::move_in_vehicle( Creature *c, const tripoint &dest_loc ) const
         vehicle &veh = vp_there->vehicle();
         units::volume capacity = 0_ml;
         units::volume free_cargo = 0_ml;
-        auto cargo_parts = veh.get_parts_at( dest_loc, "CARGO", part_status_flag::any );
+        auto cargo_parts = veh.get_parts_at( dest_loc, VPFLAG_CARGO, part_status_flag::any );
         for( vehicle_part *&part : cargo_parts ) {
             vehicle_stack contents = veh.get_items( *part );
             const optional_vpart_position vp = m.veh_at( dest_loc );
@@ -10496,10 +10497,26 @@ bool Character::is_visible_in_range( const Creature &critter, const int range )
 
 std::vector<Creature *> Character::get_visible_creatures( const int range ) const
 {
-    return g->get_creatures_if( [this, range]( const Creature & critter ) -> bool {
+    const auto visible = [this, range]( const Creature & critter ) -> bool {
         return this != &critter && pos() != critter.pos() && // TODO: get rid of fake npcs (pos() check)
         rl_dist( pos(), critter.pos() ) <= range && sees( critter );
-    } );
+    };
+    // Only monsters near us need to be checked, there can be a lot of them.
+    // Same order as @ref game::all_creatures (monsters in tracker order, then NPCs, then the
+    // avatar), callers show or cycle through the first entries.
+    std::vector<Creature *> result;
+    for( monster *critter : get_creature_tracker().monsters_in_radius( get_location(), range ) ) {
+        if( visible( *critter ) ) {
+            result.push_back( critter );
+        }
+    }
+    for( npc *guy : g->get_npcs_if( visible ) ) {
+        result.push_back( guy );
+    }
+    if( visible( get_avatar() ) ) {
+        result.push_back( &get_avatar() );
+    }
+    return result;
 }
 
 std::vector<Creature *> Character::get_targetable_creatures( const int range, bool melee ) const
@@ -11138,7 +11155,7 @@ void Character::process_effects()
         vehicle &veh = vp_there->vehicle();
         units::volume capacity = 0_ml;
         units::volume free_cargo = 0_ml;
-        auto cargo_parts = veh.get_parts_at( your_pos, "CARGO", part_status_flag::any );
+        auto cargo_parts = veh.get_parts_at( your_pos, VPFLAG_CARGO, part_status_flag::any );
         for( vehicle_part *&part : cargo_parts ) {
             vehicle_stack contents = veh.get_items( *part );
             const optional_vpart_position vp = here.veh_at( your_pos );
@@ -12833,6 +12850,8 @@ void Character::leak_items()
 
 void Character::process_items()
 {
+    // Everything carried shares one environment.
+    item_temperature_batch batch( pos(), get_map() );
     if( weapon.process( get_map(), this, pos() ) ) {
         weapon.spill_contents( pos() );
         remove_weapon();
@@ -1873,7 +1873,7 @@ conditional_t::func f_is_in_field( const JsonObject &jo, std::string_view member
     return [field_type, is_npc]( dialogue const & d ) {
         map &here = get_map();
         field_type_id ft = field_type_id( field_type.evaluate( d ) );
-        for( const std::pair<const field_type_id, field_entry> &f : here.field_at( d.actor(
+        for( const field::value_type &f : here.field_at( d.actor(
                     is_npc )->pos() ) ) {
             if( f.second.get_field_type() == ft ) {
                 return true;
@@ -1,6 +1,7 @@
 #include "creature_tracker.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <ostream>
 #include <string>
@@ -11,6 +12,7 @@
 #include "cata_assert.h"
 #include "debug.h"
 #include "flood_fill.h"
+#include "line.h"
 #include "game.h"
 #include "map.h"
 #include "mapdata.h"
@@ -97,7 +99,8 @@ bool creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.get_location()] = critter_ptr;
+    list_order[&critter] = next_list_order++;
+    set_location( critter.get_location(), critter_ptr );
     return true;
 }
 
@@ -132,8 +135,11 @@ bool creature_tracker::update_pos( const monster &critter, const tripoint_abs_ms
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( old_pos );
-        monsters_by_location[new_pos] = *iter;
+        const auto old_iter = monsters_by_location.find( old_pos );
+        if( old_iter != monsters_by_location.end() ) {
+            erase_location( old_iter );
+        }
+        set_location( new_pos, *iter );
         return true;
     } else {
         // We're changing the x/y/z coordinates of a zombie that hasn't been added
@@ -150,7 +156,7 @@ void creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.get_location() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( pos_iter );
         return;
     }
 
@@ -161,7 +167,130 @@ void creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( iter );
+    }
+}
+
+void creature_tracker::set_location( const tripoint_abs_ms &pos,
+                                     const shared_ptr_fast<monster> &critter )
+{
+    const auto iter = monsters_by_location.find( pos );
+    if( iter != monsters_by_location.end() ) {
+        erase_location( iter );
+    }
+    monsters_by_location.emplace( pos, critter );
+    monsters_by_submap[project_to<coords::sm>( pos )].push_back( critter.get() );
+}
+
+void creature_tracker::erase_location(
+    const std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>>::iterator iter )
+{
+    const auto bucket = monsters_by_submap.find( project_to<coords::sm>( iter->first ) );
+    if( bucket != monsters_by_submap.end() ) {
+        std::vector<monster *> &critters = bucket->second;
+        const auto critter = std::find( critters.begin(), critters.end(), iter->second.get() );
+        if( critter != critters.end() ) {
+            *critter = critters.back();
+            critters.pop_back();
+        }
+        if( critters.empty() ) {
+            monsters_by_submap.erase( bucket );
+        }
+    }
+    monsters_by_location.erase( iter );
+}
+
+void creature_tracker::clear_locations()
+{
+    monsters_by_location.clear();
+    monsters_by_submap.clear();
+}
+
+// Calls visit_fn for every monster in the grid whose submap overlaps the box from min to max.
+template<typename VisitFn>
+static void visit_submaps( const std::unordered_map<tripoint_abs_sm, std::vector<monster *>> &grid,
+                           const tripoint_abs_ms &min, const tripoint_abs_ms &max,
+                           VisitFn &&visit_fn )
+{
+    const tripoint_abs_sm min_sm = project_to<coords::sm>( min );
+    const tripoint_abs_sm max_sm = project_to<coords::sm>( max );
+    const tripoint size = max_sm.raw() - min_sm.raw() + tripoint( 1, 1, 1 );
+    if( size.x <= 0 || size.y <= 0 || size.z <= 0 ) {
+        return;
+    }
+    // A box larger than the number of occupied submaps is cheaper to check bucket by bucket.
+    if( static_cast<int64_t>( size.x ) * size.y * size.z > static_cast<int64_t>( grid.size() ) ) {
+        for( const std::pair<const tripoint_abs_sm, std::vector<monster *>> &bucket : grid ) {
+            const tripoint_abs_sm &sm = bucket.first;
+            if( sm.x() >= min_sm.x() && sm.x() <= max_sm.x() && sm.y() >= min_sm.y() &&
+                sm.y() <= max_sm.y() && sm.z() >= min_sm.z() && sm.z() <= max_sm.z() ) {
+                for( monster *critter : bucket.second ) {
+                    visit_fn( *critter );
+                }
+            }
+        }
+        return;
+    }
+    for( int z = min_sm.z(); z <= max_sm.z(); z++ ) {
+        for( int y = min_sm.y(); y <= max_sm.y(); y++ ) {
+            for( int x = min_sm.x(); x <= max_sm.x(); x++ ) {
+                const auto bucket = grid.find( tripoint_abs_sm( x, y, z ) );
+                if( bucket == grid.end() ) {
+                    continue;
+                }
+                for( monster *critter : bucket->second ) {
+                    visit_fn( *critter );
+                }
+            }
+        }
+    }
+}
+
+std::vector<monster *> creature_tracker::monsters_in_radius( const tripoint_abs_ms &center,
+        const int radius ) const
+{
+    std::vector<monster *> ret;
+    const tripoint offset( radius, radius, radius );
+    visit_submaps( monsters_by_submap, center - offset, center + offset, [&]( monster & critter ) {
+        if( !critter.is_dead() && rl_dist( center, critter.get_location() ) <= radius ) {
+            ret.push_back( &critter );
+        }
+    } );
+    sort_by_list_order( ret );
+    return ret;
+}
+
+std::vector<monster *> creature_tracker::monsters_in_rectangle( const tripoint_abs_ms &min,
+        const tripoint_abs_ms &max ) const
+{
+    std::vector<monster *> ret;
+    visit_submaps( monsters_by_submap, min, max, [&]( monster & critter ) {
+        const tripoint_abs_ms &pos = critter.get_location();
+        if( !critter.is_dead() && pos.x() >= min.x() && pos.x() <= max.x() &&
+            pos.y() >= min.y() && pos.y() <= max.y() && pos.z() >= min.z() && pos.z() <= max.z() ) {
+            ret.push_back( &critter );
+        }
+    } );
+    sort_by_list_order( ret );
+    return ret;
+}
+
+void creature_tracker::sort_by_list_order( std::vector<monster *> &critters ) const
+{
+    if( critters.size() < 2 ) {
+        return;
+    }
+    std::vector<std::pair<std::int64_t, monster *>> keyed;
+    keyed.reserve( critters.size() );
+    for( monster *critter : critters ) {
+        const auto iter = list_order.find( critter );
+        keyed.emplace_back( iter == list_order.end() ? next_list_order : iter->second, critter );
+    }
+    std::stable_sort( keyed.begin(), keyed.end(), []( const auto & lhs, const auto & rhs ) {
+        return lhs.first < rhs.first;
+    } );
+    for( size_t i = 0; i < keyed.size(); i++ ) {
+        critters[i] = keyed[i].second;
     }
 }
 
@@ -178,13 +307,15 @@ void creature_tracker::remove( const monster &critter )
 
     remove_from_location_map( critter );
     removed_this_turn_.emplace( *iter );
+    list_order.erase( &critter );
     monsters_list.erase( iter );
 }
 
 void creature_tracker::clear()
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    list_order.clear();
+    clear_locations();
     removed_this_turn_.clear();
     creatures_by_zone_and_faction_.clear();
     invalidate_reachability_cache();
@@ -192,9 +323,9 @@ void creature_tracker::clear()
 
 void creature_tracker::rebuild_cache()
 {
-    monsters_by_location.clear();
+    clear_locations();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->get_location()] = mon_ptr;
+        set_location( mon_ptr->get_location(), mon_ptr );
     }
 }
 
@@ -237,13 +368,13 @@ void creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_location( first_iter );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_location( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -253,10 +384,10 @@ void creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.get_location()] = first_ptr;
+        set_location( first.get_location(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.get_location()] = second_ptr;
+        set_location( second.get_location(), second_ptr );
     }
 }
 
@@ -291,6 +422,7 @@ void creature_tracker::remove_dead()
         monster *const critter = iter->get();
         if( critter->is_dead() ) {
             remove_from_location_map( *critter );
+            list_order.erase( critter );
             iter = monsters_list.erase( iter );
         } else {
             ++iter;
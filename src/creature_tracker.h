@@ -3,6 +3,7 @@
 #define CATA_SRC_CREATURE_TRACKER_H
 
 #include <cstddef>
+#include <cstdint>
 #include <list>
 #include <memory>
 #include <unordered_map>
@@ -129,6 +130,19 @@ class creature_tracker
             return monsters_list;
         }
 
+        /**
+         * Returns the living monsters within @p radius (as in @ref rl_dist) of @p center.
+         * Only the submaps around @p center are looked at, not every monster in the tracker.
+         * The result is in the order of @ref get_monsters_list. Monsters may be added, moved or
+         * removed while iterating over it, but those removed stay valid only until the end of
+         * the turn.
+         */
+        std::vector<monster *> monsters_in_radius( const tripoint_abs_ms &center,
+                int radius ) const;
+        /** Same as @ref monsters_in_radius, for the box from @p min to @p max (inclusive). */
+        std::vector<monster *> monsters_in_rectangle( const tripoint_abs_ms &min,
+                const tripoint_abs_ms &max ) const;
+
         void serialize( JsonOut &jsout ) const;
         void deserialize( const JsonArray &ja );
 
@@ -142,6 +156,16 @@ class creature_tracker
     private:
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        /**
+         * Sets the entry of @p pos in @ref monsters_by_location, replacing whatever was there,
+         * and keeps @ref monsters_by_submap in sync.
+         */
+        void set_location( const tripoint_abs_ms &pos, const shared_ptr_fast<monster> &critter );
+        void erase_location(
+            std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>>::iterator iter );
+        void clear_locations();
+        /** Sorts @p critters into the order of @ref monsters_list. */
+        void sort_by_list_order( std::vector<monster *> &critters ) const;
 
         void flood_fill_zone( const Creature &origin );
 
@@ -152,8 +176,22 @@ class creature_tracker
 
         std::list<shared_ptr_fast<npc>> active_npc; // NOLINT(cata-serialize)
         std::vector<shared_ptr_fast<monster>> monsters_list;
+        /**
+         * For each monster in @ref monsters_list, a number that grows with its position there.
+         * Monsters are only ever appended to or erased from that list, so the numbers handed
+         * out on @ref add keep their order.
+         */
+        // NOLINTNEXTLINE(cata-serialize)
+        std::unordered_map<const monster *, std::int64_t> list_order;
+        std::int64_t next_list_order = 0; // NOLINT(cata-serialize)
         // NOLINTNEXTLINE(cata-serialize)
         std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>> monsters_by_location;
+        /**
+         * The same monsters as @ref monsters_by_location, bucketed by the submap of their key
+         * there, for @ref monsters_in_radius and @ref monsters_in_rectangle.
+         */
+        // NOLINTNEXTLINE(cata-serialize)
+        std::unordered_map<tripoint_abs_sm, std::vector<monster *>> monsters_by_submap;
 
         /**
          * Creatures that get removed via @ref remove are stored here until the end of the turn.
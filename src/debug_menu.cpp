@@ -72,11 +72,13 @@
 #include "item_location.h"
 #include "itype.h"
 #include "json.h"
+#include "latency_histogram.h"
 #include "localized_comparator.h"
 #include "magic.h"
 #include "map.h"
 #include "map_extras.h"
 #include "map_iterator.h"
+#include "mapbuffer.h"
 #include "mapgen.h"
 #include "mapgendata.h"
 #include "martialarts.h"
@@ -100,6 +102,7 @@
 #include "pimpl.h"
 #include "point.h"
 #include "popup.h"
+#include "profiler.h"
 #include "recipe_dictionary.h"
 #include "relic.h"
 #include "requirements.h"
@@ -263,6 +266,8 @@ std::string enum_to_string<debug_menu::debug_menu_index>( debug_menu::debug_menu
 		case debug_menu::debug_menu_index::SIX_MILLION_DOLLAR_SURVIVOR: return "SIX_MILLION_DOLLAR_SURVIVOR";
 		case debug_menu::debug_menu_index::EDIT_FACTION: return "EDIT_FACTION";
 		case debug_menu::debug_menu_index::WRITE_CITY_LIST: return "WRITE_CITY_LIST";
+		case debug_menu::debug_menu_index::REWRITE_MAP_SAVES: return "REWRITE_MAP_SAVES";
+		case debug_menu::debug_menu_index::TURN_PROFILER: return "TURN_PROFILER";
         // *INDENT-ON*
         case debug_menu::debug_menu_index::last:
             break;
@@ -512,6 +517,7 @@ static int info_uilist( bool display_all_entries = true )
             { uilist_entry( debug_menu_index::TEST_MAP_EXTRA_DISTRIBUTION, true, 'e', _( "Test map extra list" ) ) },
             { uilist_entry( debug_menu_index::GENERATE_EFFECT_LIST, true, 'L', _( "Generate effect list" ) ) },
             { uilist_entry( debug_menu_index::WRITE_CITY_LIST, true, 'C', _( "Write city list to cities.output" ) ) },
+            { uilist_entry( debug_menu_index::TURN_PROFILER, true, 'P', profiler::is_recording() ? _( "Stop profiling turns and write turn_profile.json" ) : _( "Start profiling turns" ) ) },
         };
         uilist_initializer.insert( uilist_initializer.begin(), debug_only_options.begin(),
                                    debug_only_options.end() );
@@ -530,6 +536,7 @@ static int game_uilist()
         { uilist_entry( debug_menu_index::ACTIVATE_EOC, true, 'E', _( "Activate EOC" ) ) },
         { uilist_entry( debug_menu_index::QUIT_NOSAVE, true, 'Q', _( "Quit to main menu" ) )  },
         { uilist_entry( debug_menu_index::QUICKLOAD, true, 'q', _( "Quickload" ) )  },
+        { uilist_entry( debug_menu_index::REWRITE_MAP_SAVES, true, 'm', _( "Rewrite saved map in the world's save format" ) )  },
     };
 
     return uilist( _( "Game…" ), uilist_initializer );
@@ -2664,6 +2671,10 @@ static void debug_menu_game_state()
         }
     }
 
+    s += _( "\nSubmap load latency:\n" );
+    // Has no '%' in it, s is used as a format string below.
+    s += map::loadn_latency().to_string();
+
     popup_top(
         s.c_str(),
         player_character.posx(), player_character.posy(), abs_sub.x(), abs_sub.y(),
@@ -2873,6 +2884,7 @@ void debug()
         debug_menu_index::SHOW_MSG,
         debug_menu_index::QUICKLOAD,
         debug_menu_index::QUIT_NOSAVE,
+        debug_menu_index::REWRITE_MAP_SAVES,
         debug_menu_index::EXPORT_FOLLOWER,
         debug_menu_index::EXPORT_SELF
     };
@@ -3493,6 +3505,13 @@ void debug()
                 g->quickload();
             }
             break;
+        case debug_menu_index::REWRITE_MAP_SAVES: {
+            const int rewritten = MAPBUFFER.rewrite_saved_quads();
+            const bool binary = get_option<bool>( "BINARY_SUBMAPS" );
+            popup( string_format( _( "%d saved map quads rewritten in the %s format." ), rewritten,
+                                  binary ? _( "binary" ) : _( "JSON" ) ) );
+        }
+        break;
         case debug_menu_index::TEST_WEATHER: {
             get_weather().get_cur_weather_gen().test_weather( g->get_seed() );
         }
@@ -3762,6 +3781,22 @@ void debug()
             faction_edit_menu();
             break;
 
+        case debug_menu_index::TURN_PROFILER: {
+#if defined( CATA_NO_PROFILER )
+            popup( _( "This build has no turn profiler." ) );
+#else
+            if( !profiler::is_recording() ) {
+                profiler::start();
+                popup( _( "Recording where the time of each turn goes "
+                          "until this is used again." ) );
+                break;
+            }
+            profiler::stop();
+            write_to_file( "turn_profile.json", profiler::write_trace, _( "turn profile" ) );
+            popup( profiler::report() );
+#endif
+        }
+        break;
         case debug_menu_index::WRITE_CITY_LIST: {
             write_to_file( "cities.output", [&]( std::ostream & testfile ) {
                 overmap &cur_om = g->get_cur_om();
@@ -105,6 +105,8 @@ enum class debug_menu_index : int {
     SIX_MILLION_DOLLAR_SURVIVOR,
     EDIT_FACTION,
     WRITE_CITY_LIST,
+    REWRITE_MAP_SAVES,
+    TURN_PROFILER,
     last
 };
 
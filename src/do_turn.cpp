@@ -57,6 +57,7 @@
 #include "player_activity.h"
 #include "point.h"
 #include "popup.h"
+#include "profiler.h"
 #include "rng.h"
 #include "scent_map.h"
 #include "sdlsound.h"
@@ -262,6 +263,7 @@ namespace
 {
 void monmove()
 {
+    CATA_PROFILE_ZONE( "monmove" );
     g->cleanup_dead();
     map &m = get_map();
     avatar &u = get_avatar();
@@ -388,6 +390,7 @@ void monmove()
 
 void overmap_npc_move()
 {
+    CATA_PROFILE_ZONE( "overmap_npc_move" );
     avatar &u = get_avatar();
     std::vector<npc *> travelling_npcs;
     static constexpr int move_search_radius = 600;
@@ -435,14 +438,10 @@ void overmap_npc_move()
 
 } // namespace
 
-// MAIN GAME LOOP
-// Returns true if game is over (death, saved, quit, etc)
-bool do_turn()
+namespace turn_handler
+{
+void start_turn()
 {
-    if( g->is_game_over() ) {
-        return turn_handler::cleanup_at_end();
-    }
-
     weather_manager &weather = get_weather();
     // Actual stuff
     if( g->new_game ) {
@@ -456,7 +455,9 @@ bool do_turn()
             weather.set_nextweather( calendar::turn );
         }
     } else {
-        g->gamemode->per_turn();
+        if( g->gamemode ) {
+            g->gamemode->per_turn();
+        }
         calendar::turn += 1_turns;
     }
 
@@ -527,6 +528,118 @@ bool do_turn()
     g->reset_light_level();
 
     g->perhaps_add_random_npc( /* ignore_spawn_timers_and_rates = */ false );
+}
+
+void process_world()
+{
+    avatar &u = get_avatar();
+    map &m = get_map();
+    weather_manager &weather = get_weather();
+
+    scent_map &scent = get_scent();
+    // No-scent debug mutation has to be processed here or else it takes time to start working
+    if( !u.has_flag( STATIC( json_character_flag( "NO_SCENT" ) ) ) ) {
+        scent.set( u.pos(), u.scent, u.get_type_of_scent() );
+        overmap_buffer.set_scent( u.global_omt_location(),  u.scent );
+    }
+    scent.update( u.pos(), m );
+
+    // We need floor cache before checking falling 'n stuff
+    m.build_floor_caches();
+
+    m.process_falling();
+    m.vehmove();
+    m.process_fields();
+    m.process_items();
+    explosion_handler::process_explosions();
+    m.creature_in_field( u );
+
+    // Apply sounds from previous turn to monster and NPC AI.
+    sounds::process_sounds();
+    const int levz = m.get_abs_sub().z();
+    // Update vision caches for monsters. If this turns out to be expensive,
+    // consider a stripped down cache just for monsters.
+    m.build_map_cache( levz, true );
+    monmove();
+    if( calendar::once_every( 5_minutes ) ) {
+        overmap_npc_move();
+    }
+    if( calendar::once_every( 10_seconds ) ) {
+        for( const tripoint &elem : m.get_furn_field_locations() ) {
+            const furn_t &furn = *m.furn( elem );
+            for( const emit_id &e : furn.emissions ) {
+                m.emit_field( elem, e );
+            }
+        }
+        for( const tripoint &elem : m.get_ter_field_locations() ) {
+            const ter_t &ter = *m.ter( elem );
+            for( const emit_id &e : ter.emissions ) {
+                m.emit_field( elem, e );
+            }
+        }
+    }
+    g->mon_info_update();
+    u.process_turn();
+
+    if( levz >= 0 && !u.is_underwater() ) {
+        handle_weather_effects( weather.weather_id );
+    }
+}
+
+void end_turn()
+{
+    avatar &u = get_avatar();
+    map &m = get_map();
+    weather_manager &weather = get_weather();
+
+    m.invalidate_visibility_cache();
+
+    u.update_bodytemp();
+    u.update_body_wetness( *weather.weather_precise );
+    u.apply_wetness_morale( weather.temperature );
+
+    if( calendar::once_every( 1_minutes ) ) {
+        u.update_morale();
+        for( npc &guy : g->all_npcs() ) {
+            guy.update_morale();
+            guy.check_and_recover_morale();
+        }
+    }
+
+    if( calendar::once_every( 9_turns ) ) {
+        u.check_and_recover_morale();
+    }
+
+    if( !u.is_deaf() ) {
+        sfx::remove_hearing_loss();
+    }
+    sfx::do_danger_music();
+    sfx::do_vehicle_engine_sfx();
+    sfx::do_vehicle_exterior_engine_sfx();
+    sfx::do_sleepiness();
+
+    // reset player noise
+    u.volume = 0;
+
+    // Calculate bionic power balance
+    u.power_balance = u.get_power_level() - u.power_prev_turn;
+    u.power_prev_turn = u.get_power_level();
+}
+} // namespace turn_handler
+
+// MAIN GAME LOOP
+// Returns true if game is over (death, saved, quit, etc)
+bool do_turn()
+{
+    CATA_PROFILE_ZONE( "do_turn" );
+    if( g->is_game_over() ) {
+        return turn_handler::cleanup_at_end();
+    }
+
+    turn_handler::start_turn();
+
+    avatar &u = get_avatar();
+    map &m = get_map();
     while( u.get_moves() > 0 && u.activity ) {
         u.activity.do_turn( u );
     }
@@ -629,59 +742,12 @@ bool do_turn()
         g->calc_driving_offset( veh );
     }
 
-    scent_map &scent = get_scent();
-    // No-scent debug mutation has to be processed here or else it takes time to start working
-    if( !u.has_flag( STATIC( json_character_flag( "NO_SCENT" ) ) ) ) {
-        scent.set( u.pos(), u.scent, u.get_type_of_scent() );
-        overmap_buffer.set_scent( u.global_omt_location(),  u.scent );
-    }
-    scent.update( u.pos(), m );
-
-    // We need floor cache before checking falling 'n stuff
-    m.build_floor_caches();
-
-    m.process_falling();
-    m.vehmove();
-    m.process_fields();
-    m.process_items();
-    explosion_handler::process_explosions();
-    m.creature_in_field( u );
-
-    // Apply sounds from previous turn to monster and NPC AI.
-    sounds::process_sounds();
-    const int levz = m.get_abs_sub().z();
-    // Update vision caches for monsters. If this turns out to be expensive,
-    // consider a stripped down cache just for monsters.
-    m.build_map_cache( levz, true );
-    monmove();
-    if( calendar::once_every( 5_minutes ) ) {
-        overmap_npc_move();
-    }
-    if( calendar::once_every( 10_seconds ) ) {
-        for( const tripoint &elem : m.get_furn_field_locations() ) {
-            const furn_t &furn = *m.furn( elem );
-            for( const emit_id &e : furn.emissions ) {
-                m.emit_field( elem, e );
-            }
-        }
-        for( const tripoint &elem : m.get_ter_field_locations() ) {
-            const ter_t &ter = *m.ter( elem );
-            for( const emit_id &e : ter.emissions ) {
-                m.emit_field( elem, e );
-            }
-        }
-    }
-    g->mon_info_update();
-    u.process_turn();
+    turn_handler::process_world();
     if( u.get_moves() < 0 && get_option<bool>( "FORCE_REDRAW" ) ) {
         ui_manager::redraw();
         refresh_display();
     }
 
-    if( levz >= 0 && !u.is_underwater() ) {
-        handle_weather_effects( weather.weather_id );
-    }
-
     const bool player_is_sleeping = u.has_effect( effect_sleep );
     bool wait_redraw = false;
     std::string wait_message;
@@ -725,38 +791,7 @@ bool do_turn()
         g->first_redraw_since_waiting_started = true;
     }
 
-    m.invalidate_visibility_cache();
-
-    u.update_bodytemp();
-    u.update_body_wetness( *weather.weather_precise );
-    u.apply_wetness_morale( weather.temperature );
-
-    if( calendar::once_every( 1_minutes ) ) {
-        u.update_morale();
-        for( npc &guy : g->all_npcs() ) {
-            guy.update_morale();
-            guy.check_and_recover_morale();
-        }
-    }
-
-    if( calendar::once_every( 9_turns ) ) {
-        u.check_and_recover_morale();
-    }
-
-    if( !u.is_deaf() ) {
-        sfx::remove_hearing_loss();
-    }
-    sfx::do_danger_music();
-    sfx::do_vehicle_engine_sfx();
-    sfx::do_vehicle_exterior_engine_sfx();
-    sfx::do_sleepiness();
-
-    // reset player noise
-    u.volume = 0;
-
-    // Calculate bionic power balance
-    u.power_balance = u.get_power_level() - u.power_prev_turn;
-    u.power_prev_turn = u.get_power_level();
+    turn_handler::end_turn();
 
 #if defined(EMSCRIPTEN)
     // This will cause a prompt to be shown if the window is closed, until the
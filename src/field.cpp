@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <list>
+#include <memory>
 #include <random>
 #include <utility>
 
@@ -114,6 +116,44 @@ field::field()
 {
 }
 
+field::field( const field &other )
+    : inline_entries( other.inline_entries ),
+      overflow( other.overflow ? std::make_unique<std::list<value_type>>( *other.overflow ) :
+                nullptr ),
+      _displayed_field_type( other._displayed_field_type )
+{
+}
+
+field &field::operator=( const field &other )
+{
+    if( this != &other ) {
+        *this = field( other );
+    }
+    return *this;
+}
+
+field::value_type *field::find_entry( const field_type_id &type )
+{
+    for( value_type &entry : inline_entries ) {
+        if( entry.first == type ) {
+            return &entry;
+        }
+    }
+    if( overflow ) {
+        for( value_type &entry : *overflow ) {
+            if( entry.first == type ) {
+                return &entry;
+            }
+        }
+    }
+    return nullptr;
+}
+
+const field::value_type *field::find_entry( const field_type_id &type ) const
+{
+    return const_cast<field *>( this )->find_entry( type );
+}
+
 /*
 Function: find_field
 Returns a field entry corresponding to the field_type_id parameter passed in. If no fields are found then returns NULL.
@@ -121,12 +161,12 @@ Good for checking for existence of a field: if(myfield.find_field(fd_fire)) woul
 */
 field_entry *field::find_field( const field_type_id &field_type_to_find, const bool alive_only )
 {
-    if( !_displayed_field_type ) {
+    if( !_displayed_field_type || !field_type_to_find ) {
         return nullptr;
     }
-    const auto it = _field_type_list->find( field_type_to_find );
-    if( it != _field_type_list->end() && ( !alive_only || it->second.is_field_alive() ) ) {
-        return &it->second;
+    value_type *const entry = find_entry( field_type_to_find );
+    if( entry && ( !alive_only || entry->second.is_field_alive() ) ) {
+        return &entry->second;
     }
     return nullptr;
 }
@@ -134,14 +174,7 @@ field_entry *field::find_field( const field_type_id &field_type_to_find, const b
 const field_entry *field::find_field( const field_type_id &field_type_to_find,
                                       const bool alive_only ) const
 {
-    if( !_displayed_field_type ) {
-        return nullptr;
-    }
-    const auto it = _field_type_list->find( field_type_to_find );
-    if( it != _field_type_list->end() && ( !alive_only || it->second.is_field_alive() ) ) {
-        return &it->second;
-    }
-    return nullptr;
+    return const_cast<field *>( this )->find_field( field_type_to_find, alive_only );
 }
 
 /*
@@ -159,40 +192,59 @@ bool field::add_field( const field_type_id &field_type_to_add, const int new_int
     if( !field_type_to_add ) {
         return false;
     }
-    auto it = _field_type_list->find( field_type_to_add );
-    if( it != _field_type_list->end() ) {
+    if( value_type *const entry = find_entry( field_type_to_add ) ) {
         //Already exists, but lets update it. This is tentative.
-        int prev_intensity = it->second.get_field_intensity();
-        if( !it->second.is_field_alive() ) {
-            it->second.set_field_age( new_age );
+        int prev_intensity = entry->second.get_field_intensity();
+        if( !entry->second.is_field_alive() ) {
+            entry->second.set_field_age( new_age );
             prev_intensity = 0;
         }
-        it->second.set_field_intensity( prev_intensity + new_intensity );
+        entry->second.set_field_intensity( prev_intensity + new_intensity );
         return false;
     }
     if( !_displayed_field_type ||
         field_type_to_add.obj().priority >= _displayed_field_type.obj().priority ) {
         _displayed_field_type = field_type_to_add;
     }
-    _field_type_list[field_type_to_add] = field_entry( field_type_to_add, new_intensity, new_age );
+    value_type added( field_type_to_add, field_entry( field_type_to_add, new_intensity, new_age ) );
+    // An empty slot has a null type, the one type that is never added.
+    if( value_type *const empty = find_entry( field_type_id() ) ) {
+        *empty = std::move( added );
+        return true;
+    }
+    if( !overflow ) {
+        overflow = std::make_unique<std::list<value_type>>();
+    }
+    overflow->push_back( std::move( added ) );
     return true;
 }
 
 bool field::remove_field( const field_type_id &field_to_remove )
 {
-    const auto it = _field_type_list->find( field_to_remove );
-    if( it == _field_type_list->end() ) {
+    if( !field_to_remove ) {
         return false;
     }
-    remove_field( it );
-    return true;
+    for( iterator it = begin(); it != end(); ++it ) {
+        if( it->first == field_to_remove ) {
+            remove_field( it );
+            return true;
+        }
+    }
+    return false;
 }
 
-void field::remove_field( std::map<field_type_id, field_entry>::iterator const it )
+void field::remove_field( const iterator it )
 {
-    _field_type_list->erase( it );
+    if( it.pos < inline_capacity ) {
+        inline_entries[it.pos] = value_type();
+    } else {
+        overflow->erase( it.spilled );
+        if( overflow->empty() ) {
+            overflow.reset();
+        }
+    }
     _displayed_field_type = fd_null;
-    for( auto &fld : *_field_type_list ) {
+    for( const value_type &fld : *this ) {
         if( !_displayed_field_type || fld.first.obj().priority >= _displayed_field_type.obj().priority ) {
             _displayed_field_type = fld.first;
         }
@@ -201,7 +253,8 @@ void field::remove_field( std::map<field_type_id, field_entry>::iterator const i
 
 void field::clear()
 {
-    _field_type_list->clear();
+    inline_entries = {};
+    overflow.reset();
     _displayed_field_type = fd_null;
 }
 
@@ -211,27 +264,33 @@ Returns the number of fields existing on the current tile.
 */
 unsigned int field::field_count() const
 {
-    return _field_type_list->size();
+    unsigned int count = overflow ? overflow->size() : 0;
+    for( const value_type &entry : inline_entries ) {
+        if( entry.first ) {
+            count++;
+        }
+    }
+    return count;
 }
 
-std::map<field_type_id, field_entry>::iterator field::begin()
+field::iterator field::begin()
 {
-    return _field_type_list->begin();
+    return iterator( this, 0 );
 }
 
-std::map<field_type_id, field_entry>::const_iterator field::begin() const
+field::const_iterator field::begin() const
 {
-    return _field_type_list->begin();
+    return const_iterator( this, 0 );
 }
 
-std::map<field_type_id, field_entry>::iterator field::end()
+field::iterator field::end()
 {
-    return _field_type_list->end();
+    return iterator();
 }
 
-std::map<field_type_id, field_entry>::const_iterator field::end() const
+field::const_iterator field::end() const
 {
-    return _field_type_list->end();
+    return const_iterator();
 }
 
 /*
@@ -250,14 +309,13 @@ description_affix field::displayed_description_affix() const
 
 int field::displayed_intensity() const
 {
-    auto it = _field_type_list->find( _displayed_field_type );
-    return it->second.get_field_intensity();
+    return find_entry( _displayed_field_type )->second.get_field_intensity();
 }
 
 int field::total_move_cost() const
 {
     int current_cost = 0;
-    for( const auto &fld : *_field_type_list ) {
+    for( const value_type &fld : *this ) {
         current_cost += fld.second.get_intensity_level().move_cost;
     }
     return current_cost;
@@ -2,12 +2,17 @@
 #ifndef CATA_SRC_FIELD_H
 #define CATA_SRC_FIELD_H
 
-#include <map>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "calendar.h"
-#include "cata_lazy.h"
 #include "color.h"
 #include "enums.h"
 #include "field_type.h"
@@ -102,11 +107,105 @@ class field_entry
  * Use @ref find_field to get the field entry of a specific type, or iterate over
  * all entries via @ref begin and @ref end (allows range based iteration).
  * There is @ref displayed_field_type to specific which field should be drawn on the map.
+ *
+ * Almost all tiles have no more than a couple of fields, so the first
+ * @ref inline_capacity entries are stored in the field itself and only further
+ * ones are allocated.  Like with a std::map, adding or removing entries does not
+ * move the other entries, so references and iterators to them stay valid, which
+ * field processing relies on.  Entries are iterated in no particular order.
 */
 class field
 {
     public:
+        using value_type = std::pair<field_type_id, field_entry>;
+        static constexpr int inline_capacity = 2;
+
+    private:
+        template<typename Field, typename Value>
+        class basic_iterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::remove_const_t<Value>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = Value *;
+                using reference = Value &;
+
+                basic_iterator() = default;
+
+                Value &operator*() const {
+                    return pos < inline_capacity ? owner->inline_entries[pos] : *spilled;
+                }
+                Value *operator->() const {
+                    return &**this;
+                }
+
+                basic_iterator &operator++() {
+                    if( pos < inline_capacity ) {
+                        pos++;
+                        skip_empty();
+                    } else if( ++spilled == owner->overflow->end() ) {
+                        pos = end_pos;
+                    }
+                    return *this;
+                }
+                basic_iterator operator++( int ) {
+                    basic_iterator ret = *this;
+                    ++*this;
+                    return ret;
+                }
+
+                bool operator==( const basic_iterator &rhs ) const {
+                    return pos == rhs.pos && ( pos != inline_capacity || spilled == rhs.spilled );
+                }
+                bool operator!=( const basic_iterator &rhs ) const {
+                    return !( *this == rhs );
+                }
+
+            private:
+                friend class field;
+                using list_iterator = std::conditional_t<std::is_const_v<Value>,
+                      typename std::list<value_type>::const_iterator,
+                      typename std::list<value_type>::iterator>;
+                // Past the inline slots and the overflow list.
+                static constexpr int end_pos = inline_capacity + 1;
+
+                basic_iterator( Field *owner, const int pos ) : owner( owner ), pos( pos ) {
+                    skip_empty();
+                }
+
+                // Moves on from an unused inline slot to the next used slot, or to
+                // the first overflow entry, or to the end.
+                void skip_empty() {
+                    while( pos < inline_capacity && !owner->inline_entries[pos].first ) {
+                        pos++;
+                    }
+                    if( pos == inline_capacity ) {
+                        if( owner->overflow && !owner->overflow->empty() ) {
+                            spilled = owner->overflow->begin();
+                        } else {
+                            pos = end_pos;
+                        }
+                    }
+                }
+
+                Field *owner = nullptr;
+                // Index of the inline slot, or inline_capacity for an entry of the
+                // overflow list, or end_pos.
+                int pos = end_pos;
+                list_iterator spilled;
+        };
+
+    public:
+        using iterator = basic_iterator<field, value_type>;
+        using const_iterator = basic_iterator<const field, const value_type>;
+
         field();
+        field( const field &other );
+        field( field && ) noexcept = default;
+        field &operator=( const field &other );
+        field &operator=( field && ) noexcept = default;
+        ~field() = default;
 
         /**
          * Returns a field entry corresponding to the field_type_id parameter passed in.
@@ -141,9 +240,10 @@ class field
         bool remove_field( const field_type_id &field_to_remove );
         /**
          * Make sure to decrement the field counter in the submap.
-         * Removes the field entry, the iterator must point into @ref _field_type_list and must be valid.
+         * Removes the field entry, the iterator must point into this field and must be valid.
+         * Only iterators to the removed entry are invalidated.
          */
-        void remove_field( std::map<field_type_id, field_entry>::iterator );
+        void remove_field( iterator );
 
         /**
          * Removes all fields.
@@ -166,13 +266,13 @@ class field
 
         description_affix displayed_description_affix() const;
 
-        //Returns the vector iterator to begin searching through the list.
-        std::map<field_type_id, field_entry>::iterator begin();
-        std::map<field_type_id, field_entry>::const_iterator begin() const;
+        //Returns the iterator to begin searching through the list.
+        iterator begin();
+        const_iterator begin() const;
 
-        //Returns the vector iterator to end searching through the list.
-        std::map<field_type_id, field_entry>::iterator end();
-        std::map<field_type_id, field_entry>::const_iterator end() const;
+        //Returns the iterator to end searching through the list.
+        iterator end();
+        const_iterator end() const;
 
         /**
          * Returns the total move cost from all fields.
@@ -180,8 +280,13 @@ class field
         int total_move_cost() const;
 
     private:
-        // A pointer lookup table of all field effects on the current tile.
-        lazy<std::map<field_type_id, field_entry>> _field_type_list;
+        value_type *find_entry( const field_type_id &type );
+        const value_type *find_entry( const field_type_id &type ) const;
+
+        // The first field effects on the current tile.  Unused slots have a null type.
+        std::array<value_type, inline_capacity> inline_entries;
+        // Any further field effects, only allocated when needed.
+        std::unique_ptr<std::list<value_type>> overflow;
         //_displayed_field_type currently is equal to the last field added to the square. You can modify this behavior in the class functions if you wish.
         field_type_id _displayed_field_type;
 };
@@ -4508,7 +4508,7 @@ Creature *game::is_hostile_within( int distance, bool dangerous )
 field_entry *game::is_in_dangerous_field()
 {
     map &here = get_map();
-    for( std::pair<const field_type_id, field_entry> &field : here.field_at( u.pos() ) ) {
+    for( field::value_type &field : here.field_at( u.pos() ) ) {
         if( u.is_dangerous_field( field.second ) ) {
             return &field.second;
         }
@@ -10372,7 +10372,7 @@ std::vector<std::string> game::get_dangerous_tile( const tripoint &dest_loc ) co
     const bool veh_here_inside = veh_here && veh_here->is_inside();
     const bool veh_dest_inside = veh_dest && veh_dest->is_inside();
 
-    for( const std::pair<const field_type_id, field_entry> &e : m.field_at( dest_loc ) ) {
+    for( const field::value_type &e : m.field_at( dest_loc ) ) {
         if( !u.is_dangerous_field( e.second ) ) {
             continue;
         }
@@ -12634,9 +12634,32 @@ point game::update_map( int &x, int &y, bool z_level_changed )
     // Update what parts of the world map we can see
     update_overmap_seen();
 
+    prefetch_submaps_ahead( shift );
+
     return shift;
 }
 
+void game::prefetch_submaps_ahead( const point &shift )
+{
+    // Without better information, assume we keep going the same way.
+    point heading( clamp( shift.x, -1, 1 ), clamp( shift.y, -1, 1 ) );
+    int distance = 1;
+    if( const optional_vpart_position vp = m.veh_at( u.pos() ) ) {
+        const vehicle &veh = vp->vehicle();
+        if( veh.velocity != 0 ) {
+            // Look one more submap ahead for every 20 mph.
+            const rl_vec2d dir = veh.dir_vec() * ( veh.velocity > 0 ? 1.0f : -1.0f );
+            constexpr float diagonal = 0.38f; // sin(22.5 degrees)
+            heading = point( dir.x > diagonal ? 1 : dir.x < -diagonal ? -1 : 0,
+                             dir.y > diagonal ? 1 : dir.y < -diagonal ? -1 : 0 );
+            distance = clamp( std::abs( veh.velocity ) / 2000 + 1, 1, 3 );
+        }
+    }
+    if( heading != point_zero ) {
+        m.prefetch_submaps( heading, distance );
+    }
+}
+
 void game::update_overmap_seen()
 {
     const tripoint_abs_omt ompos = u.global_omt_location();
@@ -134,6 +134,12 @@ bool is_valid_in_w_terrain( const point &p );
 namespace turn_handler
 {
 bool cleanup_at_end();
+/** Starts a new turn: advances the clock, processes events, hordes and the weather. */
+void start_turn();
+/** Everything that happens after the avatar acted: fields, items, vehicles, monsters. */
+void process_world();
+/** Updates the avatar's body temperature, wetness and morale at the end of the turn. */
+void end_turn();
 } // namespace turn_handler
 
 // There is only one game instance, so losing a few bytes of memory
@@ -161,6 +167,7 @@ class game
         friend memorial_logger &get_memorial();
         friend bool do_turn();
         friend bool turn_handler::cleanup_at_end();
+        friend void turn_handler::start_turn();
         friend global_variables &get_globals();
     public:
         game();
@@ -603,6 +610,8 @@ class game
         // Helper to make calling with a player pointer less verbose.
         point update_map( Character &p, bool z_level_changed = false );
         point update_map( int &x, int &y, bool z_level_changed = false );
+        // Reads the submaps we are heading towards from disk in the background.
+        void prefetch_submaps_ahead( const point &shift );
         void update_overmap_seen(); // Update which overmap tiles we can see
 
         void peek();
@@ -12622,6 +12622,64 @@ void item::apply_freezerburn()
     set_flag( flag_MUSHY );
 }
 
+static item_temperature_batch *innermost_temperature_batch = nullptr;
+
+item_temperature_batch::item_temperature_batch( const tripoint &pos, map &here )
+    : pos( pos ), here( here ), outer( innermost_temperature_batch )
+{
+    innermost_temperature_batch = this;
+}
+
+item_temperature_batch::~item_temperature_batch()
+{
+    innermost_temperature_batch = outer;
+}
+
+item_temperature_batch *item_temperature_batch::find( const tripoint &pos, const map &here )
+{
+    for( item_temperature_batch *batch = innermost_temperature_batch; batch != nullptr;
+         batch = batch->outer ) {
+        if( batch->pos == pos && &batch->here == &here ) {
+            return batch;
+        }
+    }
+    return nullptr;
+}
+
+units::temperature item_temperature_batch::current_temperature()
+{
+    if( !current ) {
+        current = get_weather().get_temperature( pos );
+    }
+    return *current;
+}
+
+units::temperature_delta item_temperature_batch::temperature_modifier()
+{
+    if( !modifier ) {
+        // Toilets and vending machines will try to get the heat radiation and convection during mapgen and segfault.
+        if( !g->new_game ) {
+            modifier = get_heat_radiation( pos ) + get_convection_temperature( pos ) +
+                       here.get_temperature_mod( pos );
+        } else {
+            modifier = units::from_kelvin_delta( 0 );
+        }
+    }
+    return *modifier;
+}
+
+units::temperature item_temperature_batch::weather_temperature( const time_point &t )
+{
+    const auto found = weather.find( to_turn<int>( t ) );
+    if( found != weather.end() ) {
+        return found->second;
+    }
+    const units::temperature temp = get_weather().get_cur_weather_gen().get_weather_temperature(
+                                        pos, t, g->get_seed() );
+    weather.emplace( to_turn<int>( t ), temp );
+    return temp;
+}
+
 bool item::process_temperature_rot( float insulation, const tripoint &pos, map &here,
                                     Character *carrier, const temperature_flag flag, float spoil_modifier )
 {
@@ -12641,7 +12699,12 @@ bool item::process_temperature_rot( float insulation, const tripoint &pos, map &
         return false;
     }
 
-    units::temperature temp = get_weather().get_temperature( pos );
+    std::optional<item_temperature_batch> own_batch;
+    item_temperature_batch *batch = item_temperature_batch::find( pos, here );
+    if( batch == nullptr ) {
+        batch = &own_batch.emplace( pos, here );
+    }
+    units::temperature temp = batch->current_temperature();
 
     switch( flag ) {
         case temperature_flag::NORMAL:
@@ -12677,18 +12740,7 @@ bool item::process_temperature_rot( float insulation, const tripoint &pos, map &
     if( now - time > 1_hours ) {
         // This code is for items that were left out of reality bubble for long time
 
-        const weather_generator &wgen = get_weather().get_cur_weather_gen();
-        const unsigned int seed = g->get_seed();
-
-        units::temperature_delta temp_mod;
-        // Toilets and vending machines will try to get the heat radiation and convection during mapgen and segfault.
-        if( !g->new_game ) {
-            temp_mod = get_heat_radiation( pos );
-            temp_mod += get_convection_temperature( pos );
-            temp_mod += here.get_temperature_mod( pos );
-        } else {
-            temp_mod = units::from_kelvin_delta( 0 );
-        }
+        units::temperature_delta temp_mod = batch->temperature_modifier();
 
         if( carried ) {
             temp_mod += units::from_fahrenheit_delta( 5 ); // body heat increases inventory temperature
@@ -12704,7 +12756,7 @@ bool item::process_temperature_rot( float insulation, const tripoint &pos, map &
             // Use weather if above ground, use map temp if below
             units::temperature env_temperature;
             if( pos.z >= 0 && flag != temperature_flag::ROOT_CELLAR ) {
-                env_temperature = wgen.get_weather_temperature( pos, time, seed );
+                env_temperature = batch->weather_temperature( time );
             } else {
                 env_temperature = AVERAGE_ANNUAL_TEMPERATURE;
             }
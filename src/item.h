@@ -13,6 +13,7 @@
 #include <optional>
 #include <set>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,6 +29,7 @@
 #include "item_location.h"
 #include "item_tname.h"
 #include "material.h"
+#include "point.h"
 #include "requirements.h"
 #include "safe_reference.h"
 #include "type_id.h"
@@ -64,7 +66,6 @@ template<typename CompType>
 struct comp_selection;
 struct tool_comp;
 struct mtype;
-struct tripoint;
 template<typename T>
 class ret_val;
 template <typename T> struct enum_traits;
@@ -192,6 +193,45 @@ struct stacking_info {
     }
 };
 
+/**
+ * Environment for processing the temperature and rot of a group of items at one
+ * location in one pass, like all comestibles on a tile or in a container.  While an
+ * instance is alive, item::process_temperature_rot at its location takes the
+ * environment from it: the current temperature, the heat from nearby fires and
+ * fields, and the weather of each hour the items spent outside the reality bubble
+ * are then looked up once for the whole group rather than once per item.
+ * Instances nest, the innermost one for a location is used.
+ */
+class item_temperature_batch
+{
+    public:
+        item_temperature_batch( const tripoint &pos, map &here );
+        ~item_temperature_batch();
+        item_temperature_batch( const item_temperature_batch & ) = delete;
+        item_temperature_batch &operator=( const item_temperature_batch & ) = delete;
+
+        // The innermost live batch for pos on here, or nullptr.
+        static item_temperature_batch *find( const tripoint &pos, const map &here );
+
+        const tripoint &location() const {
+            return pos;
+        }
+        units::temperature current_temperature();
+        // Heat radiation, convection and the map's modifier at the location.
+        units::temperature_delta temperature_modifier();
+        // The weather generator's temperature at the location at time t.
+        units::temperature weather_temperature( const time_point &t );
+
+    private:
+        tripoint pos;
+        map &here;
+        item_temperature_batch *outer;
+        std::optional<units::temperature> current;
+        std::optional<units::temperature_delta> modifier;
+        // Keyed by turn.  Items checked at the same time share all their samples.
+        std::unordered_map<int, units::temperature> weather;
+};
+
 class item : public visitable
 {
     public:
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iterator>
 #include <map>
+#include <optional>
 #include <string>
 #include <type_traits>
 
@@ -2471,6 +2472,11 @@ void item_contents::remove_internal( const std::function<bool( item & )> &filter
 void item_contents::process( map &here, Character *carrier, const tripoint &pos, float insulation,
                              temperature_flag flag, float spoil_multiplier_parent )
 {
+    // All contents, including those of nested containers, share one environment.
+    std::optional<item_temperature_batch> batch;
+    if( item_temperature_batch::find( pos, here ) == nullptr ) {
+        batch.emplace( pos, here );
+    }
     for( item_pocket &pocket : contents ) {
         if( pocket.is_type( pocket_type::CONTAINER ) ) {
             pocket.process( here, carrier, pos, insulation, flag, spoil_multiplier_parent );
@@ -0,0 +1,78 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "string_formatter.h"
+
+static std::string format_duration( const latency_histogram::duration d )
+{
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>( d ).count();
+    if( us < 1000 ) {
+        return string_format( "%d us", us );
+    } else if( us < 1000000 ) {
+        return string_format( "%.1f ms", us / 1000.0 );
+    }
+    return string_format( "%.2f s", us / 1000000.0 );
+}
+
+static latency_histogram::duration bucket_limit( const int bucket )
+{
+    return std::chrono::microseconds( int64_t( 1 ) << bucket );
+}
+
+void latency_histogram::record( const duration d )
+{
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>( d ).count();
+    int bucket = 0;
+    while( bucket < num_buckets - 1 && ( int64_t( 1 ) << bucket ) <= us ) {
+        bucket++;
+    }
+    buckets[bucket]++;
+    total++;
+    total_time += d;
+    max_sample = std::max( max_sample, d );
+}
+
+void latency_histogram::clear()
+{
+    *this = latency_histogram();
+}
+
+latency_histogram::duration latency_histogram::percentile( const double fraction ) const
+{
+    if( total == 0 ) {
+        return duration::zero();
+    }
+    const int rank = std::clamp( static_cast<int>( fraction * total ), 0, total - 1 );
+    int seen = 0;
+    for( int bucket = 0; bucket < num_buckets - 1; bucket++ ) {
+        seen += buckets[bucket];
+        if( seen > rank ) {
+            return bucket_limit( bucket );
+        }
+    }
+    return max_sample;
+}
+
+std::string latency_histogram::to_string() const
+{
+    if( total == 0 ) {
+        return "no samples\n";
+    }
+    std::string ret = string_format( "%d samples, mean %s, p50 %s, p90 %s, p99 %s, max %s\n",
+                                     total, format_duration( total_time / total ),
+                                     format_duration( percentile( 0.5 ) ),
+                                     format_duration( percentile( 0.9 ) ),
+                                     format_duration( percentile( 0.99 ) ),
+                                     format_duration( max_sample ) );
+    for( int bucket = 0; bucket < num_buckets; bucket++ ) {
+        if( buckets[bucket] == 0 ) {
+            continue;
+        }
+        const std::string limit = bucket == num_buckets - 1 ? "more" : "< " + format_duration(
+                                      bucket_limit( bucket ) );
+        ret += string_format( "%10s: %d\n", limit, buckets[bucket] );
+    }
+    return ret;
+}
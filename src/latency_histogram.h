@@ -0,0 +1,49 @@
+#pragma once
+#ifndef CATA_SRC_LATENCY_HISTOGRAM_H
+#define CATA_SRC_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <string>
+
+/**
+ * Distribution of how long some operation takes, in buckets of powers of two
+ * microseconds.  Recording is cheap enough to time every call of a function
+ * that runs many times per turn.
+ */
+class latency_histogram
+{
+    public:
+        using duration = std::chrono::steady_clock::duration;
+
+        // Bucket i counts samples shorter than 2^i microseconds (and not shorter
+        // than 2^(i-1)).  The last bucket also takes everything longer.
+        static constexpr int num_buckets = 24;
+
+        void record( duration d );
+        void clear();
+
+        int count() const {
+            return total;
+        }
+        duration longest() const {
+            return max_sample;
+        }
+        int bucket_count( int bucket ) const {
+            return buckets[bucket];
+        }
+        // Upper bound of the bucket that contains the sample at the given
+        // fraction (0 to 1) of all samples, sorted by duration.
+        duration percentile( double fraction ) const;
+
+        // Summary followed by one line per non-empty bucket.
+        std::string to_string() const;
+
+    private:
+        std::array<int, num_buckets> buckets = {};
+        int total = 0;
+        duration total_time = duration::zero();
+        duration max_sample = duration::zero();
+};
+
+#endif // CATA_SRC_LATENCY_HISTOGRAM_H
@@ -10,6 +10,8 @@ level_cache::level_cache()
     floor_cache_dirty = false;
     constexpr four_quadrants four_zeros( 0.0f );
     std::fill_n( &lm[0][0], map_dimensions, four_zeros );
+    std::fill_n( &lm_dynamic[0][0], map_dimensions, four_zeros );
+    std::fill_n( &light_casts_transparency[0][0], map_dimensions, 0.0f );
     std::fill_n( &sm[0][0], map_dimensions, 0.0f );
     std::fill_n( &light_source_buffer[0][0], map_dimensions, 0.0f );
     std::fill_n( &outside_cache[0][0], map_dimensions, false );
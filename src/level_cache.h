@@ -5,17 +5,62 @@
 #include <array>
 #include <bitset>
 #include <set>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "coordinates.h"
 #include "game_constants.h"
 #include "lightmap.h"
 #include "point.h"
 #include "shadowcasting.h"
+#include "units.h"
 #include "value_ptr.h"
 
 class vehicle;
 
+// One light-casting operation recorded by map::generate_lightmap.  Casts that
+// compare equal cast exactly the same light, as long as the transparency within
+// reach() of them hasn't changed.
+struct light_source_cast {
+    enum class shape : int {
+        circle,
+        // Half circle facing direction (0, 90, 180 or 270 degrees)
+        directional,
+        arc
+    };
+    // Octant pairs cast by a circle, cleared where a brighter buffered source
+    // next to it already covers that side.
+    static constexpr int north = 1;
+    static constexpr int east = 2;
+    static constexpr int south = 4;
+    static constexpr int west = 8;
+
+    shape type = shape::circle;
+    tripoint p;
+    float luminance = 0.0f;
+    // circle: mask of the directions above; directional: angle in degrees
+    int direction = 0;
+    units::angle angle = 0_degrees;
+    units::angle width = 0_degrees;
+
+    // Furthest (chebyshev) distance from p that this can light up.
+    int reach() const;
+    // Accumulates this light into lm, using max() like all light sources do.
+    void cast( cata::mdarray<four_quadrants, point_bub_ms> &lm,
+               const cata::mdarray<float, point_bub_ms> &transparency_cache ) const;
+
+    bool operator==( const light_source_cast &rhs ) const {
+        return std::tie( type, p, luminance, direction, angle, width ) ==
+               std::tie( rhs.type, rhs.p, rhs.luminance, rhs.direction, rhs.angle, rhs.width );
+    }
+    bool operator<( const light_source_cast &rhs ) const {
+        return std::tie( type, p, luminance, direction, angle, width ) <
+               std::tie( rhs.type, rhs.p, rhs.luminance, rhs.direction, rhs.angle, rhs.width );
+    }
+};
+
 struct level_cache {
     public:
         // Zeros all relevant values
@@ -35,6 +80,16 @@ struct level_cache {
         // This is only valid for the duration of generate_lightmap
         cata::mdarray<float, point_bub_ms> light_source_buffer;
 
+        // Light cast by this level's light sources, without sunlight.  It's kept
+        // between turns so that generate_lightmap only has to recast the submaps
+        // around light sources or transparency that changed.
+        cata::mdarray<four_quadrants, point_bub_ms> lm_dynamic;
+        // The light casts (sorted) that lm_dynamic holds, the transparency they were
+        // cast through and the map position it was cast at.
+        std::vector<light_source_cast> light_casts;
+        cata::mdarray<float, point_bub_ms> light_casts_transparency;
+        point_abs_sm light_casts_origin;
+
         // Cache of natural light level is useful if it needs to be in sync with the light cache.
         float natural_light_level_cache;
 
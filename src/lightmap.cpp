@@ -1,6 +1,7 @@
 #include "lightmap.h" // IWYU pragma: associated
 #include "shadowcasting.h" // IWYU pragma: associated
 
+#include <algorithm>
 #include <bitset>
 #include <cmath>
 #include <cstdlib>
@@ -9,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -227,7 +229,7 @@ bool map::build_vision_transparency_cache( const int zlev )
     return dirty;
 }
 
-void map::apply_character_light( Character &p )
+float map::apply_character_light( Character &p )
 {
     if( p.has_effect( effect_onfire ) ) {
         apply_light_source( p.pos(), 8 );
@@ -239,10 +241,7 @@ void map::apply_character_light( Character &p )
     if( held_luminance > LIGHT_AMBIENT_LOW ) {
         apply_light_source( p.pos(), held_luminance );
     }
-
-    if( held_luminance >= 4 && held_luminance > ambient_light_at( p.pos() ) - 0.5f ) {
-        p.add_effect( effect_haslight, 1_turns );
-    }
+    return held_luminance;
 }
 
 // This function raytraces starting at the upper limit of the simulated area descending
@@ -420,9 +419,12 @@ void map::generate_lightmap( const int zlev )
 
     build_sunlight_cache( zlev );
 
-    apply_character_light( get_player_character() );
+    pending_light_casts.clear();
+    std::vector<std::pair<Character *, float>> held_lights;
+    held_lights.emplace_back( &get_player_character(),
+                              apply_character_light( get_player_character() ) );
     for( npc &guy : g->all_npcs() ) {
-        apply_character_light( guy );
+        held_lights.emplace_back( &guy, apply_character_light( guy ) );
     }
 
     std::vector<std::pair<tripoint, float>> lm_override;
@@ -598,9 +600,144 @@ void map::generate_lightmap( const int zlev )
             apply_light_source( p, light_source_buffer[p.x][p.y] );
         }
     }
+
+    // Sources on this level go through the persistent lm_dynamic so unchanged
+    // ones don't have to be recast. Stray ones on other levels are cast
+    // directly, they get overwritten when that level's lightmap is built.
+    for( const light_source_cast &e : pending_light_casts ) {
+        if( e.type == light_source_cast::shape::circle && inbounds( e.p ) ) {
+            cata::mdarray<float, point_bub_ms> &e_sm = get_cache( e.p.z ).sm;
+            e_sm[e.p.x][e.p.y] = std::max( e_sm[e.p.x][e.p.y], e.luminance );
+        }
+        if( e.p.z != zlev && inbounds_z( e.p.z ) ) {
+            level_cache &e_cache = get_cache( e.p.z );
+            e.cast( e_cache.lm, e_cache.transparency_cache );
+        }
+    }
+    pending_light_casts.erase( std::remove_if( pending_light_casts.begin(),
+    pending_light_casts.end(), [zlev]( const light_source_cast & e ) {
+        return e.p.z != zlev;
+    } ), pending_light_casts.end() );
+    update_dynamic_lightmap( zlev, pending_light_casts );
+
+    const auto &lm_dynamic = map_cache.lm_dynamic;
+    for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+        for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+            lm[x][y] = elementwise_max( lm[x][y], lm_dynamic[x][y] );
+        }
+    }
     for( const std::pair<tripoint, float> &elem : lm_override ) {
         lm[elem.first.x][elem.first.y].fill( elem.second );
     }
+
+    // Only now that all light is in place can we tell whether a character's
+    // light stands out from their surroundings.
+    for( const std::pair<Character *, float> &held : held_lights ) {
+        if( held.second >= 4 && held.second > ambient_light_at( held.first->pos() ) - 0.5f ) {
+            held.first->add_effect( effect_haslight, 1_turns );
+        }
+    }
+}
+
+// Marks the submaps within reach of an emission.
+static void mark_emission_submaps( std::bitset<MAPSIZE *MAPSIZE> &submaps, const light_source_cast &e )
+{
+    const int reach = e.reach();
+    const point min_sm( std::max( e.p.x - reach, 0 ) / SEEX, std::max( e.p.y - reach, 0 ) / SEEY );
+    const point max_sm( std::min( e.p.x + reach, LIGHTMAP_CACHE_X - 1 ) / SEEX,
+                        std::min( e.p.y + reach, LIGHTMAP_CACHE_Y - 1 ) / SEEY );
+    for( int smx = min_sm.x; smx <= max_sm.x; ++smx ) {
+        for( int smy = min_sm.y; smy <= max_sm.y; ++smy ) {
+            submaps.set( smx * MAPSIZE + smy );
+        }
+    }
+}
+
+static bool emission_touches_submaps( const std::bitset<MAPSIZE *MAPSIZE> &submaps,
+                                      const light_source_cast &e )
+{
+    if( submaps.none() ) {
+        return false;
+    }
+    std::bitset<MAPSIZE *MAPSIZE> touched;
+    mark_emission_submaps( touched, e );
+    return ( touched & submaps ).any();
+}
+
+void map::update_dynamic_lightmap( const int zlev, std::vector<light_source_cast> &emissions )
+{
+    level_cache &map_cache = get_cache( zlev );
+    auto &lm_dynamic = map_cache.lm_dynamic;
+    auto &old_emissions = map_cache.light_casts;
+    auto &old_transparency = map_cache.light_casts_transparency;
+    const auto &transparency_cache = map_cache.transparency_cache;
+
+    // lm_dynamic always holds exactly the light of old_emissions cast through
+    // old_transparency; everything below keeps that true.
+    if( map_cache.light_casts_origin != abs_sub.xy() ) {
+        // The map shifted, nothing cached lines up anymore.
+        lm_dynamic.fill( four_quadrants( 0.0f ) );
+        old_emissions.clear();
+        map_cache.light_casts_origin = abs_sub.xy();
+    }
+
+    std::bitset<MAPSIZE *MAPSIZE> transparency_changed;
+    for( int smx = 0; smx < MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < MAPSIZE; ++smy ) {
+            for( int sx = 0; sx < SEEX && !transparency_changed[smx * MAPSIZE + smy]; ++sx ) {
+                const int x = smx * SEEX + sx;
+                if( !std::equal( &transparency_cache[x][smy * SEEY], &transparency_cache[x][smy * SEEY] + SEEY,
+                                 &old_transparency[x][smy * SEEY] ) ) {
+                    transparency_changed.set( smx * MAPSIZE + smy );
+                }
+            }
+        }
+    }
+
+    // Tiles that may have lost or gained light: everything within reach of an
+    // emission that appeared, disappeared, or shines through changed transparency.
+    std::bitset<MAPSIZE *MAPSIZE> dirty = transparency_changed;
+    std::sort( emissions.begin(), emissions.end() );
+    auto old_it = old_emissions.begin();
+    auto new_it = emissions.begin();
+    while( old_it != old_emissions.end() || new_it != emissions.end() ) {
+        if( new_it == emissions.end() || ( old_it != old_emissions.end() && *old_it < *new_it ) ) {
+            mark_emission_submaps( dirty, *old_it++ );
+        } else if( old_it == old_emissions.end() || *new_it < *old_it ) {
+            mark_emission_submaps( dirty, *new_it++ );
+        } else {
+            if( emission_touches_submaps( transparency_changed, *new_it ) ) {
+                mark_emission_submaps( dirty, *new_it );
+            }
+            ++old_it;
+            ++new_it;
+        }
+    }
+
+    if( dirty.any() ) {
+        for( int smx = 0; smx < MAPSIZE; ++smx ) {
+            for( int smy = 0; smy < MAPSIZE; ++smy ) {
+                if( !dirty[smx * MAPSIZE + smy] ) {
+                    continue;
+                }
+                for( int sx = 0; sx < SEEX; ++sx ) {
+                    std::fill_n( &lm_dynamic[smx * SEEX + sx][smy * SEEY], SEEY, four_quadrants( 0.0f ) );
+                }
+            }
+        }
+        // Light only ever combines through max(), so recasting an unchanged
+        // emission leaves the clean tiles it reaches as they were.
+        for( const light_source_cast &e : emissions ) {
+            if( emission_touches_submaps( dirty, e ) ) {
+                e.cast( lm_dynamic, transparency_cache );
+            }
+        }
+    }
+    if( transparency_changed.any() ) {
+        old_transparency = transparency_cache;
+    }
+    // Hand the old vector back as scratch space, so neither gets reallocated.
+    old_emissions.swap( emissions );
 }
 
 void map::add_light_source( const tripoint &p, float luminance )
@@ -829,6 +966,144 @@ void castLight( cata::mdarray<Out, point_bub_ms> &output_cache,
                 int row = 1, float start = 1.0f, float end = 0.0f,
                 T cumulative_transparency = T( LIGHT_TRANSPARENCY_OPEN_AIR ) );
 
+// Length of the run of cells equal to value, starting at first and moving by step.
+template<typename T>
+static int count_equal_run( const cata::mdarray<T, point_bub_ms> &input_array,
+                            const point &first, const point &step, const int count, const T &value )
+{
+    if constexpr( std::is_same_v<T, float> ) {
+        if( step.x == 0 ) {
+            return shadowcasting_rows::count_equal( &input_array[first.x][first.y], step.y, count,
+                                                    value );
+        }
+    }
+    int i = 0;
+    while( i < count && input_array[first.x + i * step.x][first.y + i * step.y] == value ) {
+        i++;
+    }
+    return i;
+}
+
+template<typename T, typename Out, void( *update_output )( Out &, const T &, quadrant )>
+static void update_output_run( cata::mdarray<Out, point_bub_ms> &output_cache,
+                               const point &first, const point &step, const int count,
+                               const T &value, const quadrant quad )
+{
+    if constexpr( std::is_same_v<T, float> && std::is_same_v<Out, float> ) {
+        if( step.x == 0 && update_output == update_light ) {
+            shadowcasting_rows::max_fill( &output_cache[first.x][first.y], step.y, count, value );
+            return;
+        }
+    }
+    for( int i = 0; i < count; i++ ) {
+        update_output( output_cache[first.x + i * step.x][first.y + i * step.y], value, quad );
+    }
+}
+
+// Row kernel for castLight: does exactly what the per-cell loop in castLight does
+// for one row, but a run of equally transparent cells at a time.  Returns false
+// if the span was used up and castLight should return.
+template<int xx, int xy, int yx, int yy, typename T, typename Out,
+         T( *calc )( const T &, const T &, const int & ),
+         bool( *check )( const T &, const T & ),
+         void( *update_output )( Out &, const T &, quadrant ),
+         T( *accumulate )( const T &, const T &, const int & )>
+static bool castLight_row( cata::mdarray<Out, point_bub_ms> &output_cache,
+                           const cata::mdarray<T, point_bub_ms> &input_array,
+                           const point &offset, const int offsetDistance, const T numerator,
+                           const int distance, const int first_dx, float &start, const float end,
+                           const T &cumulative_transparency, float &newStart,
+                           T &current_transparency, T &last_intensity, bool &started_row )
+{
+    constexpr quadrant quad = quadrant_from_x_y( -xx - xy, -yx - yy );
+    const int dy = -distance;
+    const point row_base( offset.x + dy * xy, offset.y + dy * yy );
+    const point step( xx, yx );
+    const auto trailing_edge = [dy]( const int dx ) {
+        return ( dx - 0.5f ) / ( dy + 0.5f );
+    };
+    const auto leading_edge = [dy]( const int dx ) {
+        return ( dx + 0.5f ) / ( dy - 0.5f );
+    };
+    const auto dist_at = [dy, offsetDistance]( const int dx ) {
+        return rl_dist( tripoint_zero, tripoint( dx, dy, 0 ) ) + offsetDistance;
+    };
+
+    // Cells outside the map are skipped, and the cells that end before the end slope
+    // form a prefix of the rest since trailing edges shrink along the row.
+    int first = first_dx;
+    int in_map_last = 0;
+    shadowcasting_rows::clamp_to_map( row_base.x, xx, MAPSIZE_X, first, in_map_last );
+    shadowcasting_rows::clamp_to_map( row_base.y, yx, MAPSIZE_Y, first, in_map_last );
+    const int estimate = static_cast<int>( std::floor( end * ( dy + 0.5f ) + 0.5f ) );
+    int last = std::max( first - 1, std::min( in_map_last, estimate ) );
+    while( last < in_map_last && !( end > trailing_edge( last + 1 ) ) ) {
+        last++;
+    }
+    while( last >= first && end > trailing_edge( last ) ) {
+        last--;
+    }
+
+    for( int dx = first; dx <= last; ) {
+        const point current = row_base + step * dx;
+        const T new_transparency = input_array[current.x][current.y];
+        if( !started_row ) {
+            started_row = true;
+            current_transparency = new_transparency;
+        }
+
+        if( new_transparency == current_transparency ) {
+            const int run = count_equal_run( input_array, current, step, last - dx + 1,
+                                             current_transparency );
+            // Intensity only depends on the distance, which is constant along the row
+            // unless distances are circular.
+            for( int i = 0; i < run; ) {
+                const int dist = dist_at( dx + i );
+                int same_dist = run - i;
+                if( trigdist ) {
+                    same_dist = 1;
+                    while( i + same_dist < run && dist_at( dx + i + same_dist ) == dist ) {
+                        same_dist++;
+                    }
+                }
+                last_intensity = calc( numerator, cumulative_transparency, dist );
+                update_output_run<T, Out, update_output>(
+                    output_cache, current + step * i, step, same_dist, last_intensity,
+                    check( current_transparency, last_intensity ) ? quadrant::default_ : quad );
+                i += same_dist;
+            }
+            dx += run;
+            newStart = leading_edge( dx - 1 );
+            continue;
+        }
+
+        // A change in transparency, handled just like in castLight.
+        last_intensity = calc( numerator, cumulative_transparency, dist_at( dx ) );
+        if( check( new_transparency, last_intensity ) ) {
+            update_output( output_cache[current.x][current.y], last_intensity, quadrant::default_ );
+        } else {
+            update_output( output_cache[current.x][current.y], last_intensity, quad );
+        }
+        const float trailingEdge = trailing_edge( dx );
+        if( check( current_transparency, last_intensity ) ) {
+            castLight<xx, xy, yx, yy, T, Out, calc, check, update_output, accumulate>(
+                output_cache, input_array, offset, offsetDistance,
+                numerator, distance + 1, start, trailingEdge,
+                accumulate( cumulative_transparency, current_transparency, distance ) );
+            start = trailingEdge;
+        } else {
+            start = newStart;
+        }
+        if( start < end ) {
+            return false;
+        }
+        current_transparency = new_transparency;
+        newStart = leading_edge( dx );
+        dx++;
+    }
+    return true;
+}
+
 template<int xx, int xy, int yx, int yy, typename T, typename Out,
          T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
@@ -845,6 +1120,7 @@ void castLight( cata::mdarray<Out, point_bub_ms> &output_cache,
     if( start < end ) {
         return;
     }
+    const bool use_row_kernel = get_shadowcasting_kernel() != shadowcasting_kernel::per_cell;
     T last_intensity( 0.0 );
     tripoint delta;
     for( int distance = row; distance <= radius; distance++ ) {
@@ -857,7 +1133,15 @@ void castLight( cata::mdarray<Out, point_bub_ms> &output_cache,
         //We initialize delta.x to -distance adjusted so that the commented start < leadingEdge condition below is never false
         delta.x = -distance + std::max( static_cast<int>( std::ceil( away * ( -distance - 0.5f ) ) ), 0 );
 
-        for( ; delta.x <= 0; delta.x++ ) {
+        if( use_row_kernel &&
+            !castLight_row<xx, xy, yx, yy, T, Out, calc, check, update_output, accumulate>(
+                output_cache, input_array, offset, offsetDistance, numerator, distance, delta.x,
+                start, end, cumulative_transparency, newStart, current_transparency, last_intensity,
+                started_row ) ) {
+            return;
+        }
+        // The per-cell walk, unless the row kernel has already handled this row.
+        for( ; !use_row_kernel && delta.x <= 0; delta.x++ ) {
             point current( offset.x + delta.x * xx + delta.y * xy, offset.y + delta.x * yx + delta.y * yy );
             float trailingEdge = ( delta.x - 0.5f ) / ( delta.y + 0.5f );
             float leadingEdge = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
@@ -1151,22 +1435,16 @@ static bool light_check( const float &transparency, const float &intensity )
     return transparency > LIGHT_TRANSPARENCY_SOLID && intensity > LIGHT_AMBIENT_LOW;
 }
 
-void map::apply_light_source( const tripoint &p, float luminance )
+static void cast_light_circle( cata::mdarray<four_quadrants, point_bub_ms> &lm,
+                               const cata::mdarray<float, point_bub_ms> &transparency_cache,
+                               const light_source_cast &e )
 {
-    level_cache &cache = get_cache( p.z );
-    cata::mdarray<four_quadrants, point_bub_ms> &lm = cache.lm;
-    cata::mdarray<float, point_bub_ms> &sm = cache.sm;
-    cata::mdarray<float, point_bub_ms> &transparency_cache =
-        cache.transparency_cache;
-    cata::mdarray<float, point_bub_ms> &light_source_buffer =
-        cache.light_source_buffer;
-
-    const point p2( p.xy() );
+    const point p2( e.p.xy() );
+    float luminance = e.luminance;
 
-    if( inbounds( p ) ) {
+    if( lightmap_boundaries.contains( p2 ) ) {
         const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
         lm[p2.x][p2.y] = elementwise_max( lm[p2.x][p2.y], min_light );
-        sm[p2.x][p2.y] = std::max( sm[p2.x][p2.y], luminance );
     }
     if( luminance <= lit_level::LOW ) {
         return;
@@ -1174,29 +1452,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
         luminance = 1.49f;
     }
 
-    /* If we're a 5 luminance fire , we skip casting rays into ey && sx if we have
-         neighboring fires to the north and west that were applied via light_source_buffer
-       If there's a 1 luminance candle east in buffer, we still cast rays into ex since it's smaller
-       If there's a 100 luminance magnesium flare south added via apply_light_source instead od
-         add_light_source, it's unbuffered so we'll still cast rays into sy.
-
-          ey
-        nnnNnnn
-        w     e
-        w  5 +e
-     sx W 5*1+E ex
-        w ++++e
-        w+++++e
-        sssSsss
-           sy
-    */
-    const int peer_inbounds = LIGHTMAP_CACHE_X - 1;
-    bool north = p2.y != 0 && light_source_buffer[p2.x][p2.y - 1] < luminance;
-    bool south = p2.y != peer_inbounds && light_source_buffer[p2.x][p2.y + 1] < luminance;
-    bool east = p2.x != peer_inbounds && light_source_buffer[p2.x + 1][p2.y] < luminance;
-    bool west = p2.x != 0 && light_source_buffer[p2.x - 1][p2.y] < luminance;
-
-    if( north ) {
+    if( e.direction & light_source_cast::north ) {
         castLight < 1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
                       lm, transparency_cache, p2, 0, luminance );
@@ -1205,7 +1461,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                       lm, transparency_cache, p2, 0, luminance );
     }
 
-    if( east ) {
+    if( e.direction & light_source_cast::east ) {
         castLight < 0, -1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
                       lm, transparency_cache, p2, 0, luminance );
@@ -1214,7 +1470,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                       lm, transparency_cache, p2, 0, luminance );
     }
 
-    if( south ) {
+    if( e.direction & light_source_cast::south ) {
         castLight<1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
                       lm, transparency_cache, p2, 0, luminance );
@@ -1223,7 +1479,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                       lm, transparency_cache, p2, 0, luminance );
     }
 
-    if( west ) {
+    if( e.direction & light_source_cast::west ) {
         castLight<0, 1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
                       lm, transparency_cache, p2, 0, luminance );
@@ -1233,37 +1489,35 @@ void map::apply_light_source( const tripoint &p, float luminance )
     }
 }
 
-void map::apply_directional_light( const tripoint &p, int direction, float luminance )
+static void cast_light_directional( cata::mdarray<four_quadrants, point_bub_ms> &lm,
+                                    const cata::mdarray<float, point_bub_ms> &transparency_cache,
+                                    const light_source_cast &e )
 {
-    const point p2( p.xy() );
-
-    level_cache &cache = get_cache( p.z );
-    cata::mdarray<four_quadrants, point_bub_ms> &lm = cache.lm;
-    cata::mdarray<float, point_bub_ms> &transparency_cache =
-        cache.transparency_cache;
+    const point p2( e.p.xy() );
+    const float luminance = e.luminance;
 
-    if( direction == 90 ) {
+    if( e.direction == 90 ) {
         castLight < 1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
                       lm, transparency_cache, p2, 0, luminance );
         castLight < -1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
                       lm, transparency_cache, p2, 0, luminance );
-    } else if( direction == 0 ) {
+    } else if( e.direction == 0 ) {
         castLight < 0, -1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
                       lm, transparency_cache, p2, 0, luminance );
         castLight < 0, -1, -1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
                       lm, transparency_cache, p2, 0, luminance );
-    } else if( direction == 270 ) {
+    } else if( e.direction == 270 ) {
         castLight<1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
                       lm, transparency_cache, p2, 0, luminance );
         castLight < -1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency > (
                       lm, transparency_cache, p2, 0, luminance );
-    } else if( direction == 180 ) {
+    } else if( e.direction == 180 ) {
         castLight<0, 1, 1, 0, float, four_quadrants, light_calc, light_check,
                   update_light_quadrants, accumulate_transparency>(
                       lm, transparency_cache, p2, 0, luminance );
@@ -1273,21 +1527,14 @@ void map::apply_directional_light( const tripoint &p, int direction, float lumin
     }
 }
 
-void map::apply_light_arc( const tripoint &p, const units::angle &angle, float luminance,
-                           const units::angle &wideangle )
+static void cast_light_arc( cata::mdarray<four_quadrants, point_bub_ms> &lm,
+                            const cata::mdarray<float, point_bub_ms> &transparency_cache,
+                            const light_source_cast &e )
 {
-    if( luminance <= LIGHT_SOURCE_LOCAL ) {
-        return;
-    }
-
-    apply_light_source( p, LIGHT_SOURCE_LOCAL );
-
-    const point p2( p.xy() );
-
-    level_cache &cache = get_cache( p.z );
-    cata::mdarray<four_quadrants, point_bub_ms> &lm = cache.lm;
-    cata::mdarray<float, point_bub_ms> &transparency_cache =
-        cache.transparency_cache;
+    const point p2( e.p.xy() );
+    const float luminance = e.luminance;
+    const units::angle &angle = e.angle;
+    const units::angle &wideangle = e.width;
 
     // Normalize (should work with negative values too)
     units::angle wangle = wideangle / 2.0;
@@ -1438,6 +1685,112 @@ void map::apply_light_arc( const tripoint &p, const units::angle &angle, float l
             break;
     }
 }
+void light_source_cast::cast( cata::mdarray<four_quadrants, point_bub_ms> &lm,
+                           const cata::mdarray<float, point_bub_ms> &transparency_cache ) const
+{
+    switch( type ) {
+        case shape::circle:
+            cast_light_circle( lm, transparency_cache, *this );
+            break;
+        case shape::directional:
+            cast_light_directional( lm, transparency_cache, *this );
+            break;
+        case shape::arc:
+            cast_light_arc( lm, transparency_cache, *this );
+            break;
+    }
+}
+
+int light_source_cast::reach() const
+{
+    float cast_luminance = luminance;
+    if( type == shape::circle ) {
+        if( luminance <= lit_level::LOW ) {
+            return 0;
+        } else if( luminance <= lit_level::BRIGHT_ONLY ) {
+            cast_luminance = 1.49f;
+        }
+    }
+    // castLight only advances to the next row while the light is above
+    // LIGHT_AMBIENT_LOW, and light falls off at least as 1 / distance. The
+    // extra 10% covers fastexp undershooting.
+    return std::min( 60, static_cast<int>( cast_luminance * 1.1f / LIGHT_AMBIENT_LOW ) + 2 );
+}
+
+void map::apply_light_source( const tripoint &p, float luminance )
+{
+    light_source_cast emission;
+    emission.p = p;
+    emission.luminance = luminance;
+
+    if( luminance > lit_level::LOW ) {
+        if( luminance <= lit_level::BRIGHT_ONLY ) {
+            luminance = 1.49f;
+        }
+        const cata::mdarray<float, point_bub_ms> &light_source_buffer =
+            get_cache( p.z ).light_source_buffer;
+        const point p2( p.xy() );
+
+        /* If we're a 5 luminance fire , we skip casting rays into ey && sx if we have
+             neighboring fires to the north and west that were applied via light_source_buffer
+           If there's a 1 luminance candle east in buffer, we still cast rays into ex since it's smaller
+           If there's a 100 luminance magnesium flare south added via apply_light_source instead od
+             add_light_source, it's unbuffered so we'll still cast rays into sy.
+
+              ey
+            nnnNnnn
+            w     e
+            w  5 +e
+         sx W 5*1+E ex
+            w ++++e
+            w+++++e
+            sssSsss
+               sy
+        */
+        const int peer_inbounds = LIGHTMAP_CACHE_X - 1;
+        if( p2.y != 0 && light_source_buffer[p2.x][p2.y - 1] < luminance ) {
+            emission.direction |= light_source_cast::north;
+        }
+        if( p2.y != peer_inbounds && light_source_buffer[p2.x][p2.y + 1] < luminance ) {
+            emission.direction |= light_source_cast::south;
+        }
+        if( p2.x != peer_inbounds && light_source_buffer[p2.x + 1][p2.y] < luminance ) {
+            emission.direction |= light_source_cast::east;
+        }
+        if( p2.x != 0 && light_source_buffer[p2.x - 1][p2.y] < luminance ) {
+            emission.direction |= light_source_cast::west;
+        }
+    }
+    pending_light_casts.push_back( emission );
+}
+
+void map::apply_directional_light( const tripoint &p, int direction, float luminance )
+{
+    light_source_cast emission;
+    emission.type = light_source_cast::shape::directional;
+    emission.p = p;
+    emission.luminance = luminance;
+    emission.direction = direction;
+    pending_light_casts.push_back( emission );
+}
+
+void map::apply_light_arc( const tripoint &p, const units::angle &angle, float luminance,
+                           const units::angle &wideangle )
+{
+    if( luminance <= LIGHT_SOURCE_LOCAL ) {
+        return;
+    }
+
+    apply_light_source( p, LIGHT_SOURCE_LOCAL );
+
+    light_source_cast emission;
+    emission.type = light_source_cast::shape::arc;
+    emission.p = p;
+    emission.luminance = luminance;
+    emission.angle = angle;
+    emission.width = wideangle;
+    pending_light_casts.push_back( emission );
+}
 
 void map::apply_light_ray(
     cata::mdarray<bool, point_bub_ms, LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y> &lit,
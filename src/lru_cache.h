@@ -2,7 +2,11 @@
 #ifndef CATA_SRC_LRU_CACHE_H
 #define CATA_SRC_LRU_CACHE_H
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <list>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 
@@ -85,4 +89,136 @@ inline void lru_cache<Key, Value>::clear()
     ordered_list.clear();
 }
 
+/**
+ * Drop-in alternative to @ref lru_cache for small, trivially copyable keys and
+ * values on hot paths.
+ *
+ * Entries live in a single flat array of slots using open addressing with a
+ * bounded probe window. When the window for a key is full, the least recently
+ * touched slot in it is evicted, so eviction is approximately LRU. The slot
+ * array is allocated once, sized from the first insert's limit (rounded up to
+ * a power of two); after that, no operation allocates, and clear() only bumps a
+ * generation counter instead of touching every slot.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class flat_lru_cache
+{
+    public:
+        Value get( const Key &, const Value &default_ ) const;
+        // The capacity is fixed by the first call; later limits are ignored.
+        void insert( int limit, const Key &, const Value & );
+        void remove( const Key & );
+
+        void clear();
+
+        size_t capacity() const {
+            return mask == 0 ? 0 : mask + 1;
+        }
+    private:
+        static constexpr size_t probe_window = 8;
+
+        struct slot {
+            Key key;
+            Value value;
+            // 0 never matches the current generation, marking the slot empty.
+            uint32_t generation;
+            uint32_t last_use;
+        };
+
+        size_t home_slot( const Key &key ) const {
+            // Fibonacci hashing, so that weak hashes (like point's) still
+            // spread over the table.
+            return static_cast<size_t>( static_cast<uint64_t>( Hash()( key ) ) * 11400714819323198485ULL >>
+                                        hash_shift );
+        }
+        slot *find( const Key &key ) const;
+
+        std::unique_ptr<slot[]> slots;
+        size_t mask = 0;
+        int hash_shift = 64;
+        uint32_t generation = 1;
+        mutable uint32_t clock = 0;
+};
+
+template<typename Key, typename Value, typename Hash>
+inline typename flat_lru_cache<Key, Value, Hash>::slot *flat_lru_cache<Key, Value, Hash>::find(
+    const Key &key ) const
+{
+    if( !slots ) {
+        return nullptr;
+    }
+    const size_t home = home_slot( key );
+    for( size_t i = 0; i < probe_window; ++i ) {
+        slot &s = slots[( home + i ) & mask];
+        if( s.generation == generation && s.key == key ) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+template<typename Key, typename Value, typename Hash>
+inline Value flat_lru_cache<Key, Value, Hash>::get( const Key &key, const Value &default_ ) const
+{
+    if( slot *const found = find( key ) ) {
+        found->last_use = ++clock;
+        return found->value;
+    }
+    return default_;
+}
+
+template<typename Key, typename Value, typename Hash>
+inline void flat_lru_cache<Key, Value, Hash>::insert( int limit, const Key &key, const Value &t )
+{
+    if( !slots ) {
+        size_t size = probe_window;
+        hash_shift = 61;
+        while( size < static_cast<size_t>( limit ) ) {
+            size *= 2;
+            --hash_shift;
+        }
+        slots.reset( new slot[size]() );
+        mask = size - 1;
+    }
+    const size_t home = home_slot( key );
+    slot *victim = nullptr;
+    for( size_t i = 0; i < probe_window; ++i ) {
+        slot &s = slots[( home + i ) & mask];
+        if( s.generation != generation ) {
+            // Keep looking in case the key itself is further along the window.
+            if( victim == nullptr || victim->generation == generation ) {
+                victim = &s;
+            }
+        } else if( s.key == key ) {
+            victim = &s;
+            break;
+        } else if( victim == nullptr ||
+                   ( victim->generation == generation && s.last_use < victim->last_use ) ) {
+            victim = &s;
+        }
+    }
+    victim->key = key;
+    victim->value = t;
+    victim->generation = generation;
+    victim->last_use = ++clock;
+}
+
+template<typename Key, typename Value, typename Hash>
+inline void flat_lru_cache<Key, Value, Hash>::remove( const Key &key )
+{
+    if( slot *const found = find( key ) ) {
+        found->generation = 0;
+    }
+}
+
+template<typename Key, typename Value, typename Hash>
+inline void flat_lru_cache<Key, Value, Hash>::clear()
+{
+    if( ++generation == 0 ) {
+        // Wrapped around; stale slots could now look current, so wipe them.
+        std::fill_n( slots.get(), capacity(), slot() );
+        generation = 1;
+    }
+}
+
 #endif // CATA_SRC_LRU_CACHE_H
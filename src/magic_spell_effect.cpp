@@ -757,7 +757,7 @@ static void move_field( map &here, const tripoint &from, const tripoint &to )
 {
     field &src_field = here.field_at( from );
     std::map<field_type_id, int> moving_fields;
-    for( const std::pair<const field_type_id, field_entry> &fd : src_field ) {
+    for( const field::value_type &fd : src_field ) {
         if( fd.first.is_valid() && !fd.first.id().is_null() ) {
             const int intensity = fd.second.get_field_intensity();
             moving_fields.emplace( fd.first, intensity );
@@ -833,7 +833,7 @@ static std::pair<field, tripoint> spell_remove_field( const spell &sp,
         }
 
         field &target_field = here.field_at( node.position );
-        for( const std::pair<const field_type_id, field_entry> &fd : target_field ) {
+        for( const field::value_type &fd : target_field ) {
             if( fd.first.is_valid() && !fd.first.id().is_null() &&
                 fd.second.get_field_type() == target_field_type_id ) {
                 field_removed = target_field;
@@ -856,7 +856,7 @@ static void handle_remove_fd_reality_tear_field( const std::pair<field, tripoint
         &fd_reality_tear_field,
         Creature &caster )
 {
-    for( const std::pair<const field_type_id, field_entry> &fd : std::get<0>
+    for( const field::value_type &fd : std::get<0>
          ( fd_reality_tear_field ) ) {
         const int &intensity = fd.second.get_field_intensity();
         const translation &intensity_name = fd.second.get_intensity_level().name;
@@ -908,7 +908,7 @@ void spell_effect::remove_field( const spell &sp, Creature &caster, const tripoi
     std::pair<field, tripoint> field_removed = spell_remove_field( sp, target_field_type_id, center,
             caster );
 
-    for( const std::pair<const field_type_id, field_entry> &fd : std::get<0>( field_removed ) ) {
+    for( const field::value_type &fd : std::get<0>( field_removed ) ) {
         if( fd.first.is_valid() && !fd.first.id().is_null() ) {
             sp.make_sound( caster.pos(), caster );
 
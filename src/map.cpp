@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <climits>
 #include <cmath>
 #include <cstdlib>
@@ -57,6 +58,7 @@
 #include "itype.h"
 #include "iuse.h"
 #include "iuse_actor.h"
+#include "latency_histogram.h"
 #include "lightmap.h"
 #include "line.h"
 #include "magic_ter_furn_transform.h"
@@ -78,6 +80,7 @@
 #include "overmapbuffer.h"
 #include "pathfinding.h"
 #include "pocket_type.h"
+#include "profiler.h"
 #include "projectile.h"
 #include "ranged.h"
 #include "relic.h"
@@ -89,6 +92,7 @@
 #include "sounds.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "translations.h"
 #include "trap.h"
@@ -378,6 +382,9 @@ void map::invalidate_map_cache( const int zlev )
         ch.floor_cache_dirty = true;
         ch.seen_cache_dirty = true;
         ch.outside_cache_dirty = true;
+        // The next lightmap recasts every light source instead of only the changed ones.
+        ch.light_casts.clear();
+        ch.lm_dynamic.fill( four_quadrants( 0.0f ) );
         set_transparency_cache_dirty( zlev );
     }
 }
@@ -638,6 +645,7 @@ void map::on_vehicle_moved( const int smz )
 
 void map::vehmove()
 {
+    CATA_PROFILE_ZONE( "map::vehmove" );
     // give vehicles movement points
     VehicleList vehicle_list;
     int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z();
@@ -740,6 +748,32 @@ bool map::vehproceed( VehicleList &vehicle_list )
     return true;
 }
 
+bool map::may_have_vehicle_in( const inclusive_cuboid<tripoint> &box,
+                               const vehicle *ignored ) const
+{
+    // parts on ramps can be a level away from the list their vehicle is kept in
+    const int minz = std::max( box.p_min.z - 1, -OVERMAP_DEPTH );
+    const int maxz = std::min( box.p_max.z + 1, OVERMAP_HEIGHT );
+    for( int zlev = minz; zlev <= maxz; ++zlev ) {
+        const level_cache *cache = get_cache_lazy( zlev );
+        if( !cache ) {
+            continue;
+        }
+        for( const vehicle *veh : cache->vehicle_list ) {
+            if( veh == ignored ) {
+                continue;
+            }
+            inclusive_cuboid<tripoint> bounds = veh->occupied_bounds();
+            bounds.p_min.z--;
+            bounds.p_max.z++;
+            if( box.overlaps( bounds ) ) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 static bool sees_veh( const Creature &c, vehicle &veh, bool force_recalc )
 {
     const auto &veh_points = veh.get_points( force_recalc );
@@ -3647,7 +3681,7 @@ bool map::terrain_moppable( const tripoint_bub_ms &p )
     }
 
     // Moppable fields ( blood )
-    for( const std::pair<const field_type_id, field_entry> &pr : field_at( p ) ) {
+    for( const field::value_type &pr : field_at( p ) ) {
         if( pr.second.get_field_type().obj().phase == phase_id::LIQUID ) {
             return true;
         }
@@ -4363,7 +4397,7 @@ void map::bash_vehicle( const tripoint &p, bash_params &params )
 void map::bash_field( const tripoint &p, bash_params &params )
 {
     std::vector<field_type_id> to_remove;
-    for( const std::pair<const field_type_id, field_entry> &fd : field_at( p ) ) {
+    for( const field::value_type &fd : field_at( p ) ) {
         if( fd.first->bash_info.str_min > -1 ) {
             params.did_bash = true;
             params.bashed_solid = true; // To prevent bashing furniture/vehicles
@@ -4576,7 +4610,7 @@ void map::shoot( const tripoint &p, projectile &proj, const bool hit_items )
     if( fields_there.field_count() > 0 ) {
         // Need to make a copy since 'remove_field' modifies the value
         field fields_copy = fields_there;
-        for( const std::pair<const field_type_id, field_entry> &fd : fields_copy ) {
+        for( const field::value_type &fd : fields_copy ) {
             if( fd.first->bash_info.str_min > 0 ) {
                 if( incendiary ) {
                     add_field( p, fd_fire, fd.second.get_field_intensity() - 1 );
@@ -5630,6 +5664,7 @@ static void process_vehicle_items( vehicle &cur_veh, int part )
 
 void map::process_items()
 {
+    CATA_PROFILE_ZONE( "map::process_items" );
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z();
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z();
     for( int gz = minz; gz <= maxz; ++gz ) {
@@ -5681,6 +5716,12 @@ void map::process_items_in_submap( submap &current_submap, const tripoint &gridp
     // If more are added as a side effect of processing, they are ignored this turn.
     // If they are destroyed before processing, they don't get processed.
     std::vector<item_reference> active_items = current_submap.active_items.get_for_processing();
+    // Items on the same tile share their temperature lookups.
+    std::stable_sort( active_items.begin(), active_items.end(),
+    []( const item_reference & lhs, const item_reference & rhs ) {
+        return lhs.location < rhs.location;
+    } );
+    std::optional<item_temperature_batch> batch;
     const point grid_offset( gridp.x * SEEX, gridp.y * SEEY );
     for( item_reference &active_item_ref : active_items ) {
         if( !active_item_ref.item_ref ) {
@@ -5689,6 +5730,10 @@ void map::process_items_in_submap( submap &current_submap, const tripoint &gridp
         }
 
         const tripoint map_location = tripoint( grid_offset + active_item_ref.location, gridp.z );
+        if( !batch || batch->location() != map_location ) {
+            batch.reset();
+            batch.emplace( map_location, *this );
+        }
         const furn_t &furn = this->furn( map_location ).obj();
 
         if( furn.has_flag( ter_furn_flag::TFLAG_DONT_REMOVE_ROTTEN ) ) {
@@ -5750,6 +5795,7 @@ void map::process_items_in_vehicle( vehicle &cur_veh, submap &current_submap )
         process_vehicle_items( cur_veh, vp.part_index() );
     }
 
+    std::optional<item_temperature_batch> batch;
     for( item_reference &active_item_ref : cur_veh.active_items.get_for_processing() ) {
         if( empty( cargo_parts ) ) {
             return;
@@ -5769,6 +5815,10 @@ void map::process_items_in_vehicle( vehicle &cur_veh, submap &current_submap )
         // Find the cargo part and coordinates corresponding to the current active item.
         const vehicle_part &pt = it->part();
         const tripoint item_loc = it->pos();
+        if( !batch || batch->location() != item_loc ) {
+            batch.reset();
+            batch.emplace( item_loc, *this );
+        }
         vehicle_stack items = cur_veh.get_items( pt );
         float it_insulation = 1.0f;
         temperature_flag flag = temperature_flag::NORMAL;
@@ -6519,7 +6569,7 @@ bool map::dangerous_field_at( const tripoint_bub_ms &p )
 
 bool map::mopsafe_field_at( const tripoint &p )
 {
-    for( const std::pair<const int_id<field_type>, field_entry> &pr : field_at( p ) ) {
+    for( const field::value_type &pr : field_at( p ) ) {
         const field_entry &fd = pr.second;
         if( !fd.is_mopsafe() ) {
             return false;
@@ -7219,7 +7269,9 @@ bool map::draw_maptile( const catacurses::window &w, const tripoint &p,
 
         if( !veh->forward_velocity() && !veh->player_in_control( player_character )
             && !( player_character.get_grab_type() == object_type::VEHICLE
-                  && veh->get_points().count( player_character.pos() + player_character.grab_point ) ) ) {
+                  && std::binary_search( veh->get_points().begin(), veh->get_points().end(),
+                                         player_character.pos() +
+                                         player_character.grab_point ) ) ) {
             memory_sym = sym;
         }
     }
@@ -8304,6 +8356,7 @@ void map::loadn( const tripoint &grid, const bool update_vehicles )
 
 void map::loadn( const point &grid, bool update_vehicles )
 {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     if( zlevels ) {
         for( int gridz = -OVERMAP_DEPTH; gridz <= OVERMAP_HEIGHT; gridz++ ) {
             loadn( tripoint( grid, gridz ), update_vehicles );
@@ -8317,6 +8370,36 @@ void map::loadn( const point &grid, bool update_vehicles )
     } else {
         loadn( tripoint( grid, abs_sub.z() ), update_vehicles );
     }
+    loadn_latency().record( std::chrono::steady_clock::now() - start );
+}
+
+latency_histogram &map::loadn_latency()
+{
+    static latency_histogram histogram;
+    return histogram;
+}
+
+void map::prefetch_submaps( const point &direction, const int distance ) const
+{
+    // Only the levels right around the avatar: all of them would be more quads than
+    // the read-ahead holds, and the far ones are rarely visited on the way.
+    const int zmin = zlevels ? std::max( abs_sub.z() - 1, -OVERMAP_DEPTH ) : abs_sub.z();
+    const int zmax = zlevels ? std::min( abs_sub.z() + 1, OVERMAP_HEIGHT ) : abs_sub.z();
+    for( int step = 1; step <= distance; step++ ) {
+        // Grid coordinates of the submaps that the step-th shift would load.
+        const int edge_x = direction.x > 0 ? my_MAPSIZE - 1 + step : -step;
+        const int edge_y = direction.y > 0 ? my_MAPSIZE - 1 + step : -step;
+        for( int i = -step; i < my_MAPSIZE + step; i++ ) {
+            for( int gridz = zmin; gridz <= zmax; gridz++ ) {
+                if( direction.x != 0 ) {
+                    MAPBUFFER.prefetch( abs_sub.xy() + tripoint( edge_x, i, gridz ) );
+                }
+                if( direction.y != 0 ) {
+                    MAPBUFFER.prefetch( abs_sub.xy() + tripoint( i, edge_y, gridz ) );
+                }
+            }
+        }
+    }
 }
 
 void map::rotten_item_spawn( const item &item, const tripoint &pnt )
@@ -9553,15 +9636,32 @@ void map::do_vehicle_caching( int z )
 
 void map::build_map_cache( const int zlev, bool skip_lightmap )
 {
+    CATA_PROFILE_ZONE( "map::build_map_cache" );
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
     bool seen_cache_dirty = false;
     bool camera_cache_dirty = false;
-    for( int z = minz; z <= maxz; z++ ) {
+    // Each of these only reads submaps and writes the caches of its own z-level
+    // (the floor cache peeks at the submaps below, read-only), so z-levels are
+    // independent of one another and may be built concurrently.
+    std::array<bool, OVERMAP_LAYERS> floor_cache_was_dirty{};
+    const auto build_level_caches = [&]( const int z ) {
         build_outside_cache( z );
         build_transparency_cache( z );
-        bool floor_cache_was_dirty = build_floor_cache( z );
-        seen_cache_dirty |= floor_cache_was_dirty;
+        floor_cache_was_dirty[z + OVERMAP_DEPTH] = build_floor_cache( z );
+    };
+    // Missing submaps are reported through debugmsg, which must stay on the main thread.
+    const bool all_submaps_loaded = std::find( grid.begin(), grid.end(), nullptr ) == grid.end();
+    if( parallel_map_cache && maxz > minz && all_submaps_loaded ) {
+        cata::get_thread_pool().parallel_for( minz, maxz + 1, build_level_caches );
+    } else {
+        for( int z = minz; z <= maxz; z++ ) {
+            build_level_caches( z );
+        }
+    }
+    // Barrier: everything below reads or writes caches across z-levels.
+    for( int z = minz; z <= maxz; z++ ) {
+        seen_cache_dirty |= floor_cache_was_dirty[z + OVERMAP_DEPTH];
         seen_cache_dirty |= get_cache( z ).seen_cache_dirty;
     }
     // needs a separate pass as it changes the caches on neighbour z-levels (e.g. floor_cache);
@@ -10300,7 +10400,7 @@ void map::set_pathfinding_cache_dirty( const int zlev )
 void map::set_pathfinding_cache_dirty( const tripoint &p )
 {
     if( inbounds( p ) ) {
-        get_pathfinding_cache( p.z ).dirty_points.insert( p.xy() );
+        get_pathfinding_cache( p.z ).mark_dirty( p.xy() );
     }
 }
 
@@ -10328,7 +10428,7 @@ const pathfinding_cache &map::get_pathfinding_cache_ref( int zlev ) const
         return *pathfinding_caches[ OVERMAP_DEPTH ];
     }
     pathfinding_cache &cache = get_pathfinding_cache( zlev );
-    if( cache.dirty || !cache.dirty_points.empty() ) {
+    if( cache.dirty || cache.has_dirty_points() ) {
         update_pathfinding_cache( zlev );
     }
 
@@ -10340,11 +10440,14 @@ void map::update_pathfinding_cache( const tripoint &p ) const
     if( !inbounds( p ) ) {
         return;
     }
+    update_pathfinding_cache( p, maptile_at_internal( p ) );
+}
+
+void map::update_pathfinding_cache( const tripoint &p, const const_maptile &tile ) const
+{
     pathfinding_cache &cache = get_pathfinding_cache( p.z );
     pf_special cur_value = PF_NORMAL;
 
-    const_maptile tile = maptile_at_internal( p );
-
     const ter_t &terrain = tile.get_ter_t();
     const furn_t &furniture = tile.get_furn_t();
     const field &field = tile.get_field();
@@ -10404,13 +10507,31 @@ void map::update_pathfinding_cache( int zlev ) const
                 update_pathfinding_cache( { x, y, zlev } );
             }
         }
+        cache.hierarchy.invalidate();
+        cache.flow_fields.clear();
         cache.dirty = false;
-    } else {
-        for( const point &p : cache.dirty_points ) {
-            update_pathfinding_cache( { p, zlev } );
+    } else if( cache.has_dirty_points() ) {
+        // Walk each changed submap once instead of looking up the submap per point.
+        for( const point &grid : cache.dirty_submap_list ) {
+            const submap *sm = get_submap_at_grid( tripoint( grid, zlev ) );
+            if( sm == nullptr ) {
+                continue;
+            }
+            const point origin( grid.x * SEEX, grid.y * SEEY );
+            for( int x = 0; x < SEEX; x++ ) {
+                for( int y = 0; y < SEEY; y++ ) {
+                    if( cache.is_dirty( origin + point( x, y ) ) ) {
+                        update_pathfinding_cache( tripoint( origin + point( x, y ), zlev ),
+                                                  const_maptile( sm, point( x, y ) ) );
+                    }
+                }
+            }
+            // Hierarchy clusters are submaps.
+            cache.hierarchy.invalidate( origin );
         }
+        cache.flow_fields.clear();
     }
-    cache.dirty_points.clear();
+    cache.clear_dirty_points();
 }
 
 void map::clip_to_bounds( tripoint &p ) const
@@ -28,6 +28,7 @@
 #include "coordinate_conversions.h"
 #include "coordinates.h"
 #include "creature.h"
+#include "cuboid_rectangle.h"
 #include "enums.h"
 #include "game_constants.h"
 #include "item.h"
@@ -63,6 +64,7 @@ class computer;
 class field;
 class field_entry;
 class item_location;
+class latency_histogram;
 class mapgendata;
 class monster;
 class optional_vpart_position;
@@ -95,11 +97,13 @@ using VehicleList = std::vector<wrapped_vehicle>;
 class map;
 
 enum class ter_furn_flag : int;
+struct flow_field;
 struct pathfinding_cache;
 struct pathfinding_settings;
 template<typename T>
 struct weighted_int_list;
 struct field_proc_data;
+struct gas_spread_plan;
 
 using relic_procgen_id = string_id<relic_procgen_data>;
 
@@ -506,6 +510,14 @@ class map
          * Note: the map must have been loaded before this can be called.
          */
         void shift( const point &s );
+        /**
+         * Starts reading the submaps that a shift in @p direction (one submap
+         * each way at most) would load from disk in the background, for the next
+         * @p distance shifts.  See @ref mapbuffer::prefetch.
+         */
+        void prefetch_submaps( const point &direction, int distance ) const;
+        /** How long loading a single submap into any map took so far. */
+        static latency_histogram &loadn_latency();
         /**
          * Moves the map vertically to (not by!) newz.
          * Does not actually shift anything, only forces cache updates.
@@ -529,9 +541,19 @@ class map
         std::array<std::pair<tripoint, maptile>, 8> get_neighbors( const tripoint &p );
         void spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
                          const time_duration &outdoor_age_speedup, scent_block &sblk,
-                         const oter_id &om_ter );
+                         const oter_id &om_ter, const gas_spread_plan *plan );
+        /**
+         * Picks where the gas in cur at p spreads to this turn, if anywhere, without
+         * changing the map.  Random numbers are drawn from rolls, see map_field.cpp.
+         */
+        template<typename Rng>
+        std::optional<tripoint> gas_spread_destination( const field_entry &cur, const tripoint &p,
+                int percent_spread, const oter_id &om_ter, Rng &rolls );
+        // Decides where the gases in the submap at the given grid position spread this turn.
+        void plan_gas_spread( const tripoint &grid_pos, const oter_id &om_ter,
+                              unsigned int turn_seed, gas_spread_plan &plan );
         void create_hot_air( const tripoint &p, int intensity );
-        bool gas_can_spread_to( field_entry &cur, const maptile &dst );
+        bool gas_can_spread_to( const field_entry &cur, const maptile &dst );
         void gas_spread_to( field_entry &cur, maptile &dst, const tripoint &p );
         int burn_body_part( Character &you, field_entry &cur, const bodypart_id &bp, int scale );
     public:
@@ -705,6 +727,17 @@ class map
                                             const pathfinding_settings &settings,
         const std::unordered_set<tripoint> &pre_closed = {{ }} ) const;
 
+        /**
+         * Like @ref route, but for routes to targets that many creatures head for in
+         * the same turn, e.g. a horde chasing the avatar.  Once a target has been
+         * asked for often enough, one flow field for it is built and shared by every
+         * later route to it this turn.  Falls back to @ref route where the field
+         * doesn't apply.
+         */
+        std::vector<tripoint> route_to_shared_target( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings,
+        const std::unordered_set<tripoint> &pre_closed = {{ }} ) const;
+
         // Get a straight route from f to t, only along non-rough terrain. Returns an empty vector
         // if that is not possible.
         std::vector<tripoint> straight_route( const tripoint &f, const tripoint &t ) const;
@@ -739,6 +772,10 @@ class map
         void vehmove();
         // Selects a vehicle to move, returns false if no moving vehicles
         bool vehproceed( VehicleList &vehicle_list );
+        // Broadphase for vehicle collisions: whether any vehicle but @p ignored may have a
+        // part inside @p box, judged by the vehicles' bounding boxes
+        bool may_have_vehicle_in( const inclusive_cuboid<tripoint> &box,
+                                  const vehicle *ignored ) const;
 
         // Vehicles
         VehicleList get_vehicles( const tripoint &start, const tripoint &end );
@@ -1537,7 +1574,12 @@ class map
         void create_burnproducts( const tripoint &p, const item &fuel, const units::mass &burned_mass );
         // See fields.cpp
         void process_fields();
-        void process_fields_in_submap( submap *current_submap, const tripoint &submap_pos );
+        /**
+         * @param plan where the gases in the submap spread, if that was decided in advance
+         * (see PARALLEL_FIELDS), otherwise they decide while being processed.
+         */
+        void process_fields_in_submap( submap *current_submap, const tripoint &submap_pos,
+                                       const gas_spread_plan *plan = nullptr );
         /**
          * Apply field effects to the creature when it's on a square with fields.
          */
@@ -2026,7 +2068,10 @@ class map
         void build_seen_cache( const tripoint &origin, int target_z, int extension_range = 60,
                                bool cumulative = false,
                                bool camera = false, int penalty = 0 );
-        void apply_character_light( Character &p );
+        // Applies the character's lights and returns the luminance of the light they carry.
+        float apply_character_light( Character &p );
+        // Recasts lm_dynamic of the level around light casts and transparency that changed.
+        void update_dynamic_lightmap( int zlev, std::vector<light_source_cast> &emissions );
 
         int my_MAPSIZE;
         int my_HALF_MAPSIZE;
@@ -2189,7 +2234,9 @@ class map
                               const const_maptile &tile, const drawsq_params &params ) const;
 
         int determine_wall_corner( const tripoint &p ) const;
-        // apply a circular light pattern immediately, however it's best to use...
+        // The apply_light_* functions record their light into pending_light_casts,
+        // generate_lightmap casts it once it has collected everything.
+        // apply a circular light pattern, however it's best to use...
         void apply_light_source( const tripoint &p, float luminance );
         // ...this, which will apply the light after at the end of generate_lightmap, and prevent redundant
         // light rays from causing massive slowdowns, if there's a huge amount of light.
@@ -2279,11 +2326,16 @@ class map
 
         /**
          * Cache of coordinate pairs recently checked for visibility.
+         * Monster target acquisition hits this every turn, so it uses the
+         * allocation-free flat cache rather than the list-based one.
          */
-        using lru_cache_t = lru_cache<point, char>;
+        using lru_cache_t = flat_lru_cache<point, char>;
         mutable lru_cache_t skew_vision_cache;
         mutable lru_cache_t skew_vision_wo_fields_cache;
 
+        // Scratch space for generate_lightmap, kept around to avoid reallocating it every turn.
+        std::vector<light_source_cast> pending_light_casts;
+
         // Note: no bounds check
         level_cache &get_cache( int zlev ) const {
             std::unique_ptr<level_cache> &cache = caches[zlev + OVERMAP_DEPTH];
@@ -2298,6 +2350,7 @@ class map
         }
 
         pathfinding_cache &get_pathfinding_cache( int zlev ) const;
+        void build_flow_field( flow_field &field, int zlev ) const;
 
         visibility_variables visibility_variables_cache;
 
@@ -2320,6 +2373,7 @@ class map
         const pathfinding_cache &get_pathfinding_cache_ref( int zlev ) const;
 
         void update_pathfinding_cache( const tripoint &p ) const;
+        void update_pathfinding_cache( const tripoint &p, const const_maptile &tile ) const;
         void update_pathfinding_cache( int zlev ) const;
 
         void update_visibility_cache( int zlev );
@@ -390,7 +390,7 @@ static bool mx_helicopter( map &m, const tripoint &abs_sub )
     vehicle *wreckage = m.add_vehicle( crashed_hull, wreckage_pos, dir1, rng( 1, 33 ), 1 );
 
     const auto controls_at = []( vehicle * wreckage, const tripoint & pos ) {
-        return !wreckage->get_parts_at( pos, "CONTROLS", part_status_flag::any ).empty() ||
+        return !wreckage->get_parts_at( pos, VPFLAG_CONTROLS, part_status_flag::any ).empty() ||
                !wreckage->get_parts_at( pos, "CTRL_ELECTRONIC", part_status_flag::any ).empty();
     };
 
@@ -1485,10 +1485,8 @@ static bool mx_burned_ground( map &m, const tripoint &abs_sub )
     std::vector<tripoint> points;
     for( wrapped_vehicle vehicle : vehs ) {
         vehicles.push_back( vehicle.v );
-        std::set<tripoint> occupied = vehicle.v->get_points();
-        for( const tripoint &t : occupied ) {
-            points.push_back( t );
-        }
+        const std::vector<tripoint> &occupied = vehicle.v->get_points();
+        points.insert( points.end(), occupied.begin(), occupied.end() );
     }
     for( vehicle *vrem : vehicles ) {
         m.destroy_vehicle( vrem );
@@ -11,6 +11,7 @@
 #include <new>
 #include <optional>
 #include <queue>
+#include <random>
 #include <set>
 #include <string>
 #include <tuple>
@@ -18,6 +19,7 @@
 #include <vector>
 
 #include "bodypart.h"
+#include "cached_options.h"
 #include "calendar.h"
 #include "cata_utility.h"
 #include "character.h"
@@ -54,11 +56,13 @@
 #include "npc.h"
 #include "overmapbuffer.h"
 #include "point.h"
+#include "profiler.h"
 #include "rng.h"
 #include "scent_block.h"
 #include "scent_map.h"
 #include "submap.h"
 #include "teleport.h"
+#include "thread_pool.h"
 #include "translations.h"
 #include "type_id.h"
 #include "units.h"
@@ -158,8 +162,122 @@ int map::burn_body_part( Character &you, field_entry &cur, const bodypart_id &bp
     return total_damage;
 }
 
+/**
+ * Where the gases of one submap spread this turn, decided in advance from the map as
+ * it was at the start of the turn, see map::plan_gas_spread.
+ */
+struct gas_spread_plan {
+    struct spread {
+        tripoint source;
+        field_type_id type;
+        // nullopt if the gas was planned to stay where it is
+        std::optional<tripoint> destination;
+    };
+    // Every planned gas, in the order the submap is processed in, by x and then y.
+    std::vector<spread> spreads;
+
+    // The plan for the gas of @p type at @p source, or nullptr if it was not there
+    // when the plan was made.
+    const spread *find( const tripoint &source, const field_type_id &type ) const {
+        auto it = std::lower_bound( spreads.begin(), spreads.end(), source,
+        []( const spread & s, const tripoint & p ) {
+            return s.source.x < p.x || ( s.source.x == p.x && s.source.y < p.y );
+        } );
+        for( ; it != spreads.end() && it->source == source; ++it ) {
+            if( it->type == type ) {
+                return &*it;
+            }
+        }
+        return nullptr;
+    }
+};
+
+namespace
+{
+
+// Random numbers for map::gas_spread_destination from the global generator.
+class global_rng
+{
+    public:
+        int roll( const int lo, const int hi ) {
+            return rng( lo, hi );
+        }
+        bool x_in_y( const double x, const double y ) {
+            return ::x_in_y( x, y );
+        }
+};
+
+// An independent stream of random numbers for planning one submap.  It is seeded
+// from a number drawn once per turn from the global generator and the submap's
+// position, so a plan comes out the same whichever thread makes it and whatever
+// was planned before.
+class submap_rng
+{
+    public:
+        submap_rng( const unsigned int turn_seed, const tripoint_abs_sm &sm ) {
+            std::seed_seq seed{ turn_seed,
+                                static_cast<unsigned int>( sm.x() ),
+                                static_cast<unsigned int>( sm.y() ),
+                                static_cast<unsigned int>( sm.z() ) };
+            engine.seed( seed );
+        }
+        int roll( const int lo, const int hi ) {
+            std::uniform_int_distribution<int> dist( std::min( lo, hi ), std::max( lo, hi ) );
+            return dist( engine );
+        }
+        bool x_in_y( const double x, const double y ) {
+            return std::uniform_real_distribution<double>( 0.0, 1.0 )( engine ) <= x / y;
+        }
+
+    private:
+        cata_default_random_engine engine;
+};
+
+} // namespace
+
 void map::process_fields()
 {
+    CATA_PROFILE_ZONE( "map::process_fields" );
+    const auto plan_index = []( const tripoint & grid_pos ) {
+        return grid_pos.x + ( grid_pos.y + ( grid_pos.z + OVERMAP_DEPTH ) * MAPSIZE ) * MAPSIZE;
+    };
+    // With PARALLEL_FIELDS, where the gases of every submap spread this turn is
+    // decided up front, concurrently, from the map as it is now.  Everything else
+    // (fire in particular touches items, terrain and creatures) stays serial below,
+    // and applies those decisions in a fixed order.
+    std::vector<gas_spread_plan> plans;
+    // Missing submaps are reported through debugmsg, which must stay on the main thread.
+    if( parallel_fields && std::find( grid.begin(), grid.end(), nullptr ) == grid.end() ) {
+        std::vector<std::pair<tripoint, oter_id>> to_plan;
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+            const auto &field_cache = get_cache( z ).field_cache;
+            for( int x = 0; x < my_MAPSIZE; x++ ) {
+                for( int y = 0; y < my_MAPSIZE; y++ ) {
+                    if( field_cache[ x + y * MAPSIZE ] ) {
+                        // Overmaps may be generated on demand, so this can't be done on the pool.
+                        const tripoint grid_pos( x, y, z );
+                        const tripoint_abs_omt omt( sm_to_omt_copy( grid_pos ) );
+                        to_plan.emplace_back( grid_pos, overmap_buffer.ter( omt ) );
+                    }
+                }
+            }
+        }
+        plans.resize( MAPSIZE * MAPSIZE * OVERMAP_LAYERS );
+        // g->is_sheltered refreshes vehicle insides when they are dirty, which must not
+        // happen on the workers, so get them up to date first.
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+            for( vehicle *veh : get_cache( z ).vehicle_list ) {
+                veh->refresh_insides();
+            }
+        }
+        const unsigned int turn_seed = rng_bits();
+        const int num_to_plan = static_cast<int>( to_plan.size() );
+        cata::get_thread_pool().parallel_for( 0, num_to_plan, [&]( const int i ) {
+            plan_gas_spread( to_plan[i].first, to_plan[i].second, turn_seed,
+                             plans[plan_index( to_plan[i].first )] );
+        } );
+    }
+
     for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
         auto &field_cache = get_cache( z ).field_cache;
         for( int x = 0; x < my_MAPSIZE; x++ ) {
@@ -170,7 +288,10 @@ void map::process_fields()
                         debugmsg( "Tried to process field at (%d,%d,%d) but the submap is not loaded", x, y, z );
                         continue;
                     }
-                    process_fields_in_submap( current_submap, tripoint( x, y, z ) );
+                    const tripoint grid_pos( x, y, z );
+                    const gas_spread_plan *const plan = plans.empty() ? nullptr :
+                                                        &plans[plan_index( grid_pos )];
+                    process_fields_in_submap( current_submap, grid_pos, plan );
                     if( current_submap->field_count == 0 ) {
                         field_cache[ x + y * MAPSIZE ] = false;
                     }
@@ -180,6 +301,33 @@ void map::process_fields()
     }
 }
 
+void map::plan_gas_spread( const tripoint &grid_pos, const oter_id &om_ter,
+                           const unsigned int turn_seed, gas_spread_plan &plan )
+{
+    const submap *const current_submap = get_submap_at_grid( grid_pos );
+    submap_rng rolls( turn_seed, get_abs_sub() + grid_pos );
+    const point sm_offset = sm_to_ms_copy( grid_pos.xy() );
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            const field &curfield = current_submap->get_field( { x, y } );
+            if( !curfield.displayed_field_type() ) {
+                continue;
+            }
+            const tripoint p( sm_offset + point( x, y ), grid_pos.z );
+            for( const field::value_type &fld : curfield ) {
+                const field_entry &cur = fld.second;
+                // The same fields process_fields_in_submap runs the processors of.
+                if( !cur.is_field_alive() || cur.get_field_age() == 0_turns ||
+                    !fld.first->gas_can_spread() ) {
+                    continue;
+                }
+                plan.spreads.push_back( { p, fld.first, gas_spread_destination( cur, p,
+                                          fld.first->percent_spread, om_ter, rolls ) } );
+            }
+        }
+    }
+}
+
 bool ter_furn_has_flag( const ter_t &ter, const furn_t &furn, const ter_furn_flag flag )
 {
     return ter.has_flag( flag ) || furn.has_flag( flag );
@@ -230,7 +378,7 @@ std::array<std::pair<tripoint, maptile>, 8> map::get_neighbors( const tripoint &
     };
 }
 
-bool map::gas_can_spread_to( field_entry &cur, const maptile &dst )
+bool map::gas_can_spread_to( const field_entry &cur, const maptile &dst )
 {
     const field_entry *tmpfld = dst.get_field().find_field( cur.get_field_type() );
     // Candidates are existing weaker fields or navigable/flagged tiles with no field.
@@ -269,54 +417,36 @@ void map::gas_spread_to( field_entry &cur, maptile &dst, const tripoint &p )
     }
 }
 
-void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
-                      const time_duration &outdoor_age_speedup, scent_block &sblk, const oter_id &om_ter )
+template<typename Rng>
+std::optional<tripoint> map::gas_spread_destination( const field_entry &cur, const tripoint &p,
+        const int percent_spread, const oter_id &om_ter, Rng &rolls )
 {
     // TODO: fix point types
     const bool sheltered = g->is_sheltered( p );
-    weather_manager &weather = get_weather();
+    const weather_manager &weather = get_weather();
     const int winddirection = weather.winddirection;
     const int windpower = get_local_windpower( weather.windspeed, om_ter, tripoint_abs_ms( p ),
                           winddirection,
                           sheltered );
 
-    const int current_intensity = cur.get_field_intensity();
-    const field_type_id ft_id = cur.get_field_type();
-
-    const int scent_neutralize = ft_id->get_intensity_level( current_intensity -
-                                 1 ).scent_neutralization;
-
-    if( scent_neutralize > 0 ) {
-        // modify scents by neutralization value (minus)
-        for( const tripoint &tmp : points_in_radius( p, 1 ) ) {
-            sblk.apply_gas( tmp, scent_neutralize );
-        }
-    }
-
-    // Dissipate faster outdoors.
-    if( is_outside( p ) ) {
-        const time_duration current_age = cur.get_field_age();
-        cur.set_field_age( current_age + outdoor_age_speedup );
-    }
-
     // Bail out if we don't meet the spread chance or required intensity.
-    if( current_intensity <= 1 || rng( 1, 100 - windpower ) > percent_spread ) {
-        return;
+    if( cur.get_field_intensity() <= 1 || rolls.roll( 1, 100 - windpower ) > percent_spread ) {
+        return std::nullopt;
     }
 
     // First check if we can fall
     // TODO: Make fall and rise chances parameters to enable heavy/light gas
     if( p.z > -OVERMAP_DEPTH ) {
         const tripoint down{ p.xy(), p.z - 1 };
-        maptile down_tile = maptile_at_internal( down );
-        if( gas_can_spread_to( cur, down_tile ) && valid_move( p, down, true, true ) ) {
-            gas_spread_to( cur, down_tile, down );
-            return;
+        if( gas_can_spread_to( cur, maptile_at_internal( down ) ) &&
+            valid_move( p, down, true, true ) ) {
+            return down;
         }
     }
 
     auto neighs = get_neighbors( p );
-    size_t end_it = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
+    const int num_neighs = static_cast<int>( neighs.size() );
+    size_t end_it = static_cast<size_t>( rolls.roll( 0, num_neighs - 1 ) );
     std::vector<size_t> spread;
     // Then, spread to a nearby point.
     // If not possible (or randomly), try to spread up
@@ -331,11 +461,15 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
         }
     }
 
-    if( !spread.empty() && one_in( spread.size() ) ) {
+    const auto random_index = [&rolls]( const std::vector<size_t> &indices ) {
+        return indices[rolls.roll( 0, static_cast<int>( indices.size() ) - 1 )];
+    };
+    // Same as one_in( spread.size() ).
+    if( !spread.empty() &&
+        ( spread.size() == 1 || rolls.roll( 0, static_cast<int>( spread.size() ) - 1 ) == 0 ) ) {
         // Construct the destination from offset and p
         if( sheltered || windpower < 5 ) {
-            std::pair<tripoint, maptile> &n = neighs[ random_entry( spread ) ];
-            gas_spread_to( cur, n.second, n.first );
+            return neighs[ random_index( spread ) ].first;
         } else {
             std::vector<size_t> neighbour_vec;
             auto maptiles = get_wind_blockers( winddirection, p );
@@ -348,22 +482,64 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
                 if( ( neigh.pos_ != remove_tile.pos_ &&
                       neigh.pos_ != remove_tile2.pos_ &&
                       neigh.pos_ != remove_tile3.pos_ ) ||
-                    x_in_y( 1, std::max( 2, windpower ) ) ) {
+                    rolls.x_in_y( 1, std::max( 2, windpower ) ) ) {
                     neighbour_vec.push_back( i );
                 }
             }
             if( !neighbour_vec.empty() ) {
-                std::pair<tripoint, maptile> &n = neighs[ random_entry( neighbour_vec ) ];
-                gas_spread_to( cur, n.second, n.first );
+                return neighs[ random_index( neighbour_vec ) ].first;
             }
         }
     } else if( p.z < OVERMAP_HEIGHT ) {
         const tripoint up{ p.xy(), p.z + 1 };
-        maptile up_tile = maptile_at_internal( up );
-        if( gas_can_spread_to( cur, up_tile ) && valid_move( p, up, true, true ) ) {
-            gas_spread_to( cur, up_tile, up );
+        if( gas_can_spread_to( cur, maptile_at_internal( up ) ) &&
+            valid_move( p, up, true, true ) ) {
+            return up;
         }
     }
+    return std::nullopt;
+}
+
+void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
+                      const time_duration &outdoor_age_speedup, scent_block &sblk,
+                      const oter_id &om_ter, const gas_spread_plan *plan )
+{
+    const int current_intensity = cur.get_field_intensity();
+    const field_type_id ft_id = cur.get_field_type();
+
+    const int scent_neutralize = ft_id->get_intensity_level( current_intensity -
+                                 1 ).scent_neutralization;
+
+    if( scent_neutralize > 0 ) {
+        // modify scents by neutralization value (minus)
+        for( const tripoint &tmp : points_in_radius( p, 1 ) ) {
+            sblk.apply_gas( tmp, scent_neutralize );
+        }
+    }
+
+    // Dissipate faster outdoors.
+    if( is_outside( p ) ) {
+        const time_duration current_age = cur.get_field_age();
+        cur.set_field_age( current_age + outdoor_age_speedup );
+    }
+
+    std::optional<tripoint> destination;
+    const gas_spread_plan::spread *planned = plan == nullptr ? nullptr : plan->find( p, ft_id );
+    if( planned == nullptr ) {
+        // Not planned, or the gas only arrived here earlier in this turn.
+        global_rng rolls;
+        destination = gas_spread_destination( cur, p, percent_spread, om_ter, rolls );
+    } else if( planned->destination ) {
+        // The gas may have thinned, or its destination thickened, since it was planned.
+        if( current_intensity > 1 &&
+            gas_can_spread_to( cur, maptile_at( *planned->destination ) ) ) {
+            destination = planned->destination;
+        }
+    }
+    if( destination ) {
+        maptile dst = maptile_at( *destination );
+        gas_spread_to( cur, dst, *destination );
+    }
 }
 
 /*
@@ -408,6 +584,8 @@ struct field_proc_data {
     maptile &map_tile;
     field_type_id cur_fd_type_id;
     field_type const *cur_fd_type;
+    // Where gases spread, if that was decided in advance.
+    const gas_spread_plan *gas_plan;
 };
 
 /*
@@ -417,7 +595,7 @@ This is the general update function for field effects. This should only be calle
 If you need to insert a new field behavior per unit time add a case statement in the switch below.
 */
 void map::process_fields_in_submap( submap *const current_submap,
-                                    const tripoint &submap )
+                                    const tripoint &submap, const gas_spread_plan *plan )
 {
     const oter_id &om_ter = overmap_buffer.ter( tripoint_abs_omt( sm_to_omt_copy( submap ) ) );
     Character &player_character = get_player_character();
@@ -436,7 +614,8 @@ void map::process_fields_in_submap( submap *const current_submap,
         *this,
         map_tile,
         fd_null,
-        &( *fd_null )
+        &( *fd_null ),
+        plan
     };
 
     // Loop through all tiles in this submap indicated by current_submap
@@ -574,7 +753,7 @@ void field_processor_spread_gas( const tripoint &p, field_entry &cur, field_proc
 {
     // if( cur.gas_can_spread() )
     pd.here.spread_gas( cur, p, pd.cur_fd_type->percent_spread, pd.cur_fd_type->outdoor_age_speedup,
-                        pd.sblk, pd.om_ter );
+                        pd.sblk, pd.om_ter, pd.gas_plan );
 }
 
 static void field_processor_fd_fungal_haze( const tripoint &p, field_entry &cur,
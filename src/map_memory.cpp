@@ -1,3 +1,5 @@
+#include <deque>
+
 #include "cata_assert.h"
 #include "cached_options.h"
 #include "cata_utility.h"
@@ -85,24 +87,65 @@ bool mm_region::is_empty() const
     return true;
 }
 
+namespace
+{
+
+// Strings are kept in a deque so that references to them stay valid.
+struct interned_ids {
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, uint32_t> indices;
+
+    interned_ids() {
+        // The empty id is index 0, so that default tiles have no ids.
+        strings.emplace_back();
+        indices.emplace( strings.back(), 0 );
+    }
+};
+
+interned_ids &memorized_ids()
+{
+    static interned_ids ids;
+    return ids;
+}
+
+} // namespace
+
+uint32_t memorized_tile::intern( const std::string_view id )
+{
+    interned_ids &ids = memorized_ids();
+    const auto iter = ids.indices.find( id );
+    if( iter != ids.indices.end() ) {
+        return iter->second;
+    }
+    const uint32_t index = static_cast<uint32_t>( ids.strings.size() );
+    ids.strings.emplace_back( id );
+    ids.indices.emplace( ids.strings.back(), index );
+    return index;
+}
+
+const std::string &memorized_tile::interned( const uint32_t index )
+{
+    return memorized_ids().strings[index];
+}
+
 const std::string &memorized_tile::get_ter_id() const
 {
-    return ter_id.str();
+    return interned( ter_id );
 }
 
 const std::string &memorized_tile::get_dec_id() const
 {
-    return dec_id;
+    return interned( dec_id );
 }
 
 void memorized_tile::set_ter_id( const std::string_view id )
 {
-    ter_id = ter_str_id( id );
+    ter_id = intern( id );
 }
 
 void memorized_tile::set_dec_id( const std::string_view id )
 {
-    dec_id = id;
+    dec_id = intern( id );
 }
 
 int memorized_tile::get_ter_rotation() const
@@ -176,6 +219,24 @@ bool memorized_tile::operator==( const memorized_tile &rhs ) const
            dec_id == rhs.dec_id;
 }
 
+int mm_dictionary::number_of( const uint32_t id )
+{
+    const auto inserted = numbers.emplace( id, static_cast<int>( ids.size() ) );
+    if( inserted.second ) {
+        ids.push_back( id );
+    }
+    return inserted.first->second;
+}
+
+uint32_t mm_dictionary::id_of( const int number ) const
+{
+    if( number < 0 || static_cast<size_t>( number ) >= ids.size() ) {
+        debugmsg( "memory map region refers to missing id number %d", number );
+        return 0;
+    }
+    return ids[number];
+}
+
 map_memory::coord_pair::coord_pair( const tripoint_abs_ms &p )
 {
     loc = point_sm_ms( p.xy().raw() );
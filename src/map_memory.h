@@ -2,25 +2,38 @@
 #ifndef CATA_SRC_MAP_MEMORY_H
 #define CATA_SRC_MAP_MEMORY_H
 
+#include <cstdint>
 #include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "game_constants.h"
 #include "mdarray.h"
 #include "memory_fast.h"
 #include "point.h" // IWYU pragma: keep
 
+class JsonArray;
 class JsonObject;
 class JsonOut;
 class JsonValue;
 
-struct ter_t;
-using ter_str_id = string_id<ter_t>;
-
+/**
+ * Terrain and decoration ids are interned in a global table, so that a tile is a
+ * few small integers rather than holding strings of its own.
+ */
 class memorized_tile
 {
     public:
         char32_t symbol = 0;
 
+        /** Index of @p id in the table of interned ids, adding it if it's new. */
+        static uint32_t intern( std::string_view id );
+        /** The id at @p index in the table of interned ids. */
+        static const std::string &interned( uint32_t index );
+
         const std::string &get_ter_id() const;
         const std::string &get_dec_id() const;
         void set_ter_id( std::string_view id );
@@ -42,14 +55,36 @@ class memorized_tile
         }
     private:
         friend struct mm_submap; // serialization needs access to private members
-        ter_str_id ter_id;       // terrain tile id
-        std::string dec_id;      // decoration tile id (furniture, vparts ...)
+        uint32_t ter_id = 0;     // interned terrain tile id
+        uint32_t dec_id = 0;     // interned decoration tile id (furniture, vparts ...)
         int8_t ter_rotation = 0;
         int8_t dec_rotation = 0;
         int8_t ter_subtile = 0;
         int8_t dec_subtile = 0;
 };
 
+static_assert( std::is_trivially_copyable_v<memorized_tile> );
+
+/**
+ * The ids used by the memorized tiles of a region, numbered in order of first use.
+ * Saved regions refer to ids by these numbers rather than repeating the strings.
+ */
+class mm_dictionary
+{
+    public:
+        /** For saving: the number of an interned id, numbering it if it's new. */
+        int number_of( uint32_t id );
+        /** For loading: the interned id with the given number. */
+        uint32_t id_of( int number ) const;
+
+        void serialize( JsonOut &jsout ) const;
+        void deserialize( const JsonArray &ja );
+
+    private:
+        std::vector<uint32_t> ids;
+        std::unordered_map<uint32_t, int> numbers;
+};
+
 /** Represent a submap-sized chunk of tile memory. */
 struct mm_submap {
     public:
@@ -66,8 +101,9 @@ struct mm_submap {
         const memorized_tile &get_tile( const point_sm_ms &p ) const;
         void set_tile( const point_sm_ms &p, const memorized_tile &value );
 
-        void serialize( JsonOut &jsout ) const;
-        void deserialize( int version, const JsonArray &ja );
+        void serialize( JsonOut &jsout, mm_dictionary &dictionary ) const;
+        // The dictionary is only used by version 2 and later.
+        void deserialize( int version, const JsonArray &ja, const mm_dictionary &dictionary );
 
     private:
         // NOLINTNEXTLINE(cata-serialize)
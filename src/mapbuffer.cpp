@@ -1,11 +1,20 @@
 #include "mapbuffer.h"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <exception>
 #include <filesystem>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -14,13 +23,16 @@
 #include "filesystem.h"
 #include "input.h"
 #include "json.h"
+#include "json_loader.h"
 #include "map.h"
+#include "options.h"
 #include "output.h"
 #include "overmapbuffer.h"
 #include "path_info.h"
 #include "popup.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "submap_binary.h"
 #include "translations.h"
 #include "ui_manager.h"
 
@@ -45,6 +57,250 @@ static cata_path find_dirname( const tripoint_abs_omt &om_addr )
             segment_addr.y(), segment_addr.z() );
 }
 
+// Fix for old saves where the path was generated using std::stringstream, which
+// did format the number using the current locale. That formatting may insert
+// thousands separators, so the resulting path is "map/1,234.7.8.map" instead
+// of "map/1234.7.8.map".
+static cata_path find_legacy_quad_path( const cata_path &dirname,
+                                        const tripoint_abs_omt &om_addr )
+{
+    std::ostringstream buffer;
+    buffer << om_addr.x() << "." << om_addr.y() << "." << om_addr.z() << ".map";
+    return dirname / buffer.str();
+}
+
+// Inverse of find_quad_path, for the file name only.
+static std::optional<tripoint_abs_omt> quad_from_file_name( const std::string &name )
+{
+    const std::vector<std::string> parts = string_split( name, '.' );
+    if( parts.size() != 4 || parts[3] != "map" ) {
+        return std::nullopt;
+    }
+    std::array<int, 3> coords;
+    for( int i = 0; i < 3; i++ ) {
+        const std::string &part = parts[i];
+        const char *end = part.data() + part.size();
+        const std::from_chars_result r = std::from_chars( part.data(), end, coords[i] );
+        if( part.empty() || r.ptr != end ) {
+            return std::nullopt;
+        }
+    }
+    return tripoint_abs_omt( coords[0], coords[1], coords[2] );
+}
+
+/**
+ * Reads and parses quad files on a background thread.  Only the file access and
+ * the JSON parsing happen there: building the submaps looks things up in global
+ * registries that aren't safe to use from another thread, so that's left to
+ * @ref mapbuffer::unserialize_submaps on the main thread.  Binary quads are
+ * handed over as they are, decoding them is mostly such lookups.
+ */
+class mapbuffer::quad_prefetcher
+{
+    public:
+        enum class result : int {
+            // Not requested, or not read yet.  The caller has to read the file itself.
+            none,
+            // There is no file for this quad.
+            missing,
+            parsed,
+            binary
+        };
+
+
+        ~quad_prefetcher() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                shutting_down = true;
+            }
+            work_ready.notify_all();
+            if( worker.joinable() ) {
+                worker.join();
+            }
+        }
+
+        void request( const tripoint_abs_omt &om_addr, const cata_path &path,
+                      const cata_path &legacy_path ) {
+            std::lock_guard<std::mutex> lock( mutex );
+            const auto existing = requests.find( om_addr );
+            if( existing != requests.end() ) {
+                existing->second.requested = ++last_id;
+                return;
+            }
+            if( requests.size() >= max_prefetched_quads ) {
+                drop_oldest();
+            }
+            // Resolve the paths here: the save directory is global state.
+            pending &req = requests[om_addr];
+            req.id = ++last_id;
+            req.requested = req.id;
+            req.path = path.get_unrelative_path();
+            req.legacy_path = legacy_path.get_unrelative_path();
+            queue.push_back( om_addr );
+            if( !worker.joinable() ) {
+                worker = std::thread( &quad_prefetcher::worker_loop, this );
+            }
+            work_ready.notify_one();
+        }
+
+        // Forget about a quad, e.g. because it's about to be written.
+        void cancel( const tripoint_abs_omt &om_addr ) {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                requests.erase( om_addr );
+            }
+            work_done.notify_all();
+        }
+
+        void cancel_all() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                requests.clear();
+                queue.clear();
+            }
+            work_done.notify_all();
+        }
+
+        // Waits until the worker is done with a quad.  False if it was never
+        // requested or has been dropped since.
+        bool wait( const tripoint_abs_omt &om_addr ) {
+            std::unique_lock<std::mutex> lock( mutex );
+            auto iter = requests.find( om_addr );
+            if( iter == requests.end() ) {
+                return false;
+            }
+            const uint64_t id = iter->second.id;
+            work_done.wait( lock, [&]() {
+                iter = requests.find( om_addr );
+                return iter == requests.end() || iter->second.id != id || iter->second.done;
+            } );
+            return iter != requests.end() && iter->second.id == id;
+        }
+
+        // Hands over the parsed quad (or the contents of a binary one), waiting for
+        // it if the worker is reading it right now.  If the worker hasn't got to it
+        // yet, it's cheaper for the caller to read it directly.
+        result take( const tripoint_abs_omt &om_addr, std::optional<JsonValue> &json,
+                     std::string &binary ) {
+            std::unique_lock<std::mutex> lock( mutex );
+            auto iter = requests.find( om_addr );
+            if( iter == requests.end() ) {
+                return result::none;
+            }
+            if( !iter->second.started ) {
+                requests.erase( iter );
+                return result::none;
+            }
+            const uint64_t id = iter->second.id;
+            work_done.wait( lock, [&]() {
+                iter = requests.find( om_addr );
+                return iter == requests.end() || iter->second.id != id || iter->second.done;
+            } );
+            if( iter == requests.end() || iter->second.id != id ) {
+                return result::none;
+            }
+            const result ret = iter->second.outcome;
+            json = std::move( iter->second.json );
+            binary = std::move( iter->second.binary );
+            requests.erase( iter );
+            return ret;
+        }
+
+    private:
+        struct pending {
+            uint64_t id = 0;
+            // When it was last asked for, for dropping the oldest requests first.
+            uint64_t requested = 0;
+            fs::path path;
+            fs::path legacy_path;
+            bool started = false;
+            bool done = false;
+            result outcome = result::none;
+            std::optional<JsonValue> json;
+            std::string binary;
+        };
+
+        // Makes room for a new request.  Whatever was asked for longest ago is the
+        // least likely to be needed, whether it has been read already or not.
+        void drop_oldest() {
+            const auto oldest = std::min_element( requests.begin(), requests.end(),
+            []( const auto & lhs, const auto & rhs ) {
+                return lhs.second.requested < rhs.second.requested;
+            } );
+            if( oldest != requests.end() ) {
+                requests.erase( oldest );
+                work_done.notify_all();
+            }
+        }
+
+        void worker_loop() {
+            std::unique_lock<std::mutex> lock( mutex );
+            while( true ) {
+                work_ready.wait( lock, [this]() {
+                    return shutting_down || !queue.empty();
+                } );
+                if( shutting_down ) {
+                    return;
+                }
+                const tripoint_abs_omt om_addr = queue.front();
+                queue.pop_front();
+                auto iter = requests.find( om_addr );
+                if( iter == requests.end() || iter->second.started ) {
+                    continue;
+                }
+                iter->second.started = true;
+                const uint64_t id = iter->second.id;
+                const fs::path path = iter->second.path;
+                const fs::path legacy_path = iter->second.legacy_path;
+                lock.unlock();
+
+                result outcome = result::missing;
+                std::optional<JsonValue> json;
+                std::string binary;
+                try {
+                    const fs::path &existing = file_exist( path ) || !file_exist( legacy_path ) ?
+                                               path : legacy_path;
+                    if( file_exist( existing ) ) {
+                        std::optional<std::string> contents = read_whole_file( existing );
+                        if( contents && submap_binary::is_binary( *contents ) ) {
+                            binary = std::move( *contents );
+                            outcome = result::binary;
+                        } else if( contents && !contents->empty() ) {
+                            json = json_loader::from_string( *contents );
+                            outcome = result::parsed;
+                        } else {
+                            outcome = result::none;
+                        }
+                    }
+                } catch( const std::exception & ) {
+                    // Leave it to the main thread to read it again and report the error.
+                    outcome = result::none;
+                    json.reset();
+                    binary.clear();
+                }
+
+                lock.lock();
+                iter = requests.find( om_addr );
+                if( iter != requests.end() && iter->second.id == id ) {
+                    iter->second.done = true;
+                    iter->second.outcome = outcome;
+                    iter->second.json = std::move( json );
+                    iter->second.binary = std::move( binary );
+                }
+                work_done.notify_all();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable work_done;
+        std::map<tripoint_abs_omt, pending> requests;
+        std::deque<tripoint_abs_omt> queue;
+        uint64_t last_id = 0;
+        bool shutting_down = false;
+        std::thread worker;
+};
+
 mapbuffer MAPBUFFER;
 
 mapbuffer::mapbuffer() = default;
@@ -53,6 +309,9 @@ mapbuffer::~mapbuffer() = default;
 void mapbuffer::clear()
 {
     submaps.clear();
+    if( prefetcher ) {
+        prefetcher->cancel_all();
+    }
 }
 
 void mapbuffer::clear_outside_reality_bubble()
@@ -119,6 +378,52 @@ submap *mapbuffer::lookup_submap( const tripoint_abs_sm &p )
     return iter->second.get();
 }
 
+void mapbuffer::prefetch( const tripoint_abs_sm &p )
+{
+    if( submaps.count( p ) ) {
+        return;
+    }
+    const tripoint_abs_omt om_addr = project_to<coords::omt>( p );
+    const cata_path dirname = find_dirname( om_addr );
+    if( !prefetcher ) {
+        prefetcher = std::make_unique<quad_prefetcher>();
+    }
+    prefetcher->request( om_addr, find_quad_path( dirname, om_addr ),
+                         find_legacy_quad_path( dirname, om_addr ) );
+}
+
+bool mapbuffer::wait_for_prefetch( const tripoint_abs_sm &p )
+{
+    return prefetcher && prefetcher->wait( project_to<coords::omt>( p ) );
+}
+
+int mapbuffer::rewrite_saved_quads()
+{
+    int rewritten = 0;
+    const cata_path maps_dir = PATH_INFO::world_base_save_path_path() / "maps";
+    for( const cata_path &file : get_files_from_path( ".map", maps_dir, true, true ) ) {
+        // Files with legacy names (see find_legacy_quad_path) are left alone.
+        const std::optional<tripoint_abs_omt> om_addr =
+            quad_from_file_name( file.get_unrelative_path().filename().generic_u8string() );
+        if( !om_addr ) {
+            continue;
+        }
+        const tripoint_abs_sm sm_addr = project_to<coords::sm>( *om_addr );
+        if( submaps.count( sm_addr ) || lookup_submap( sm_addr ) == nullptr ) {
+            continue;
+        }
+        const cata_path dirname = find_dirname( *om_addr );
+        std::list<tripoint_abs_sm> submaps_to_delete;
+        save_quad( dirname, find_quad_path( dirname, *om_addr ), *om_addr, submaps_to_delete,
+                   true );
+        for( const tripoint_abs_sm &p : submaps_to_delete ) {
+            remove_submap( p );
+        }
+        rewritten++;
+    }
+    return rewritten;
+}
+
 void mapbuffer::save( bool delete_after_save )
 {
     assure_dir_exist( PATH_INFO::world_base_save_path() + "/maps" );
@@ -179,6 +484,11 @@ void mapbuffer::save_quad(
     const cata_path &dirname, const cata_path &filename, const tripoint_abs_omt &om_addr,
     std::list<tripoint_abs_sm> &submaps_to_delete, bool delete_after_save )
 {
+    // Anything read ahead for this quad is about to become stale.
+    if( prefetcher ) {
+        prefetcher->cancel( om_addr );
+    }
+
     std::vector<point> offsets;
     std::vector<tripoint_abs_sm> submap_addrs;
     offsets.push_back( point_zero );
@@ -220,44 +530,53 @@ void mapbuffer::save_quad(
         }
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
-        for( auto &submap_addr : submap_addrs ) {
-            if( submaps.count( submap_addr ) == 0 ) {
-                continue;
-            }
-
-            submap *sm = submaps[submap_addr].get();
+    std::vector<std::pair<tripoint_abs_sm, const submap *>> to_save;
+    for( auto &submap_addr : submap_addrs ) {
+        if( submaps.count( submap_addr ) == 0 ) {
+            continue;
+        }
 
-            if( sm == nullptr ) {
-                continue;
-            }
+        submap *sm = submaps[submap_addr].get();
 
-            jsout.start_object();
+        if( sm == nullptr ) {
+            continue;
+        }
 
-            jsout.member( "version", savegame_version );
-            jsout.member( "coordinates" );
+        to_save.emplace_back( submap_addr, sm );
+        if( delete_after_save ) {
+            submaps_to_delete.push_back( submap_addr );
+        }
+    }
 
+    // Don't create the directory if it would be empty
+    assure_dir_exist( dirname );
+    if( get_option<bool>( "BINARY_SUBMAPS" ) ) {
+        write_to_file( filename, [&]( std::ostream & fout ) {
+            submap_binary::write_quad( fout, to_save );
+        } );
+    } else {
+        write_to_file( filename, [&]( std::ostream & fout ) {
+            JsonOut jsout( fout );
             jsout.start_array();
-            jsout.write( submap_addr.x() );
-            jsout.write( submap_addr.y() );
-            jsout.write( submap_addr.z() );
-            jsout.end_array();
+            for( const std::pair<tripoint_abs_sm, const submap *> &sm : to_save ) {
+                jsout.start_object();
 
-            sm->store( jsout );
+                jsout.member( "version", savegame_version );
+                jsout.member( "coordinates" );
 
-            jsout.end_object();
+                jsout.start_array();
+                jsout.write( sm.first.x() );
+                jsout.write( sm.first.y() );
+                jsout.write( sm.first.z() );
+                jsout.end_array();
 
-            if( delete_after_save ) {
-                submaps_to_delete.push_back( submap_addr );
-            }
-        }
+                sm.second->store( jsout );
 
-        jsout.end_array();
-    } );
+                jsout.end_object();
+            }
+            jsout.end_array();
+        } );
+    }
 
     if( all_uniform && reverted_to_uniform ) {
         fs::remove( filename.get_unrelative_path() );
@@ -273,25 +592,48 @@ submap *mapbuffer::unserialize_submaps( const tripoint_abs_sm &p )
     const cata_path dirname = find_dirname( om_addr );
     cata_path quad_path = find_quad_path( dirname, om_addr );
 
-    if( !file_exist( quad_path ) ) {
-        // Fix for old saves where the path was generated using std::stringstream, which
-        // did format the number using the current locale. That formatting may insert
-        // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
-        // of "map/1234.7.8.map".
-        std::ostringstream buffer;
-        buffer << om_addr.x() << "." << om_addr.y() << "." << om_addr.z()
-               << ".map";
-        cata_path legacy_quad_path = dirname / buffer.str();
-        if( file_exist( legacy_quad_path ) ) {
-            quad_path = std::move( legacy_quad_path );
-        }
+    std::optional<JsonValue> prefetched;
+    std::string binary;
+    const quad_prefetcher::result read_ahead = prefetcher ?
+            prefetcher->take( om_addr, prefetched, binary ) : quad_prefetcher::result::none;
+    if( read_ahead != quad_prefetcher::result::none ) {
+        prefetched_quads_used++;
     }
-
-    if( !read_from_file_optional_json( quad_path, [this]( const JsonValue & jsin ) {
-    deserialize( jsin );
-    } ) ) {
+    if( read_ahead == quad_prefetcher::result::missing ) {
         // If it doesn't exist, trigger generating it.
         return nullptr;
+    } else if( read_ahead == quad_prefetcher::result::parsed ) {
+        deserialize( *prefetched );
+    } else if( read_ahead == quad_prefetcher::result::binary ) {
+        deserialize_binary( binary );
+    } else {
+        if( !file_exist( quad_path ) ) {
+            cata_path legacy_quad_path = find_legacy_quad_path( dirname, om_addr );
+            if( file_exist( legacy_quad_path ) ) {
+                quad_path = std::move( legacy_quad_path );
+            }
+        }
+        if( !file_exist( quad_path ) ) {
+            // If it doesn't exist, trigger generating it.
+            return nullptr;
+        }
+
+        // Quads may be in either format, whatever the world saves in now.
+        std::optional<std::string> contents = read_whole_file( quad_path );
+        if( !contents ) {
+            return nullptr;
+        }
+        try {
+            if( submap_binary::is_binary( *contents ) ) {
+                deserialize_binary( *contents );
+            } else {
+                deserialize( json_loader::from_string( *contents ) );
+            }
+        } catch( const std::exception &err ) {
+            debugmsg( _( "Failed to read from \"%1$s\": %2$s" ), quad_path.generic_u8string(),
+                      err.what() );
+            return nullptr;
+        }
     }
     // fill in uniform submaps that were not serialized
     oter_id const oid = overmap_buffer.ter( om_addr );
@@ -304,6 +646,15 @@ submap *mapbuffer::unserialize_submaps( const tripoint_abs_sm &p )
     return submaps[ p ].get();
 }
 
+void mapbuffer::deserialize_binary( const std::string_view data )
+{
+    for( auto &sm : submap_binary::read_quad( data ) ) {
+        if( !add_submap( sm.first, sm.second ) ) {
+            debugmsg( "submap %s was already loaded", sm.first.to_string() );
+        }
+    }
+}
+
 void mapbuffer::deserialize( const JsonArray &ja )
 {
     for( JsonObject submap_json : ja ) {
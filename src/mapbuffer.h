@@ -2,10 +2,12 @@
 #ifndef CATA_SRC_MAPBUFFER_H
 #define CATA_SRC_MAPBUFFER_H
 
+#include <cstddef>
 #include <iosfwd>
 #include <list>
 #include <map>
 #include <memory>
+#include <string_view>
 
 #include "coordinates.h"
 #include "point.h"
@@ -62,6 +64,27 @@ class mapbuffer
          */
         submap *lookup_submap( const tripoint_abs_sm &p );
 
+        /** Start reading the submap quad containing @p p from disk on a background
+         * thread, so that a later @ref lookup_submap doesn't have to wait for the
+         * disk or the JSON parser.  Does nothing if the quad is already loaded or
+         * being read.
+         */
+        void prefetch( const tripoint_abs_sm &p );
+        /** At most this many quads are read ahead, older requests are dropped first. */
+        static constexpr size_t max_prefetched_quads = 256;
+        /** Wait until the read-ahead of the quad containing @p p is done.  False if it
+         * was never requested or has been dropped since. */
+        bool wait_for_prefetch( const tripoint_abs_sm &p );
+        /** How many quads were loaded from read-ahead data, for tests. */
+        int prefetched_quads_used = 0; // NOLINT(cata-serialize)
+
+        /** Rewrite every saved quad that isn't loaded in the format the world
+         * saves in now (see the BINARY_SUBMAPS option).  Loaded quads get that
+         * format the next time they are saved anyway.
+         * @return The number of quads rewritten.
+         */
+        int rewrite_saved_quads();
+
     private:
         using submap_map_t = std::map<tripoint_abs_sm, std::unique_ptr<submap>>;
 
@@ -79,11 +102,16 @@ class mapbuffer
         void remove_submap( const tripoint_abs_sm &addr );
         submap *unserialize_submaps( const tripoint_abs_sm &p );
         void deserialize( const JsonArray &ja );
+        void deserialize_binary( std::string_view data );
         void save_quad(
             const cata_path &dirname, const cata_path &filename,
             const tripoint_abs_omt &om_addr, std::list<tripoint_abs_sm> &submaps_to_delete,
             bool delete_after_save );
         submap_map_t submaps; // NOLINT(cata-serialize)
+
+        class quad_prefetcher;
+        // Created on the first call to prefetch.
+        std::unique_ptr<quad_prefetcher> prefetcher; // NOLINT(cata-serialize)
 };
 
 extern mapbuffer MAPBUFFER;
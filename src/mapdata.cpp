@@ -777,6 +777,11 @@ size_t ter_t::count()
     return terrain_data.size();
 }
 
+generic_factory<ter_t> &get_all_ter_types()
+{
+    return terrain_data;
+}
+
 namespace io
 {
 template<>
@@ -1037,6 +1042,11 @@ size_t furn_t::count()
     return furniture_data.size();
 }
 
+generic_factory<furn_t> &get_all_furn_types()
+{
+    return furniture_data;
+}
+
 bool furn_t::is_movable() const
 {
     return move_str_req >= 0;
@@ -8,6 +8,7 @@
 #include <iosfwd>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "calendar.h"
@@ -37,6 +38,7 @@ const int NUM_TERCONN = 32;
 connect_group get_connect_group( const std::string &name );
 
 template <typename E> struct enum_traits;
+template <typename T> class generic_factory;
 
 struct map_bash_info {
     int str_min;            // min str(*) required to bash
@@ -686,6 +688,10 @@ struct furn_t : map_data_common_t {
 void load_furniture( const JsonObject &jo, const std::string &src );
 void load_terrain( const JsonObject &jo, const std::string &src );
 
+// For caches indexed by ter_id or furn_id, to notice when the types are reloaded.
+generic_factory<ter_t> &get_all_ter_types();
+generic_factory<furn_t> &get_all_furn_types();
+
 void verify_furniture();
 void verify_terrain();
 
@@ -700,6 +706,12 @@ class ter_furn_migrations
 
         /** Checks migrations */
         static void check();
+
+        /** Terrain and furniture a saved terrain id is loaded as.  The furniture is null
+         * unless the migration places some; ids without a migration are returned as is. */
+        static std::pair<ter_str_id, furn_str_id> migrate( const ter_str_id &ter );
+        /** Same for a saved furniture id; the terrain is null unless the migration changes it. */
+        static std::pair<ter_str_id, furn_str_id> migrate( const furn_str_id &furn );
 };
 
 /*
@@ -1,8 +1,11 @@
 #include "mongroup.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "assign.h"
 #include "calendar.h"
@@ -112,6 +115,134 @@ float mongroup::avg_speed() const
     return avg_speed;
 }
 
+point mongroup_map::cell_of( const mongroup &group )
+{
+    return point( divide_round_down( group.abs_pos.x(), cell_size ),
+                  divide_round_down( group.abs_pos.y(), cell_size ) );
+}
+
+void mongroup_map::place( const iterator it )
+{
+    cells[cell_of( it->second )].push_back( it );
+}
+
+void mongroup_map::unplace( const iterator it )
+{
+    using cell_iterator = std::unordered_map<point, std::vector<iterator>>::iterator;
+    const auto remove_from = [&]( const cell_iterator cell ) {
+        std::vector<iterator> &in_cell = cell->second;
+        const auto found = std::find( in_cell.begin(), in_cell.end(), it );
+        if( found == in_cell.end() ) {
+            return false;
+        }
+        *found = in_cell.back();
+        in_cell.pop_back();
+        if( in_cell.empty() ) {
+            cells.erase( cell );
+        }
+        return true;
+    };
+    const auto cell = cells.find( cell_of( it->second ) );
+    if( cell != cells.end() && remove_from( cell ) ) {
+        return;
+    }
+    // The group was moved without telling us (nemesis hordes are), look for it everywhere.
+    for( auto other = cells.begin(); other != cells.end(); ++other ) {
+        if( remove_from( other ) ) {
+            return;
+        }
+    }
+}
+
+mongroup_map::iterator mongroup_map::emplace( const tripoint_om_sm &pos, const mongroup &group )
+{
+    const iterator it = groups.emplace( pos, group );
+    place( it );
+    return it;
+}
+
+mongroup_map::iterator mongroup_map::erase( const iterator it )
+{
+    unplace( it );
+    return groups.erase( it );
+}
+
+void mongroup_map::clear()
+{
+    groups.clear();
+    cells.clear();
+}
+
+void mongroup_map::move( const std::vector<std::pair<iterator, tripoint_om_sm>> &moves )
+{
+    std::vector<container::node_type> nodes;
+    nodes.reserve( moves.size() );
+    for( const std::pair<iterator, tripoint_om_sm> &move : moves ) {
+        unplace( move.first );
+        nodes.push_back( groups.extract( move.first ) );
+        nodes.back().key() = move.second;
+    }
+    for( container::node_type &node : nodes ) {
+        place( groups.insert( std::move( node ) ) );
+    }
+}
+
+std::vector<mongroup_map::iterator> mongroup_map::near( const point_abs_sm &center,
+        const int radius )
+{
+    const auto in_range = [&]( const mongroup & group ) {
+        return std::abs( group.abs_pos.x() - center.x() ) <= radius &&
+               std::abs( group.abs_pos.y() - center.y() ) <= radius;
+    };
+    std::vector<tripoint_om_sm> keys;
+    const point min_cell( divide_round_down( center.x() - radius, cell_size ),
+                          divide_round_down( center.y() - radius, cell_size ) );
+    const point max_cell( divide_round_down( center.x() + radius, cell_size ),
+                          divide_round_down( center.y() + radius, cell_size ) );
+    // Fall back to checking every cell when the area covers more cells than there are.
+    const int64_t area = static_cast<int64_t>( max_cell.x - min_cell.x + 1 ) *
+                         ( max_cell.y - min_cell.y + 1 );
+    if( area > static_cast<int64_t>( cells.size() ) ) {
+        for( const std::pair<const point, std::vector<iterator>> &cell : cells ) {
+            if( cell.first.x >= min_cell.x && cell.first.x <= max_cell.x &&
+                cell.first.y >= min_cell.y && cell.first.y <= max_cell.y ) {
+                for( const iterator &it : cell.second ) {
+                    if( in_range( it->second ) ) {
+                        keys.push_back( it->first );
+                    }
+                }
+            }
+        }
+    } else {
+        for( int y = min_cell.y; y <= max_cell.y; y++ ) {
+            for( int x = min_cell.x; x <= max_cell.x; x++ ) {
+                const auto cell = cells.find( point( x, y ) );
+                if( cell == cells.end() ) {
+                    continue;
+                }
+                for( const iterator &it : cell->second ) {
+                    if( in_range( it->second ) ) {
+                        keys.push_back( it->first );
+                    }
+                }
+            }
+        }
+    }
+    // Walk the groups at each position found, in order, to return them in the multimap's order.
+    std::sort( keys.begin(), keys.end() );
+    keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+    std::vector<iterator> ret;
+    for( const tripoint_om_sm &key : keys ) {
+        const std::pair<iterator, iterator> range = groups.equal_range( key );
+        for( iterator it = range.first; it != range.second; ++it ) {
+            if( in_range( it->second ) ) {
+                ret.push_back( it );
+            }
+        }
+    }
+    return ret;
+}
+
 const MonsterGroup &MonsterGroupManager::GetUpgradedMonsterGroup( const mongroup_id &group )
 {
     const MonsterGroup *groupptr = &group.obj();
@@ -2,9 +2,12 @@
 #ifndef CATA_SRC_MONGROUP_H
 #define CATA_SRC_MONGROUP_H
 
+#include <cstddef>
 #include <iosfwd>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "calendar.h"
@@ -193,6 +196,78 @@ struct enum_traits<mongroup::horde_behaviour> {
     static constexpr mongroup::horde_behaviour last = mongroup::horde_behaviour::last;
 };
 
+/**
+ * The monster groups of an overmap, keyed by their position in it (@ref mongroup::rel_pos).
+ *
+ * Groups are kept in a multimap, so iterators to a group stay valid until it is erased, whatever
+ * happens to the others.  Alongside is a coarse grid of the groups by their absolute position,
+ * for finding those near a point without looking at all of them.  The grid only knows the
+ * positions the groups had when they were added or last moved through @ref move.
+ */
+class mongroup_map
+{
+    public:
+        using container = std::multimap<tripoint_om_sm, mongroup>;
+        using iterator = container::iterator;
+        using const_iterator = container::const_iterator;
+        using value_type = container::value_type;
+
+        iterator begin() {
+            return groups.begin();
+        }
+        iterator end() {
+            return groups.end();
+        }
+        const_iterator begin() const {
+            return groups.begin();
+        }
+        const_iterator end() const {
+            return groups.end();
+        }
+        size_t size() const {
+            return groups.size();
+        }
+        bool empty() const {
+            return groups.empty();
+        }
+        std::pair<iterator, iterator> equal_range( const tripoint_om_sm &pos ) {
+            return groups.equal_range( pos );
+        }
+        std::pair<const_iterator, const_iterator> equal_range( const tripoint_om_sm &pos ) const {
+            return groups.equal_range( pos );
+        }
+
+        iterator emplace( const tripoint_om_sm &pos, const mongroup &group );
+        /** Erases the group at @p it and returns the one after it. */
+        iterator erase( iterator it );
+        void clear();
+
+        /**
+         * Gives each group its new position, all at once, so that groups moved while iterating
+         * are not visited again.  The groups are not copied: pointers and references to them stay
+         * valid, but iterators to them do not.  Groups with the same new position end up after
+         * those already there, in the order given.
+         */
+        void move( const std::vector<std::pair<iterator, tripoint_om_sm>> &moves );
+
+        /**
+         * Returns the groups whose absolute position is at most @p radius submaps away from
+         * @p center on both horizontal axes, on any z-level, in the same order as iterating over
+         * all groups would visit them.
+         */
+        std::vector<iterator> near( const point_abs_sm &center, int radius );
+
+    private:
+        // Width of a grid cell in submaps.
+        static constexpr int cell_size = 16;
+        static point cell_of( const mongroup &group );
+        void place( iterator it );
+        void unplace( iterator it );
+
+        container groups;
+        std::unordered_map<point, std::vector<iterator>> cells;
+};
+
 class MonsterGroupManager
 {
     public:
@@ -141,7 +141,7 @@ bool monster::monster_move_in_vehicle( const tripoint &p ) const
         vehicle &veh = vp->vehicle();
         units::volume capacity = 0_ml;
         units::volume free_cargo = 0_ml;
-        auto cargo_parts = veh.get_parts_at( p, "CARGO", part_status_flag::any );
+        auto cargo_parts = veh.get_parts_at( p, VPFLAG_CARGO, part_status_flag::any );
         for( vehicle_part *&part : cargo_parts ) {
             vehicle_stack contents = veh.get_items( *part );
             if( !vp.part_with_feature( "CARGO_PASSABLE", false ) &&
@@ -1078,7 +1078,8 @@ void monster::move()
                 ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != local_dest ) ) {
                 // We need a new path
                 if( can_pathfind() ) {
-                    path = here.route( pos(), local_dest, pf_settings, get_path_avoid() );
+                    path = here.route_to_shared_target( pos(), local_dest, pf_settings,
+                                                        get_path_avoid() );
                     if( path.empty() ) {
                         increment_pathfinding_cd();
                     }
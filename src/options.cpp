@@ -2824,6 +2824,13 @@ void options_manager::add_options_world_default()
              "a reasonable pace." ),
          true
        );
+
+    add_empty_line();
+
+    add( "BINARY_SUBMAPS", "world_default", to_translation( "Binary map saves" ),
+         to_translation( "If true, the map is saved in a compact binary format that is smaller and faster to load than JSON.  Maps saved in either format can be loaded regardless of this setting." ),
+         false
+       );
 }
 
 void options_manager::add_options_debug()
@@ -2896,6 +2903,26 @@ void options_manager::add_options_debug()
          0, OVERMAP_LAYERS, 4
        );
 
+    add( "PARALLEL_MAP_CACHE", "debug", to_translation( "Parallel map cache rebuild" ),
+         to_translation( "If true, the per-z-level map caches (outside, transparency and floor) are rebuilt on a pool of worker threads.  Only useful with 3D vision on machines with several cores." ),
+         false
+       );
+
+    add( "HIERARCHICAL_PATHFINDING", "debug", to_translation( "Hierarchical pathfinding" ),
+         to_translation( "If true, long routes are first planned over a coarse graph of submap-sized clusters, then refined piece by piece with the regular pathfinder.  Much faster for long routes, but the routes may be slightly longer and avoid doors and rough terrain where possible." ),
+         false
+       );
+
+    add( "HORDE_FLOW_FIELDS", "debug", to_translation( "Shared monster routes" ),
+         to_translation( "If true, monsters chasing the same target share one map of the shortest routes to it each turn instead of each searching for their own.  Much faster for large hordes.  Shared routes weigh doors, bashing and traps the same way individual ones do.  Routes to a target on another z-level are still searched for individually." ),
+         false
+       );
+
+    add( "PARALLEL_FIELDS", "debug", to_translation( "Parallel gas spreading" ),
+         to_translation( "If true, where smoke and other gases spread each turn is decided for all submaps at once on a pool of worker threads, from the map as it was at the start of the turn, instead of one tile at a time.  Speeds up large gas clouds.  The gas is still moved, and fire and other fields are still processed, one tile at a time, so gas only spreads a little differently." ),
+         false
+       );
+
     add_empty_line();
 
     add_option_group( "debug", Group( "occlusion_opts", to_translation( "Occlusion Options" ),
@@ -4083,6 +4110,10 @@ void options_manager::update_options_cache()
     message_ttl = ::get_option<int>( "MESSAGE_TTL" );
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d_z_range = ::get_option<int>( "FOV_3D_Z_RANGE" );
+    parallel_map_cache = ::get_option<bool>( "PARALLEL_MAP_CACHE" );
+    hierarchical_pathfinding = ::get_option<bool>( "HIERARCHICAL_PATHFINDING" );
+    horde_flow_fields = ::get_option<bool>( "HORDE_FLOW_FIELDS" );
+    parallel_fields = ::get_option<bool>( "PARALLEL_FIELDS" );
     keycode_mode = ::get_option<std::string>( "SDL_KEYBOARD_MODE" ) == "keycode";
     use_pinyin_search = ::get_option<bool>( "USE_PINYIN_SEARCH" );
 
@@ -4032,14 +4032,13 @@ void mongroup::wander( const overmap &om )
 
 void overmap::move_hordes()
 {
-    // Prevent hordes to be moved twice by putting them in here after moving.
-    decltype( zg ) tmpzg;
+    // Prevent hordes to be moved twice by only moving them once all have been visited.
+    std::vector<std::pair<mongroup_map::iterator, tripoint_om_sm>> moves;
     //MOVE ZOMBIE GROUPS
-    for( auto it = zg.begin(); it != zg.end(); ) {
+    for( auto it = zg.begin(); it != zg.end(); ++it ) {
         mongroup &mg = it->second;
         if( !mg.horde || mg.behaviour == mongroup::horde_behaviour::nemesis ) {
             //nemesis hordes have their own move function
-            ++it;
             continue;
         }
 
@@ -4089,15 +4088,10 @@ void overmap::move_hordes()
                 mg.abs_pos.y()++;
             }
 
-            // Erase the group at it's old location, add the group with the new location
-            tmpzg.emplace( mg.rel_pos(), mg );
-            zg.erase( it++ );
-        } else {
-            ++it;
+            moves.emplace_back( it, mg.rel_pos() );
         }
     }
-    // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
+    zg.move( moves );
 
     if( get_option<bool>( "WANDER_SPAWNS" ) ) {
 
@@ -4183,10 +4177,9 @@ void overmap::move_hordes()
 
 void overmap::move_nemesis()
 {
-    // Prevent hordes to be moved twice by putting them in here after moving.
-    decltype( zg ) tmpzg;
+    std::vector<std::pair<mongroup_map::iterator, tripoint_om_sm>> moves;
     //cycle through zombie groups, skip non-nemesis hordes
-    for( std::multimap<tripoint_om_sm, mongroup>::iterator it = zg.begin(); it != zg.end(); ) {
+    for( mongroup_map::iterator it = zg.begin(); it != zg.end(); ) {
         mongroup &mg = it->second;
         if( !mg.horde || mg.behaviour != mongroup::horde_behaviour::nemesis ) {
             ++it;
@@ -4232,9 +4225,7 @@ void overmap::move_nemesis()
             //update the horde's om_sm coords from the abs_sm so it can spawn in correctly
             if( project_to<coords::om>( mg.nemesis_target ) == omp ) {
 
-                // Erase the group at its old location, add the group with the new location
-                tmpzg.emplace( mg.rel_pos(), mg );
-                zg.erase( it++ );
+                moves.emplace_back( it, mg.rel_pos() );
 
                 //there is only one nemesis horde, so we can stop looping after we move it
                 break;
@@ -4249,15 +4240,13 @@ void overmap::move_nemesis()
             break;
         }
     }
-    // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
-
+    zg.move( moves );
 }
 
 bool overmap::remove_nemesis()
 {
     //cycle through zombie groups, find nemesis horde
-    for( std::multimap<tripoint_om_sm, mongroup>::iterator it = zg.begin(); it != zg.end(); ) {
+    for( mongroup_map::iterator it = zg.begin(); it != zg.end(); ) {
         mongroup &mg = it->second;
         if( mg.behaviour == mongroup::horde_behaviour::nemesis ) {
             zg.erase( it++ );
@@ -4276,8 +4265,8 @@ void overmap::signal_hordes( const tripoint_rel_sm &p_rel, const int sig_power )
 {
     tripoint_om_sm p( p_rel.raw() );
     tripoint_abs_sm absp = project_combine( pos(), p );
-    for( auto &elem : zg ) {
-        mongroup &mg = elem.second;
+    for( const mongroup_map::iterator &elem : zg.near( absp.xy(), sig_power ) ) {
+        mongroup &mg = elem->second;
         if( !mg.horde ) {
             continue;
         }
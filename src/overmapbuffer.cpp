@@ -148,8 +148,7 @@ void overmapbuffer::fix_mongroups( overmap &new_overmap )
 
 void overmapbuffer::fix_nemesis( overmap &new_overmap )
 {
-    for( std::multimap<tripoint_om_sm, mongroup>::iterator it = new_overmap.zg.begin();
-         it != new_overmap.zg.end(); ) {
+    for( mongroup_map::iterator it = new_overmap.zg.begin(); it != new_overmap.zg.end(); ) {
         mongroup &mg = it->second;
 
         //if it's not the nemesis, continue
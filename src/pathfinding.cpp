@@ -2,15 +2,19 @@
 
 #include <algorithm>
 #include <array>
+#include <bitset>
 #include <cstdlib>
 #include <iterator>
 #include <memory>
 #include <optional>
 #include <queue>
 #include <set>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "cached_options.h"
+#include "calendar.h"
 #include "cata_utility.h"
 #include "coordinates.h"
 #include "debug.h"
@@ -115,6 +119,360 @@ struct pathfinder {
 
 static pathfinder pf;
 
+// Tiles map::route walks over without looking at them any closer.
+static bool is_plain_tile( const pf_special special )
+{
+    constexpr pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
+    return !( special & non_normal );
+}
+
+// Cost map::route assigns to a step between neighbouring plain tiles.
+static int plain_step_cost( const point &from, const point &to )
+{
+    return from.x != to.x && from.y != to.y ? 3 : 2;
+}
+
+// Lower bound on the cost of a route between two points over plain tiles.
+static int plain_route_estimate( const point &from, const point &to )
+{
+    const point d = ( from - to ).abs();
+    return 2 * std::max( d.x, d.y ) + std::min( d.x, d.y );
+}
+
+using cluster_costs = std::array<int, SEEX * SEEY>;
+
+// Costs of the cheapest routes from `from` to every tile of the cluster at `origin`,
+// staying inside the cluster and on plain tiles (`from` itself may be anything).
+// Unreachable tiles get -1.
+static void costs_within_cluster( const cata::mdarray<pf_special, point_bub_ms> &special,
+                                  const point &origin, const point &from, cluster_costs &costs )
+{
+    const auto local_index = [&origin]( const point & p ) {
+        return ( p.x - origin.x ) * SEEY + p.y - origin.y;
+    };
+    costs.fill( -1 );
+    using queue_entry = std::pair<int, point>;
+    std::priority_queue<queue_entry, std::vector<queue_entry>, pair_greater_cmp_first> open;
+    costs[local_index( from )] = 0;
+    open.emplace( 0, from );
+    while( !open.empty() ) {
+        const std::pair<int, point> cur = open.top();
+        open.pop();
+        if( cur.first > costs[local_index( cur.second )] ) {
+            continue;
+        }
+        for( const tripoint &d : eight_horizontal_neighbors ) {
+            const point next = cur.second + d.xy();
+            if( next.x < origin.x || next.x >= origin.x + SEEX ||
+                next.y < origin.y || next.y >= origin.y + SEEY ||
+                !is_plain_tile( special[next.x][next.y] ) ) {
+                continue;
+            }
+            const int cost = cur.first + plain_step_cost( cur.second, next );
+            int &known = costs[local_index( next )];
+            if( known < 0 || cost < known ) {
+                known = cost;
+                open.emplace( cost, next );
+            }
+        }
+    }
+}
+
+void pathfinding_cache::mark_dirty( const point &p )
+{
+    dirty_points.set( p.x * MAPSIZE_Y + p.y );
+    const point sm( p.x / SEEX, p.y / SEEY );
+    const int sm_index = sm.x * MAPSIZE + sm.y;
+    if( !dirty_submaps[sm_index] ) {
+        dirty_submaps.set( sm_index );
+        dirty_submap_list.push_back( sm );
+    }
+}
+
+void pathfinding_cache::clear_dirty_points()
+{
+    if( !dirty_submap_list.empty() ) {
+        dirty_points.reset();
+        dirty_submaps.reset();
+        dirty_submap_list.clear();
+    }
+}
+
+pathfinding_hierarchy::pathfinding_hierarchy()
+{
+    dirty_clusters.set();
+}
+
+void pathfinding_hierarchy::invalidate()
+{
+    dirty_clusters.set();
+}
+
+void pathfinding_hierarchy::invalidate( const point &p )
+{
+    if( p.x >= 0 && p.y >= 0 && p.x < clusters_per_side * cluster_size &&
+        p.y < clusters_per_side * cluster_size ) {
+        dirty_clusters.set( p.x / cluster_size * clusters_per_side + p.y / cluster_size );
+    }
+}
+
+void pathfinding_hierarchy::build_border( const cata::mdarray<pf_special, point_bub_ms> &special,
+        const int border )
+{
+    const bool east = border < num_clusters;
+    const int index = east ? border : border - num_clusters;
+    const point origin( index / clusters_per_side * cluster_size,
+                        index % clusters_per_side * cluster_size );
+    // Tiles on this side of the border, and the step across it.
+    const point first = east ? origin + point( cluster_size - 1, 0 ) :
+                        origin + point( 0, cluster_size - 1 );
+    const point along = east ? point_south : point_east;
+    const point across = east ? point_east : point_south;
+
+    std::vector<int> &entrances = borders[border];
+    entrances.clear();
+    int run_start = -1;
+    for( int i = 0; i <= cluster_size; i++ ) {
+        const point p = first + along * i;
+        const bool open = i < cluster_size && is_plain_tile( special[p.x][p.y] ) &&
+                          is_plain_tile( special[p.x + across.x][p.y + across.y] );
+        if( open && run_start < 0 ) {
+            run_start = i;
+        } else if( !open && run_start >= 0 ) {
+            // Long openings get an entrance at both ends, short ones in the middle.
+            const int run_end = i - 1;
+            if( run_end - run_start + 1 >= 6 ) {
+                entrances.push_back( run_start );
+                entrances.push_back( run_end );
+            } else {
+                entrances.push_back( ( run_start + run_end ) / 2 );
+            }
+            run_start = -1;
+        }
+    }
+}
+
+void pathfinding_hierarchy::build_cluster( const cata::mdarray<pf_special, point_bub_ms> &special,
+        const int index )
+{
+    cluster &c = clusters[index];
+    const int cx = index / clusters_per_side;
+    const int cy = index % clusters_per_side;
+    const point origin( cx * cluster_size, cy * cluster_size );
+
+    c.portals.clear();
+    const auto add_portals = [&]( const int side, const int border, const point & first,
+    const point & along ) {
+        c.border_start[side] = c.portals.size();
+        if( border < 0 ) {
+            return;
+        }
+        for( const int offset : borders[border] ) {
+            c.portals.push_back( first + along * offset );
+        }
+    };
+    add_portals( 0, cx > 0 ? index - clusters_per_side : -1, origin, point_south );
+    add_portals( 1, cx < clusters_per_side - 1 ? index : -1,
+                 origin + point( cluster_size - 1, 0 ), point_south );
+    add_portals( 2, cy > 0 ? num_clusters + index - 1 : -1, origin, point_east );
+    add_portals( 3, cy < clusters_per_side - 1 ? num_clusters + index : -1,
+                 origin + point( 0, cluster_size - 1 ), point_east );
+
+    const size_t n = c.portals.size();
+    c.costs.assign( n * n, -1 );
+    cluster_costs costs;
+    for( size_t i = 0; i < n; i++ ) {
+        costs_within_cluster( special, origin, c.portals[i], costs );
+        for( size_t j = 0; j < n; j++ ) {
+            const point &to = c.portals[j] - origin;
+            c.costs[i * n + j] = costs[to.x * SEEY + to.y];
+        }
+    }
+}
+
+void pathfinding_hierarchy::update( const cata::mdarray<pf_special, point_bub_ms> &special )
+{
+    if( dirty_clusters.none() ) {
+        return;
+    }
+    // A changed tile can move the entrances on any border of its cluster, which
+    // changes the portals of the neighbouring clusters too.
+    std::bitset<num_clusters> rebuild;
+    for( int index = 0; index < num_clusters; index++ ) {
+        if( !dirty_clusters[index] ) {
+            continue;
+        }
+        const int cx = index / clusters_per_side;
+        const int cy = index % clusters_per_side;
+        rebuild.set( index );
+        if( cx > 0 ) {
+            build_border( special, index - clusters_per_side );
+            rebuild.set( index - clusters_per_side );
+        }
+        if( cx < clusters_per_side - 1 ) {
+            build_border( special, index );
+            rebuild.set( index + clusters_per_side );
+        }
+        if( cy > 0 ) {
+            build_border( special, num_clusters + index - 1 );
+            rebuild.set( index - 1 );
+        }
+        if( cy < clusters_per_side - 1 ) {
+            build_border( special, num_clusters + index );
+            rebuild.set( index + 1 );
+        }
+    }
+    for( int index = 0; index < num_clusters; index++ ) {
+        if( rebuild[index] ) {
+            build_cluster( special, index );
+        }
+    }
+    dirty_clusters.reset();
+
+    node_clusters.clear();
+    for( int index = 0; index < num_clusters; index++ ) {
+        clusters[index].first_node = node_clusters.size();
+        node_clusters.insert( node_clusters.end(), clusters[index].portals.size(), index );
+    }
+}
+
+std::vector<point> pathfinding_hierarchy::find_waypoints(
+    const cata::mdarray<pf_special, point_bub_ms> &special, const point &f, const point &t,
+    int &cost )
+{
+    const int side = clusters_per_side * cluster_size;
+    if( f.x < 0 || f.y < 0 || f.x >= side || f.y >= side ||
+        t.x < 0 || t.y < 0 || t.x >= side || t.y >= side ) {
+        return {};
+    }
+    update( special );
+
+    const auto cluster_of = []( const point & p ) {
+        return p.x / cluster_size * clusters_per_side + p.y / cluster_size;
+    };
+    const auto origin_of = []( const int index ) {
+        return point( index / clusters_per_side * cluster_size,
+                      index % clusters_per_side * cluster_size );
+    };
+    const int f_cluster = cluster_of( f );
+    const int t_cluster = cluster_of( t );
+    cluster_costs from_f;
+    cluster_costs from_t;
+    costs_within_cluster( special, origin_of( f_cluster ), f, from_f );
+    costs_within_cluster( special, origin_of( t_cluster ), t, from_t );
+    const auto cost_in_cluster = []( const cluster_costs & costs, const point & origin,
+    const point & p ) {
+        const point local = p - origin;
+        return costs[local.x * SEEY + local.y];
+    };
+
+    // Portals are nodes [0, num_nodes), followed by the start and the goal.
+    const int num_nodes = node_clusters.size();
+    const int start = num_nodes;
+    const int goal = num_nodes + 1;
+    const auto node_point = [&]( const int node ) {
+        if( node == start ) {
+            return f;
+        } else if( node == goal ) {
+            return t;
+        }
+        const cluster &c = clusters[node_clusters[node]];
+        return c.portals[node - c.first_node];
+    };
+
+    std::vector<int> gscore( num_nodes + 2, -1 );
+    std::vector<int> parent( num_nodes + 2, -1 );
+    std::vector<bool> closed( num_nodes + 2, false );
+    using queue_entry = std::pair<int, int>;
+    std::priority_queue<queue_entry, std::vector<queue_entry>, pair_greater_cmp_first> open;
+    const auto relax = [&]( const int from, const int to, const int step_cost ) {
+        const int g = gscore[from] + step_cost;
+        if( closed[to] || ( gscore[to] >= 0 && gscore[to] <= g ) ) {
+            return;
+        }
+        gscore[to] = g;
+        parent[to] = from;
+        open.emplace( g + plain_route_estimate( node_point( to ), t ), to );
+    };
+
+    gscore[start] = 0;
+    open.emplace( plain_route_estimate( f, t ), start );
+    while( !open.empty() ) {
+        const int node = open.top().second;
+        open.pop();
+        if( closed[node] ) {
+            continue;
+        }
+        closed[node] = true;
+        if( node == goal ) {
+            break;
+        }
+
+        if( node == start ) {
+            const cluster &c = clusters[f_cluster];
+            const point origin = origin_of( f_cluster );
+            for( size_t i = 0; i < c.portals.size(); i++ ) {
+                const int to_portal = cost_in_cluster( from_f, origin, c.portals[i] );
+                if( to_portal >= 0 ) {
+                    relax( start, c.first_node + i, to_portal );
+                }
+            }
+            const int to_goal = f_cluster == t_cluster ? cost_in_cluster( from_f, origin, t ) : -1;
+            if( to_goal >= 0 ) {
+                relax( start, goal, to_goal );
+            }
+            continue;
+        }
+
+        const int index = node_clusters[node];
+        const cluster &c = clusters[index];
+        const size_t local = node - c.first_node;
+        const size_t n = c.portals.size();
+        for( size_t j = 0; j < n; j++ ) {
+            if( j != local && c.costs[local * n + j] >= 0 ) {
+                relax( node, c.first_node + j, c.costs[local * n + j] );
+            }
+        }
+        if( index == t_cluster ) {
+            // Costs over plain tiles are the same in both directions.
+            const int to_goal = cost_in_cluster( from_t, origin_of( t_cluster ), c.portals[local] );
+            if( to_goal >= 0 ) {
+                relax( node, goal, to_goal );
+            }
+        }
+
+        // Step across the border to the matching portal of the neighbour.
+        int border_side = 0;
+        while( border_side < 3 &&
+               local >= static_cast<size_t>( c.border_start[border_side + 1] ) ) {
+            border_side++;
+        }
+        const int offset = local - c.border_start[border_side];
+        static constexpr std::array<int, 4> opposite_side = {{ 1, 0, 3, 2 }};
+        const std::array<int, 4> neighbour = {{
+                index - clusters_per_side, index + clusters_per_side, index - 1, index + 1
+            }
+        };
+        const cluster &other = clusters[neighbour[border_side]];
+        relax( node, other.first_node + other.border_start[opposite_side[border_side]] + offset,
+               2 );
+    }
+
+    if( !closed[goal] ) {
+        return {};
+    }
+    cost = gscore[goal];
+    std::vector<point> waypoints;
+    for( int node = goal; node >= 0; node = parent[node] ) {
+        const point p = node_point( node );
+        if( waypoints.empty() || waypoints.back() != p ) {
+            waypoints.push_back( p );
+        }
+    }
+    std::reverse( waypoints.begin(), waypoints.end() );
+    return waypoints;
+}
+
 // Modifies `t` to point to a tile with `flag` in a 1-submap radius of `t`'s original value,
 // searching nearest points first (starting with `t` itself).
 // return false if it could not find a suitable point
@@ -225,6 +583,33 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         return ret;
     }
 
+    // Plan long routes on the coarse graph, then refine each piece of that plan below.
+    // If that fails, e.g. because the route has to go through a door, search the
+    // whole route exactly after all.
+    if( hierarchical_pathfinding && f.z == t.z && getmapsize() == MAPSIZE &&
+        rl_dist( f, t ) >= pathfinding_hierarchy::min_route_distance ) {
+        const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( f.z );
+        int cost = 0;
+        const std::vector<point> waypoints = get_pathfinding_cache( f.z ).hierarchy.find_waypoints(
+                pf_cache.special, f.xy(), t.xy(), cost );
+        bool refined = !waypoints.empty() && cost <= settings.max_length;
+        for( size_t i = 1; refined && i < waypoints.size(); i++ ) {
+            const tripoint from( waypoints[i - 1], f.z );
+            const tripoint to( waypoints[i], f.z );
+            if( to != t && pre_closed.count( to ) ) {
+                refined = false;
+                break;
+            }
+            const std::vector<tripoint> leg = route( from, to, settings, pre_closed );
+            refined = !leg.empty();
+            ret.insert( ret.end(), leg.begin(), leg.end() );
+        }
+        if( refined ) {
+            return ret;
+        }
+        ret.clear();
+    }
+
     const int max_length = settings.max_length;
     const int bash = settings.bash_strength;
     const int climb_cost = settings.climb_cost;
@@ -562,3 +947,198 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f, const tripoin
     } );
     return result;
 }
+
+bool flow_field::same_costs( const pathfinding_settings &a, const pathfinding_settings &b )
+{
+    return a.bash_strength == b.bash_strength && a.climb_cost == b.climb_cost &&
+           a.allow_open_doors == b.allow_open_doors &&
+           a.allow_unlock_doors == b.allow_unlock_doors && a.avoid_traps == b.avoid_traps &&
+           a.avoid_rough_terrain == b.avoid_rough_terrain && a.avoid_sharp == b.avoid_sharp;
+}
+
+void map::build_flow_field( flow_field &field, const int zlev ) const
+{
+    const pathfinding_settings &settings = field.settings;
+    const int bash = settings.bash_strength;
+    const int climb_cost = settings.climb_cost;
+    const bool doors = settings.allow_open_doors;
+    const bool locks = settings.allow_unlock_doors;
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( zlev );
+    constexpr pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
+    // Cost of stepping from cur onto p, without the diagonal penalty, worked out the
+    // same way as in route, or -1 if route would never step there from cur.
+    const auto step_cost = [&]( const tripoint & cur, const tripoint & p ) {
+        const pf_special p_special = pf_cache.special[p.x][p.y];
+        if( !( p_special & non_normal ) ) {
+            return 2;
+        }
+        if( settings.avoid_rough_terrain || ( settings.avoid_sharp && p_special & PF_SHARP ) ) {
+            return -1;
+        }
+        int part = -1;
+        const const_maptile &tile = maptile_at_internal( p );
+        const ter_t &terrain = tile.get_ter_t();
+        const furn_t &furniture = tile.get_furn_t();
+        const vehicle *veh = veh_at_internal( p, part );
+        const int cost = move_cost_internal( furniture, terrain, tile.get_field(), veh, part );
+        const int rating = ( bash == 0 || cost != 0 ) ? -1 :
+                           bash_rating_internal( bash, furniture, terrain, false, veh, part );
+        if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) &&
+            veh == nullptr && climb_cost <= 0 ) {
+            return -1;
+        }
+        int total = cost;
+        if( cost == 0 ) {
+            if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
+                total += climb_cost;
+            } else if( doors && ( terrain.open || furniture.open ) &&
+                       ( ( !terrain.has_flag( ter_furn_flag::TFLAG_OPENCLOSE_INSIDE ) &&
+                           !furniture.has_flag( ter_furn_flag::TFLAG_OPENCLOSE_INSIDE ) ) ||
+                         !is_outside( cur ) ) ) {
+                total += 4;
+            } else if( veh != nullptr ) {
+                const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ),
+                                                    part ).obstacle_at_part();
+                part = vpobst ? vpobst->part_index() : -1;
+                int dummy = -1;
+                const bool is_outside_veh = veh_at_internal( cur, dummy ) != veh;
+                if( doors && part != -1 && veh->next_part_to_open( part, is_outside_veh ) != -1 ) {
+                    total += 10;
+                } else if( locks && veh->next_part_to_unlock( part, is_outside_veh ) != -1 ) {
+                    total += 12;
+                } else if( part >= 0 && bash > 0 ) {
+                    int hp = veh->part( part ).hp();
+                    if( hp / 20 > bash ) {
+                        return -1;
+                    } else if( hp / 10 > bash ) {
+                        hp *= 2;
+                    }
+                    total += 2 * hp / bash + 8 + 4;
+                } else if( part >= 0 ) {
+                    return -1;
+                }
+            } else if( rating > 1 ) {
+                total += ( 20 / rating ) + 2 + 10;
+            } else if( rating == 1 ) {
+                total += 500;
+            } else {
+                return -1;
+            }
+        }
+        if( settings.avoid_traps && p_special & PF_TRAP ) {
+            const trap &ter_trp = terrain.trap.obj();
+            const trap &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+            if( !trp.is_benign() ) {
+                if( !terrain.has_flag( ter_furn_flag::TFLAG_NO_FLOOR ) ) {
+                    total += 500;
+                } else if( valid_move( p, tripoint( p.xy(), p.z - 1 ), false, true ) ) {
+                    // route drops to the level below here, which a field can't follow
+                    return -1;
+                }
+            }
+        }
+        return total;
+    };
+
+    field.distance.fill( -1 );
+    field.next_step.fill( -1 );
+    const int size = getmapsize() * SEEX;
+    using queue_entry = std::pair<int, point>;
+    std::priority_queue<queue_entry, std::vector<queue_entry>, pair_greater_cmp_first> open;
+    field.distance[field.target.x][field.target.y] = 0;
+    open.emplace( 0, field.target );
+    while( !open.empty() ) {
+        const queue_entry cur = open.top();
+        open.pop();
+        if( cur.first > field.distance[cur.second.x][cur.second.y] ) {
+            continue;
+        }
+        const tripoint to( cur.second, zlev );
+        // Search backwards: find the tiles from which cur is the next step.
+        for( size_t i = 0; i < eight_horizontal_neighbors.size(); i++ ) {
+            const point &d = eight_horizontal_neighbors[i].xy();
+            const point prev = cur.second - d;
+            if( prev.x < 0 || prev.y < 0 || prev.x >= size || prev.y >= size ) {
+                continue;
+            }
+            const int cost = step_cost( tripoint( prev, zlev ), to );
+            if( cost < 0 ) {
+                continue;
+            }
+            const int distance = cur.first + cost + ( d.x != 0 && d.y != 0 ? 1 : 0 );
+            int &known = field.distance[prev.x][prev.y];
+            if( known < 0 || distance < known ) {
+                known = distance;
+                field.next_step[prev.x][prev.y] = i;
+                open.emplace( distance, prev );
+            }
+        }
+    }
+    field.built = true;
+}
+
+std::vector<tripoint> map::route_to_shared_target( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings,
+        const std::unordered_set<tripoint> &pre_closed ) const
+{
+    if( !horde_flow_fields || f == t || f.z != t.z || !inbounds( f ) || !inbounds( t ) ||
+        rl_dist( f, t ) > settings.max_dist ) {
+        return route( f, t, settings, pre_closed );
+    }
+
+    // Like route, take a clear straight line when there is one.
+    std::vector<tripoint> line_path = straight_route( f, t );
+    const auto is_closed = [&pre_closed]( const tripoint & p ) {
+        return pre_closed.count( p ) > 0;
+    };
+    if( !line_path.empty() && std::none_of( line_path.begin(), line_path.end(), is_closed ) ) {
+        return line_path;
+    }
+
+    // Updating the pathfinding cache drops fields that went stale within this turn.
+    get_pathfinding_cache_ref( t.z );
+    pathfinding_cache &cache = get_pathfinding_cache( t.z );
+    if( cache.flow_fields_turn != calendar::turn ) {
+        cache.flow_fields.clear();
+        cache.flow_fields_turn = calendar::turn;
+    }
+
+    auto iter = std::find_if( cache.flow_fields.begin(), cache.flow_fields.end(),
+    [&]( const std::unique_ptr<flow_field> &field ) {
+        return field->target == t.xy() && flow_field::same_costs( field->settings, settings );
+    } );
+    if( iter == cache.flow_fields.end() ) {
+        if( cache.flow_fields.size() >= flow_field::max_fields ) {
+            return route( f, t, settings, pre_closed );
+        }
+        cache.flow_fields.push_back( std::make_unique<flow_field>() );
+        cache.flow_fields.back()->target = t.xy();
+        cache.flow_fields.back()->settings = settings;
+        iter = std::prev( cache.flow_fields.end() );
+    }
+    flow_field &field = **iter;
+    if( !field.built ) {
+        // A single route is cheaper with A*.
+        if( ++field.requests < flow_field::min_requests ) {
+            return route( f, t, settings, pre_closed );
+        }
+        build_flow_field( field, t.z );
+    }
+
+    const int distance = field.distance[f.x][f.y];
+    if( distance < 0 || distance > settings.max_length ) {
+        // There may still be a route through doors or obstacles.
+        return route( f, t, settings, pre_closed );
+    }
+    std::vector<tripoint> ret;
+    ret.reserve( distance / 2 );
+    tripoint cur = f;
+    while( cur != t ) {
+        cur += eight_horizontal_neighbors[field.next_step[cur.x][cur.y]];
+        if( cur != t && pre_closed.count( cur ) ) {
+            return route( f, t, settings, pre_closed );
+        }
+        ret.push_back( cur );
+    }
+    return ret;
+}
@@ -2,9 +2,17 @@
 #ifndef CATA_SRC_PATHFINDING_H
 #define CATA_SRC_PATHFINDING_H
 
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "calendar.h"
 #include "coordinates.h"
 #include "game_constants.h"
 #include "mdarray.h"
+#include "point.h"
 
 enum pf_special : int {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -40,13 +48,66 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
-struct pathfinding_cache {
-    pathfinding_cache();
-
-    bool dirty = false;
-    std::unordered_set<point> dirty_points;
-
-    cata::mdarray<pf_special, point_bub_ms> special;
+/**
+ * Coarse graph of one z-level used to plan long routes (HPA*).
+ *
+ * The level is split into submap-sized clusters.  Wherever plain tiles line up
+ * on both sides of the border between two clusters there is an entrance, and
+ * the entrance tiles of each cluster are connected by the cost of the shortest
+ * path between them inside the cluster.  Only tiles without any of the flags
+ * that make @ref map::route look closer are used, so the costs don't depend on
+ * the pathfinding settings and the graph can be shared by every route.
+ *
+ * Clusters are rebuilt lazily after the tiles in or next to them change.
+ */
+class pathfinding_hierarchy
+{
+    public:
+        // Routes shorter than this are planned with plain A*.
+        static constexpr int min_route_distance = 2 * SEEX;
+
+        pathfinding_hierarchy();
+
+        void invalidate();
+        void invalidate( const point &p );
+
+        /**
+         * Plans a route from @p f to @p t over plain tiles.  Returns the tiles where
+         * the route enters and leaves each cluster, starting with @p f and ending with
+         * @p t, or nothing if there is no such route.  @p cost is set to the cost
+         * of the route as map::route would count it.
+         */
+        std::vector<point> find_waypoints( const cata::mdarray<pf_special, point_bub_ms> &special,
+                                           const point &f, const point &t, int &cost );
+
+    private:
+        static constexpr int cluster_size = SEEX;
+        static constexpr int clusters_per_side = MAPSIZE;
+        static constexpr int num_clusters = clusters_per_side * clusters_per_side;
+
+        struct cluster {
+            // Entrance tiles inside this cluster, on the west, east, north and south
+            // borders in that order.
+            std::vector<point> portals;
+            std::array<int, 4> border_start;
+            // Cost between each pair of portals, -1 if there is no path.
+            std::vector<int> costs;
+            // Index of the first portal in the whole graph.
+            int first_node = 0;
+        };
+
+        void update( const cata::mdarray<pf_special, point_bub_ms> &special );
+        void build_border( const cata::mdarray<pf_special, point_bub_ms> &special, int border );
+        void build_cluster( const cata::mdarray<pf_special, point_bub_ms> &special, int index );
+
+        // Entrances on the borders between clusters, as the offset along the border.
+        // Borders [0, num_clusters) lie east of the cluster with that index, the
+        // rest lie south of the cluster with index border - num_clusters.
+        std::array<std::vector<int>, num_clusters * 2> borders;
+        std::array<cluster, num_clusters> clusters;
+        std::bitset<num_clusters> dirty_clusters;
+        // Cluster of each portal in the whole graph.
+        std::vector<int> node_clusters;
 };
 
 struct pathfinding_settings {
@@ -78,4 +139,62 @@ struct pathfinding_settings {
     pathfinding_settings &operator=( const pathfinding_settings & ) = default;
 };
 
+/**
+ * Cheapest routes from every tile of one z-level to a common target, built with a
+ * single Dijkstra search outwards from the target.  Monsters chasing the same
+ * target just follow the field downhill instead of each running A*.
+ *
+ * Step costs match @ref map::route, including opening doors, bashing, climbing
+ * and the trap penalty, so a field is only shared by routes whose settings cost
+ * the same (see @ref flow_field::same_costs).  Moving between z-levels is left
+ * to @ref map::route.
+ */
+struct flow_field {
+    // Number of routes to the same target in one turn before a field is built for it.
+    static constexpr int min_requests = 2;
+    // Fields kept per z-level; further targets are routed with A*.
+    static constexpr int max_fields = 8;
+
+    // Whether routes with @p a and @p b cost the same on the same map.
+    static bool same_costs( const pathfinding_settings &a, const pathfinding_settings &b );
+
+    point target;
+    pathfinding_settings settings;
+    // Number of routes to target asked for this turn.
+    int requests = 0;
+    bool built = false;
+    // Cost of the cheapest route to target from each tile, -1 if there is none.
+    cata::mdarray<int, point_bub_ms> distance;
+    // Index into eight_horizontal_neighbors of the next step towards target.
+    cata::mdarray<int8_t, point_bub_ms> next_step;
+};
+
+struct pathfinding_cache {
+    pathfinding_cache();
+
+    bool dirty = false;
+    // Points changed since the last update, and the submaps that contain them, so
+    // that the update only has to look at those.  Filled by mark_dirty.
+    std::bitset<MAPSIZE_X * MAPSIZE_Y> dirty_points;
+    std::bitset<MAPSIZE * MAPSIZE> dirty_submaps;
+    std::vector<point> dirty_submap_list;
+
+    void mark_dirty( const point &p );
+    bool has_dirty_points() const {
+        return !dirty_submap_list.empty();
+    }
+    bool is_dirty( const point &p ) const {
+        return dirty_points[p.x * MAPSIZE_Y + p.y];
+    }
+    void clear_dirty_points();
+
+    cata::mdarray<pf_special, point_bub_ms> special;
+
+    pathfinding_hierarchy hierarchy;
+
+    // Flow fields built during flow_fields_turn, dropped on any change to the level.
+    std::vector<std::unique_ptr<flow_field>> flow_fields;
+    time_point flow_fields_turn;
+};
+
 #endif // CATA_SRC_PATHFINDING_H
@@ -0,0 +1,241 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+#include "string_formatter.h"
+
+namespace profiler
+{
+
+namespace detail
+{
+std::atomic<bool> recording( false );
+} // namespace detail
+
+namespace
+{
+
+using clock = std::chrono::steady_clock;
+using duration = clock::duration;
+
+struct node_stats {
+    const char *name;
+    int parent;
+    int depth;
+    int calls = 0;
+    duration total = duration::zero();
+    duration longest = duration::zero();
+};
+
+struct trace_event {
+    int node;
+    int thread;
+    clock::time_point start;
+    duration length;
+};
+
+// Zones past this many are left out of the trace (about 32 MB of them), but not the report.
+constexpr size_t max_trace_events = 1 << 20;
+
+std::mutex recording_mutex;
+// Everything below is guarded by recording_mutex.
+// Each start() begins a new generation, zones from older ones are ignored when they end.
+int current_generation = 0;
+clock::time_point recording_start;
+clock::time_point recording_end;
+std::vector<node_stats> nodes;
+// Node of each zone name under each parent node (-1 for none).
+std::map<std::pair<int, std::string_view>, int> node_ids;
+std::vector<trace_event> events;
+int dropped_events = 0;
+
+std::atomic<int> next_thread_id( 0 );
+
+// The innermost zone being recorded on this thread.
+struct open_zone {
+    int node = -1;
+    int generation = 0;
+};
+thread_local open_zone innermost;
+thread_local const int thread_id = next_thread_id++;
+
+std::string format_duration( const duration d )
+{
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>( d ).count();
+    if( us < 1000 ) {
+        return string_format( "%d us", us );
+    } else if( us < 1000000 ) {
+        return string_format( "%.1f ms", us / 1000.0 );
+    }
+    return string_format( "%.2f s", us / 1000000.0 );
+}
+
+int64_t microseconds( const duration d )
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>( d ).count();
+}
+
+// Depth first, the most expensive zones first.  recording_mutex must be held.
+std::vector<int> report_order()
+{
+    std::vector<std::vector<int>> children( nodes.size() );
+    std::vector<int> roots;
+    for( size_t i = 0; i < nodes.size(); i++ ) {
+        const int parent = nodes[i].parent;
+        ( parent < 0 ? roots : children[parent] ).push_back( static_cast<int>( i ) );
+    }
+    const auto by_total = [&]( std::vector<int> &ids ) {
+        std::sort( ids.begin(), ids.end(), [&]( const int lhs, const int rhs ) {
+            return nodes[lhs].total > nodes[rhs].total;
+        } );
+    };
+    std::vector<int> ret;
+    std::vector<int> pending = roots;
+    by_total( pending );
+    std::reverse( pending.begin(), pending.end() );
+    while( !pending.empty() ) {
+        const int id = pending.back();
+        pending.pop_back();
+        ret.push_back( id );
+        std::vector<int> &below = children[id];
+        by_total( below );
+        pending.insert( pending.end(), below.rbegin(), below.rend() );
+    }
+    return ret;
+}
+
+} // namespace
+
+void start()
+{
+    std::lock_guard<std::mutex> lock( recording_mutex );
+    current_generation++;
+    nodes.clear();
+    node_ids.clear();
+    events.clear();
+    dropped_events = 0;
+    recording_start = clock::now();
+    detail::recording = true;
+}
+
+void stop()
+{
+    std::lock_guard<std::mutex> lock( recording_mutex );
+    detail::recording = false;
+    recording_end = clock::now();
+}
+
+void zone::begin( const char *name )
+{
+    {
+        std::lock_guard<std::mutex> lock( recording_mutex );
+        generation = current_generation;
+        parent = innermost.generation == generation ? innermost.node : -1;
+        const auto inserted = node_ids.emplace( std::make_pair( parent, std::string_view( name ) ),
+                                                static_cast<int>( nodes.size() ) );
+        if( inserted.second ) {
+            const int depth = parent < 0 ? 0 : nodes[parent].depth + 1;
+            nodes.push_back( node_stats{ name, parent, depth } );
+        }
+        node = inserted.first->second;
+    }
+    innermost = { node, generation };
+    start_time = clock::now();
+}
+
+void zone::end()
+{
+    const duration length = clock::now() - start_time;
+    innermost = { parent, generation };
+    std::lock_guard<std::mutex> lock( recording_mutex );
+    if( generation != current_generation ) {
+        return;
+    }
+    node_stats &stats = nodes[node];
+    stats.calls++;
+    stats.total += length;
+    stats.longest = std::max( stats.longest, length );
+    if( events.size() < max_trace_events ) {
+        events.push_back( trace_event{ node, thread_id, start_time, length } );
+    } else {
+        dropped_events++;
+    }
+}
+
+std::string report()
+{
+    std::lock_guard<std::mutex> lock( recording_mutex );
+    const duration recorded = ( detail::recording ? clock::now() : recording_end ) -
+                              recording_start;
+    std::string ret = string_format( "Recorded %s.\n", format_duration( recorded ) );
+    if( nodes.empty() ) {
+        return ret + "No zones ran.\n";
+    }
+    ret += string_format( "%-36s %8s %10s %10s %10s %6s\n", "zone", "calls", "total", "mean",
+                          "longest", "share" );
+
+    for( const int id : report_order() ) {
+        const node_stats &stats = nodes[id];
+        const duration of = stats.parent < 0 ? recorded : nodes[stats.parent].total;
+        const double share = of.count() > 0 ? 100.0 * stats.total.count() / of.count() : 0.0;
+        const std::string name = std::string( 2 * stats.depth, ' ' ) + stats.name;
+        ret += string_format( "%-36s %8d %10s %10s %10s %5.1f%%\n", name, stats.calls,
+                              format_duration( stats.total ),
+                              format_duration( stats.calls > 0 ? stats.total / stats.calls :
+                                               duration::zero() ),
+                              format_duration( stats.longest ), share );
+    }
+    if( dropped_events > 0 ) {
+        ret += string_format( "%d zones were left out of the trace.\n", dropped_events );
+    }
+    return ret;
+}
+
+std::vector<zone_total> totals()
+{
+    std::lock_guard<std::mutex> lock( recording_mutex );
+    std::vector<zone_total> ret;
+    std::vector<std::string> paths( nodes.size() );
+    // Parents come before their children.
+    for( const int id : report_order() ) {
+        const node_stats &stats = nodes[id];
+        paths[id] = stats.parent < 0 ? stats.name : paths[stats.parent] + "/" + stats.name;
+        const auto total = std::chrono::duration_cast<std::chrono::nanoseconds>( stats.total );
+        ret.push_back( zone_total{ paths[id], stats.calls, total } );
+    }
+    return ret;
+}
+
+void write_trace( std::ostream &out )
+{
+    std::lock_guard<std::mutex> lock( recording_mutex );
+    JsonOut jsout( out );
+    jsout.start_object();
+    jsout.member( "displayTimeUnit", "ms" );
+    jsout.member( "traceEvents" );
+    jsout.start_array();
+    for( const trace_event &event : events ) {
+        // Complete events, see the "Trace Event Format" document of the Chromium project.
+        jsout.start_object();
+        jsout.member( "name", nodes[event.node].name );
+        jsout.member( "cat", "turn" );
+        jsout.member( "ph", "X" );
+        jsout.member( "ts", microseconds( event.start - recording_start ) );
+        jsout.member( "dur", microseconds( event.length ) );
+        jsout.member( "pid", 1 );
+        jsout.member( "tid", event.thread );
+        jsout.end_object();
+    }
+    jsout.end_array();
+    jsout.end_object();
+}
+
+} // namespace profiler
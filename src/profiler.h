@@ -0,0 +1,94 @@
+#pragma once
+#ifndef CATA_SRC_PROFILER_H
+#define CATA_SRC_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * Finds out where the time of a turn goes, turned on and off from the debug menu.
+ *
+ * The phases worth timing are marked with @ref CATA_PROFILE_ZONE.  While recording, every
+ * zone that runs is timed and filed under the zone it ran in on the same thread.  The result
+ * can be shown as a report of the time spent in each zone, or written as a Chrome trace
+ * (for chrome://tracing or https://ui.perfetto.dev) with every single zone on a timeline.
+ *
+ * When not recording a zone costs a relaxed atomic load.  Building with CATA_NO_PROFILER
+ * removes the zones altogether.
+ */
+namespace profiler
+{
+
+namespace detail
+{
+extern std::atomic<bool> recording;
+} // namespace detail
+
+inline bool is_recording()
+{
+    return detail::recording.load( std::memory_order_relaxed );
+}
+
+/** Starts recording, discarding whatever was recorded before. */
+void start();
+/** Stops recording, keeping what was recorded for @ref report and @ref write_trace. */
+void stop();
+
+/**
+ * For each zone, nested under the zones it ran in: how often it ran, the total, mean and
+ * longest time, and the share of the time of its parent (or of the recording) it took.
+ */
+std::string report();
+/** Writes the recorded zones as Chrome trace event JSON. */
+void write_trace( std::ostream &out );
+
+struct zone_total {
+    // The name of the zone after those of the zones it ran in, separated by '/'.
+    std::string path;
+    int calls;
+    std::chrono::nanoseconds total;
+};
+/** The recorded zones in the order of @ref report, for tools that want the numbers. */
+std::vector<zone_total> totals();
+
+/** Times the scope it lives in, use @ref CATA_PROFILE_ZONE to create one. */
+class zone
+{
+    public:
+        // name must outlive the recording, in practice it is a string literal.
+        explicit zone( const char *name ) {
+            if( is_recording() ) {
+                begin( name );
+            }
+        }
+        zone( const zone & ) = delete;
+        zone &operator=( const zone & ) = delete;
+        ~zone() {
+            if( node >= 0 ) {
+                end();
+            }
+        }
+
+    private:
+        void begin( const char *name );
+        void end();
+
+        int node = -1;
+        int parent = -1;
+        int generation = 0;
+        std::chrono::steady_clock::time_point start_time;
+};
+
+} // namespace profiler
+
+// Times the rest of the enclosing scope as a zone called name, at most one per scope.
+#if defined( CATA_NO_PROFILER )
+#define CATA_PROFILE_ZONE( name ) static_cast<void>( 0 )
+#else
+#define CATA_PROFILE_ZONE( name ) const profiler::zone cata_profile_zone( name )
+#endif
+
+#endif // CATA_SRC_PROFILER_H
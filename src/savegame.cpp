@@ -1471,6 +1471,7 @@ void weather_manager::serialize_all( JsonOut &json )
 
 void weather_manager::unserialize_all( const JsonObject &w )
 {
+    get_weather().daily_sum_cache.clear();
     w.read( "lightning", get_weather().lightning_active );
     w.read( "weather_id", get_weather().weather_id );
     w.read( "next_weather", get_weather().nextweather );
@@ -1682,7 +1683,8 @@ void faction_manager::deserialize( const JsonValue &jv )
 void creature_tracker::deserialize( const JsonArray &ja )
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    list_order.clear();
+    clear_locations();
     for( JsonValue jv : ja ) {
         // TODO: would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
         shared_ptr_fast<monster> mptr = make_shared_fast<monster>();
@@ -3912,7 +3912,7 @@ void player_morale::load( const JsonObject &jsin )
     jsin.read( "morale", points );
 }
 
-void mm_submap::serialize( JsonOut &jsout ) const
+void mm_submap::serialize( JsonOut &jsout, mm_dictionary &dictionary ) const
 {
     jsout.start_array();
 
@@ -3925,11 +3925,11 @@ void mm_submap::serialize( JsonOut &jsout ) const
         jsout.start_array();
         jsout.write( num_same );
         jsout.write( last.symbol );
-        jsout.write( last.ter_id );
+        jsout.write( dictionary.number_of( last.ter_id ) );
         jsout.write( static_cast<int>( last.ter_subtile ) );
         jsout.write( static_cast<int>( last.ter_rotation ) );
         if( !last.get_dec_id().empty() ) {
-            jsout.write( last.dec_id );
+            jsout.write( dictionary.number_of( last.dec_id ) );
             jsout.write( static_cast<int>( last.dec_subtile ) );
             jsout.write( static_cast<int>( last.dec_rotation ) );
         }
@@ -3957,7 +3957,7 @@ void mm_submap::serialize( JsonOut &jsout ) const
     jsout.end_array();
 }
 
-void mm_submap::deserialize( int version, const JsonArray &ja )
+void mm_submap::deserialize( int version, const JsonArray &ja, const mm_dictionary &dictionary )
 {
     size_t submap_array_idx = 0;
 
@@ -3987,7 +3987,7 @@ void mm_submap::deserialize( int version, const JsonArray &ja )
                         tile.set_dec_id( std::move( id ) );
                         tile.set_dec_subtile( ja_tile.get_int( 1 ) );
                         const int legacy_rotation = ja_tile.get_int( 2 );
-                        if( string_starts_with( tile.dec_id, "vp_" ) ) {
+                        if( string_starts_with( tile.get_dec_id(), "vp_" ) ) {
                             // legacy vehicle rotation needs to be converted from 0-360 degrees
                             // to 0-3 tileset rotation
                             const units::angle legacy_angle = units::from_degrees( legacy_rotation );
@@ -4000,7 +4000,7 @@ void mm_submap::deserialize( int version, const JsonArray &ja )
                     if( ja_tile.size() > 4 ) {
                         remaining = ja_tile.get_int( 4 ) - 1;
                     }
-                } else {
+                } else if( version < 2 ) {
                     remaining = ja_tile.get_int( 0 ) - 1;
                     tile.symbol = ja_tile.get_int( 1 );
                     tile.set_ter_id( ja_tile.get_string( 2 ) );
@@ -4015,6 +4015,21 @@ void mm_submap::deserialize( int version, const JsonArray &ja )
                         tile.dec_subtile = 0;
                         tile.dec_rotation = 0;
                     }
+                } else {
+                    remaining = ja_tile.get_int( 0 ) - 1;
+                    tile.symbol = ja_tile.get_int( 1 );
+                    tile.ter_id = dictionary.id_of( ja_tile.get_int( 2 ) );
+                    tile.ter_subtile = ja_tile.get_int( 3 );
+                    tile.ter_rotation = ja_tile.get_int( 4 );
+                    if( ja_tile.size() > 5 ) {
+                        tile.dec_id = dictionary.id_of( ja_tile.get_int( 5 ) );
+                        tile.dec_subtile = ja_tile.get_int( 6 );
+                        tile.dec_rotation = ja_tile.get_int( 7 );
+                    } else {
+                        tile.dec_id = 0;
+                        tile.dec_subtile = 0;
+                        tile.dec_rotation = 0;
+                    }
                 }
             }
             // Try to avoid assigning to save up on memory
@@ -4025,10 +4040,30 @@ void mm_submap::deserialize( int version, const JsonArray &ja )
     }
 }
 
+void mm_dictionary::serialize( JsonOut &jsout ) const
+{
+    jsout.start_array();
+    for( const uint32_t id : ids ) {
+        jsout.write( memorized_tile::interned( id ) );
+    }
+    jsout.end_array();
+}
+
+void mm_dictionary::deserialize( const JsonArray &ja )
+{
+    ids.clear();
+    numbers.clear();
+    for( const std::string id : ja ) {
+        number_of( memorized_tile::intern( id ) );
+    }
+}
+
 void mm_region::serialize( JsonOut &jsout ) const
 {
+    // Version 2 refers to ids by their number in the dictionary of the region.
+    mm_dictionary dictionary;
     jsout.start_object();
-    jsout.member( "version", 1 );
+    jsout.member( "version", 2 );
     jsout.write( "data" );
     jsout.write_member_separator();
     jsout.start_array();
@@ -4039,11 +4074,12 @@ void mm_region::serialize( JsonOut &jsout ) const
             if( sm->is_empty() ) {
                 jsout.write_null();
             } else {
-                sm->serialize( jsout );
+                sm->serialize( jsout, dictionary );
             }
         }
     }
     jsout.end_array();
+    jsout.member( "ids", dictionary );
     jsout.end_object();
 }
 
@@ -4051,6 +4087,7 @@ void mm_region::deserialize( const JsonValue &ja )
 {
     int version;
     JsonArray region_json;
+    mm_dictionary dictionary;
 
     if( ja.test_array() ) { // legacy, remove after 0.H comes out
         version = 0;
@@ -4059,6 +4096,9 @@ void mm_region::deserialize( const JsonValue &ja )
         JsonObject region_obj = ja;
         version = region_obj.get_int( "version" );
         region_json = region_obj.get_array( "data" );
+        if( version >= 2 ) {
+            dictionary.deserialize( region_obj.get_array( "ids" ) );
+        }
     }
 
     for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
@@ -4068,7 +4108,7 @@ void mm_region::deserialize( const JsonValue &ja )
             sm = make_shared_fast<mm_submap>();
             const JsonValue jsin = region_json.next_value();
             if( !jsin.test_null() ) {
-                sm->deserialize( version, jsin );
+                sm->deserialize( version, jsin, dictionary );
             }
         }
     }
@@ -4653,6 +4693,22 @@ void ter_furn_migrations::reset()
     furn_migrations.clear();
 }
 
+std::pair<ter_str_id, furn_str_id> ter_furn_migrations::migrate( const ter_str_id &ter )
+{
+    if( auto it = ter_migrations.find( ter ); it != ter_migrations.end() ) {
+        return it->second;
+    }
+    return { ter, furn_str_id::NULL_ID() };
+}
+
+std::pair<ter_str_id, furn_str_id> ter_furn_migrations::migrate( const furn_str_id &furn )
+{
+    if( auto it = furn_migrations.find( furn ); it != furn_migrations.end() ) {
+        return it->second;
+    }
+    return { ter_str_id::NULL_ID(), furn };
+}
+
 void ter_furn_migrations::check()
 {
     auto check_to_ids_valid = []( const std::pair<ter_str_id, furn_str_id> &to_ids,
@@ -4676,9 +4732,6 @@ void ter_furn_migrations::check()
 
 void submap::store( JsonOut &jsout ) const
 {
-    jsout.member( "turn_last_touched", last_touched );
-    jsout.member( "temperature", temperature_mod );
-
     // Terrain is saved using a simple RLE scheme.  Legacy saves don't have
     // this feature but the algorithm is backward compatible.
     jsout.member( "terrain" );
@@ -4686,6 +4739,7 @@ void submap::store( JsonOut &jsout ) const
     if( is_uniform() ) {
         _write_rle_terrain( jsout, uniform_ter.id().str(), SEEX * SEEY );
         jsout.end_array();
+        store_contents( jsout );
         return;
     }
     std::string last_id;
@@ -4766,20 +4820,6 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
-    jsout.member( "items" );
-    jsout.start_array();
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            if( m->itm[i][j].empty() ) {
-                continue;
-            }
-            jsout.write( i );
-            jsout.write( j );
-            jsout.write( m->itm[i][j] );
-        }
-    }
-    jsout.end_array();
-
     jsout.member( "traps" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -4798,6 +4838,31 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
+    store_contents( jsout );
+}
+
+void submap::store_contents( JsonOut &jsout ) const
+{
+    jsout.member( "turn_last_touched", last_touched );
+    jsout.member( "temperature", temperature_mod );
+    if( is_uniform() ) {
+        return;
+    }
+
+    jsout.member( "items" );
+    jsout.start_array();
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            if( m->itm[i][j].empty() ) {
+                continue;
+            }
+            jsout.write( i );
+            jsout.write( j );
+            jsout.write( m->itm[i][j] );
+        }
+    }
+    jsout.end_array();
+
     jsout.member( "fields" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -1,7 +1,10 @@
 #include "scent_map.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <new>
 
 #include "assign.h"
@@ -16,6 +19,18 @@
 #include "map.h"
 #include "output.h"
 #include "point.h"
+#include "profiler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define CATA_SCENT_SSE2
+#include <emmintrin.h>
+#endif
+// AVX2 code is compiled with a target attribute and chosen at runtime, which
+// needs GCC or clang.
+#if defined(CATA_SCENT_SSE2) && defined(__GNUC__)
+#define CATA_SCENT_AVX2
+#include <immintrin.h>
+#endif
 
 static constexpr int SCENT_RADIUS = 40;
 
@@ -159,8 +174,372 @@ bool scent_map::inbounds( const point &p ) const
     return scent_map_boundaries.contains( p );
 }
 
+// The column kernels compute exactly what the per-cell loop in scent_map::update
+// does, one column (fixed x, contiguous y) at a time, from three primitives:
+//
+// weigh: how much scent each cell passes on.  Open cells have a weight of 10,
+// REDUCE_SCENT ones 2 and NO_SCENT ones 0.  Also tells whether any cell has scent.
+//
+// sum_3: sums over three vertically neighboring cells.
+//
+// diffuse: the new scent of each cell.  The per-cell formula
+//     ( s * ( 10000 - used * d ) - s * d * ( 90 - used ) / 5 + d * inflow ) / 10000
+// is evaluated as
+//     ( s * ( base - used * d - d / 5 * ( 90 - used ) ) + d * inflow ) / 10000
+// which is exact because the diffusivity d is a multiple of 5.  base is 10000, and
+// base and d are 0 for NO_SCENT cells, whose scent thus becomes 0.
+
+// Vertical sums of the column being diffused and of its neighbors to the left
+// and right.
+struct scent_column_sums {
+    std::array<const int *, 3> used;
+    std::array<const int *, 3> scent;
+
+    scent_column_sums offset( const int i ) const {
+        return { { used[0] + i, used[1] + i, used[2] + i },
+            { scent[0] + i, scent[1] + i, scent[2] + i } };
+    }
+};
+
+static bool weigh_scalar( const bool *blocks, const bool *reduces, const int *scent,
+                          int *weight, int *weighted, const int count )
+{
+    bool any = false;
+    for( int i = 0; i < count; i++ ) {
+        weight[i] = blocks[i] ? 0 : reduces[i] ? 2 : 10;
+        weighted[i] = weight[i] * scent[i];
+        any |= scent[i] != 0;
+    }
+    return any;
+}
+
+static void sum_3_scalar( const int *in, int *out, const int count )
+{
+    for( int i = 0; i < count; i++ ) {
+        out[i] = in[i] + in[i + 1] + in[i + 2];
+    }
+}
+
+static void diffuse_scalar( const bool *blocks, const bool *reduces,
+                            const scent_column_sums &sums, int *scent, const int count )
+{
+    for( int i = 0; i < count; i++ ) {
+        if( blocks[i] ) {
+            scent[i] = 0;
+            continue;
+        }
+        const int d = reduces[i] ? 20 : 100;
+        const int used = sums.used[0][i] + sums.used[1][i] + sums.used[2][i];
+        const int inflow = sums.scent[0][i] + sums.scent[1][i] + sums.scent[2][i];
+        scent[i] = ( scent[i] * ( 10000 - used * d - d / 5 * ( 90 - used ) ) + d * inflow ) / 10000;
+    }
+}
+
+// Division by 10000 rounds towards zero, like the scalar code.  The SIMD versions
+// divide the magnitude by multiplying with a fixed point inverse, as compilers do
+// for constant divisors, which is exact for all 32-bit values.
+static constexpr unsigned int inverse_10000 = 0xd1b71759u;
+static constexpr int inverse_10000_shift = 45;
+
+#if defined(CATA_SCENT_SSE2)
+static __m128i load_sse2( const int *p )
+{
+    return _mm_loadu_si128( reinterpret_cast<const __m128i *>( p ) );
+}
+
+static void store_sse2( int *p, const __m128i v )
+{
+    _mm_storeu_si128( reinterpret_cast<__m128i *>( p ), v );
+}
+
+// All bits set in the lanes whose flag is set, for four flags.
+static __m128i flag_mask_sse2( const bool *flags )
+{
+    int32_t bytes;
+    std::memcpy( &bytes, flags, sizeof( bytes ) );
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i words = _mm_unpacklo_epi8( _mm_cvtsi32_si128( bytes ), zero );
+    return _mm_cmpgt_epi32( _mm_unpacklo_epi16( words, zero ), zero );
+}
+
+// a in the lanes where mask is set, b elsewhere.
+static __m128i select_sse2( const __m128i mask, const __m128i a, const __m128i b )
+{
+    return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+}
+
+// SSE2 lacks a 32-bit multiply, so multiply the even and odd lanes separately.
+static __m128i mullo_sse2( const __m128i a, const __m128i b )
+{
+    const __m128i even = _mm_mul_epu32( a, b );
+    const __m128i odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+    return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ),
+                               _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+}
+
+static __m128i div_10000_sse2( const __m128i n )
+{
+    const __m128i inverse = _mm_set1_epi32( static_cast<int>( inverse_10000 ) );
+    const __m128i sign = _mm_srai_epi32( n, 31 );
+    const __m128i magnitude = _mm_sub_epi32( _mm_xor_si128( n, sign ), sign );
+    const __m128i even = _mm_srli_epi64( _mm_mul_epu32( magnitude, inverse ),
+                                         inverse_10000_shift );
+    const __m128i odd = _mm_srli_epi64( _mm_mul_epu32( _mm_srli_epi64( magnitude, 32 ), inverse ),
+                                        inverse_10000_shift );
+    const __m128i quotient = _mm_or_si128( even, _mm_slli_epi64( odd, 32 ) );
+    return _mm_sub_epi32( _mm_xor_si128( quotient, sign ), sign );
+}
+
+static __m128i add_3_sse2( const std::array<const int *, 3> &in, const int i )
+{
+    return _mm_add_epi32( _mm_add_epi32( load_sse2( in[0] + i ), load_sse2( in[1] + i ) ),
+                          load_sse2( in[2] + i ) );
+}
+
+static bool weigh_sse2( const bool *blocks, const bool *reduces, const int *scent,
+                        int *weight, int *weighted, const int count )
+{
+    const __m128i open = _mm_set1_epi32( 10 );
+    const __m128i reduced = _mm_set1_epi32( 2 );
+    __m128i any = _mm_setzero_si128();
+    int i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        const __m128i reducing = flag_mask_sse2( reduces + i );
+        const __m128i w = _mm_andnot_si128( flag_mask_sse2( blocks + i ),
+                                            select_sse2( reducing, reduced, open ) );
+        const __m128i s = load_sse2( scent + i );
+        store_sse2( weight + i, w );
+        store_sse2( weighted + i, mullo_sse2( w, s ) );
+        any = _mm_or_si128( any, s );
+    }
+    const bool any_in_tail = weigh_scalar( blocks + i, reduces + i, scent + i, weight + i,
+                                           weighted + i, count - i );
+    return any_in_tail ||
+           _mm_movemask_epi8( _mm_cmpeq_epi32( any, _mm_setzero_si128() ) ) != 0xffff;
+}
+
+static void sum_3_sse2( const int *in, int *out, const int count )
+{
+    int i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        store_sse2( out + i, add_3_sse2( { { in, in + 1, in + 2 } }, i ) );
+    }
+    sum_3_scalar( in + i, out + i, count - i );
+}
+
+static void diffuse_sse2( const bool *blocks, const bool *reduces,
+                          const scent_column_sums &sums, int *scent, const int count )
+{
+    int i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        const __m128i open = _mm_cmpeq_epi32( flag_mask_sse2( blocks + i ), _mm_setzero_si128() );
+        const __m128i reducing = flag_mask_sse2( reduces + i );
+        const __m128i base = _mm_and_si128( open, _mm_set1_epi32( 10000 ) );
+        const __m128i d = _mm_and_si128( open, select_sse2( reducing, _mm_set1_epi32( 20 ),
+                                         _mm_set1_epi32( 100 ) ) );
+        const __m128i d_5 = _mm_and_si128( open, select_sse2( reducing, _mm_set1_epi32( 4 ),
+                                           _mm_set1_epi32( 20 ) ) );
+        const __m128i used = add_3_sse2( sums.used, i );
+        const __m128i inflow = add_3_sse2( sums.scent, i );
+        const __m128i absorbed = mullo_sse2( d_5, _mm_sub_epi32( _mm_set1_epi32( 90 ), used ) );
+        const __m128i factor = _mm_sub_epi32( _mm_sub_epi32( base, mullo_sse2( used, d ) ),
+                                              absorbed );
+        const __m128i total = _mm_add_epi32( mullo_sse2( load_sse2( scent + i ), factor ),
+                                             mullo_sse2( d, inflow ) );
+        store_sse2( scent + i, div_10000_sse2( total ) );
+    }
+    diffuse_scalar( blocks + i, reduces + i, sums.offset( i ), scent + i, count - i );
+}
+#endif
+
+#if defined(CATA_SCENT_AVX2)
+__attribute__( ( target( "avx2" ) ) )
+static __m256i load_avx2( const int *p )
+{
+    return _mm256_loadu_si256( reinterpret_cast<const __m256i *>( p ) );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+static void store_avx2( int *p, const __m256i v )
+{
+    _mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), v );
+}
+
+// All bits set in the lanes whose flag is set, for eight flags.
+__attribute__( ( target( "avx2" ) ) )
+static __m256i flag_mask_avx2( const bool *flags )
+{
+    const __m128i bytes = _mm_loadl_epi64( reinterpret_cast<const __m128i *>( flags ) );
+    return _mm256_cmpgt_epi32( _mm256_cvtepu8_epi32( bytes ), _mm256_setzero_si256() );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+static __m256i div_10000_avx2( const __m256i n )
+{
+    const __m256i inverse = _mm256_set1_epi32( static_cast<int>( inverse_10000 ) );
+    const __m256i sign = _mm256_srai_epi32( n, 31 );
+    const __m256i magnitude = _mm256_sub_epi32( _mm256_xor_si256( n, sign ), sign );
+    const __m256i even = _mm256_srli_epi64( _mm256_mul_epu32( magnitude, inverse ),
+                                            inverse_10000_shift );
+    const __m256i odd = _mm256_srli_epi64( _mm256_mul_epu32( _mm256_srli_epi64( magnitude, 32 ),
+                                           inverse ), inverse_10000_shift );
+    const __m256i quotient = _mm256_blend_epi32( even, _mm256_slli_epi64( odd, 32 ), 0xaa );
+    return _mm256_sub_epi32( _mm256_xor_si256( quotient, sign ), sign );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+static __m256i add_3_avx2( const std::array<const int *, 3> &in, const int i )
+{
+    return _mm256_add_epi32( _mm256_add_epi32( load_avx2( in[0] + i ), load_avx2( in[1] + i ) ),
+                             load_avx2( in[2] + i ) );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+static bool weigh_avx2( const bool *blocks, const bool *reduces, const int *scent,
+                        int *weight, int *weighted, const int count )
+{
+    const __m256i open = _mm256_set1_epi32( 10 );
+    const __m256i reduced = _mm256_set1_epi32( 2 );
+    __m256i any = _mm256_setzero_si256();
+    int i = 0;
+    for( ; i + 8 <= count; i += 8 ) {
+        const __m256i reducing = flag_mask_avx2( reduces + i );
+        const __m256i w = _mm256_andnot_si256( flag_mask_avx2( blocks + i ),
+                                               _mm256_blendv_epi8( open, reduced, reducing ) );
+        const __m256i s = load_avx2( scent + i );
+        store_avx2( weight + i, w );
+        store_avx2( weighted + i, _mm256_mullo_epi32( w, s ) );
+        any = _mm256_or_si256( any, s );
+    }
+    const bool any_in_tail = weigh_scalar( blocks + i, reduces + i, scent + i, weight + i,
+                                           weighted + i, count - i );
+    return any_in_tail || !_mm256_testz_si256( any, any );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+static void sum_3_avx2( const int *in, int *out, const int count )
+{
+    int i = 0;
+    for( ; i + 8 <= count; i += 8 ) {
+        store_avx2( out + i, add_3_avx2( { { in, in + 1, in + 2 } }, i ) );
+    }
+    sum_3_scalar( in + i, out + i, count - i );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+static void diffuse_avx2( const bool *blocks, const bool *reduces,
+                          const scent_column_sums &sums, int *scent, const int count )
+{
+    int i = 0;
+    for( ; i + 8 <= count; i += 8 ) {
+        const __m256i open = _mm256_cmpeq_epi32( flag_mask_avx2( blocks + i ),
+                             _mm256_setzero_si256() );
+        const __m256i reducing = flag_mask_avx2( reduces + i );
+        const __m256i base = _mm256_and_si256( open, _mm256_set1_epi32( 10000 ) );
+        const __m256i d = _mm256_and_si256( open, _mm256_blendv_epi8( _mm256_set1_epi32( 100 ),
+                                            _mm256_set1_epi32( 20 ), reducing ) );
+        const __m256i d_5 = _mm256_and_si256( open, _mm256_blendv_epi8( _mm256_set1_epi32( 20 ),
+                                              _mm256_set1_epi32( 4 ), reducing ) );
+        const __m256i used = add_3_avx2( sums.used, i );
+        const __m256i inflow = add_3_avx2( sums.scent, i );
+        const __m256i absorbed = _mm256_mullo_epi32( d_5, _mm256_sub_epi32( _mm256_set1_epi32( 90 ),
+                                 used ) );
+        const __m256i factor = _mm256_sub_epi32( _mm256_sub_epi32( base,
+                               _mm256_mullo_epi32( used, d ) ), absorbed );
+        const __m256i scent_here = load_avx2( scent + i );
+        const __m256i total = _mm256_add_epi32( _mm256_mullo_epi32( scent_here, factor ),
+                                                _mm256_mullo_epi32( d, inflow ) );
+        store_avx2( scent + i, div_10000_avx2( total ) );
+    }
+    diffuse_scalar( blocks + i, reduces + i, sums.offset( i ), scent + i, count - i );
+}
+#endif
+
+scent_kernel best_scent_kernel()
+{
+#if defined(CATA_SCENT_AVX2)
+    if( __builtin_cpu_supports( "avx2" ) ) {
+        return scent_kernel::columns_avx2;
+    }
+#endif
+#if defined(CATA_SCENT_SSE2)
+    return scent_kernel::columns_sse2;
+#else
+    return scent_kernel::columns_scalar;
+#endif
+}
+
+static scent_kernel active_kernel = best_scent_kernel();
+
+scent_kernel get_scent_kernel()
+{
+    return active_kernel;
+}
+
+void set_scent_kernel( const scent_kernel kernel )
+{
+    active_kernel = std::min( kernel, best_scent_kernel() );
+}
+
+static bool weigh( const bool *blocks, const bool *reduces, const int *scent, int *weight,
+                   int *weighted, const int count )
+{
+    switch( active_kernel ) {
+#if defined(CATA_SCENT_AVX2)
+        case scent_kernel::columns_avx2:
+            return weigh_avx2( blocks, reduces, scent, weight, weighted, count );
+#endif
+#if defined(CATA_SCENT_SSE2)
+        case scent_kernel::columns_sse2:
+            return weigh_sse2( blocks, reduces, scent, weight, weighted, count );
+#endif
+        default:
+            return weigh_scalar( blocks, reduces, scent, weight, weighted, count );
+    }
+}
+
+static void sum_3( const int *in, int *out, const int count )
+{
+    switch( active_kernel ) {
+#if defined(CATA_SCENT_AVX2)
+        case scent_kernel::columns_avx2:
+            sum_3_avx2( in, out, count );
+            return;
+#endif
+#if defined(CATA_SCENT_SSE2)
+        case scent_kernel::columns_sse2:
+            sum_3_sse2( in, out, count );
+            return;
+#endif
+        default:
+            sum_3_scalar( in, out, count );
+            return;
+    }
+}
+
+static void diffuse( const bool *blocks, const bool *reduces, const scent_column_sums &sums,
+                     int *scent, const int count )
+{
+    switch( active_kernel ) {
+#if defined(CATA_SCENT_AVX2)
+        case scent_kernel::columns_avx2:
+            diffuse_avx2( blocks, reduces, sums, scent, count );
+            return;
+#endif
+#if defined(CATA_SCENT_SSE2)
+        case scent_kernel::columns_sse2:
+            diffuse_sse2( blocks, reduces, sums, scent, count );
+            return;
+#endif
+        default:
+            diffuse_scalar( blocks, reduces, sums, scent, count );
+            return;
+    }
+}
+
 void scent_map::update( const tripoint &center, map &m )
 {
+    CATA_PROFILE_ZONE( "scent_map::update" );
     // Stop updating scent after X turns of the player not moving.
     // Once wind is added, need to reset this on wind shifts as well.
     if( !player_last_position || center != *player_last_position ) {
@@ -195,6 +574,49 @@ void scent_map::update( const tripoint &center, map &m )
     // The new scent flag searching function. Should be wayyy faster than the old one.
     m.scent_blockers( blocks_scent, reduces_scent, point( scentmap_minx - 1, scentmap_miny - 1 ),
                       point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+
+    if( active_kernel != scent_kernel::per_cell ) {
+        // Vertical sums of three columns at a time, in a ring indexed by x % 3.
+        const int height = scentmap_maxy - scentmap_miny + 1;
+        std::array<int, MAPSIZE_Y> weight;
+        std::array<int, MAPSIZE_Y> weighted;
+        std::array<std::array<int, MAPSIZE_Y>, 3> used_y;
+        std::array<std::array<int, MAPSIZE_Y>, 3> scent_y;
+        std::array<bool, 3> has_scent;
+        const auto slot = []( const int x ) {
+            return ( x % 3 + 3 ) % 3;
+        };
+        const auto sum_column = [&]( const int x ) {
+            const int y = scentmap_miny - 1;
+            has_scent[slot( x )] = weigh( &blocks_scent[x][y], &reduces_scent[x][y], &grscent[x][y],
+                                          weight.data(), weighted.data(), height + 2 );
+            sum_3( weight.data(), used_y[slot( x )].data(), height );
+            sum_3( weighted.data(), scent_y[slot( x )].data(), height );
+        };
+        sum_column( scentmap_minx - 1 );
+        sum_column( scentmap_minx );
+        for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
+            // The sums only read their own column, so diffusing x doesn't disturb x + 1.
+            sum_column( x + 1 );
+            // Without scent in or next to it, a column stays all zero.
+            if( !has_scent[0] && !has_scent[1] && !has_scent[2] ) {
+                continue;
+            }
+            const scent_column_sums sums = {
+                {
+                    used_y[slot( x - 1 )].data(), used_y[slot( x )].data(),
+                    used_y[slot( x + 1 )].data()
+                }, {
+                    scent_y[slot( x - 1 )].data(), scent_y[slot( x )].data(),
+                    scent_y[slot( x + 1 )].data()
+                }
+            };
+            diffuse( &blocks_scent[x][scentmap_miny], &reduces_scent[x][scentmap_miny], sums,
+                     &grscent[x][scentmap_miny], height );
+        }
+        return;
+    }
+
     // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
     // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
     // is a net performance improvement over the old code. Could probably still be better.
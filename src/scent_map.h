@@ -41,6 +41,23 @@ class scent_type
         static void reset();
 };
 
+// How scent_map::update diffuses scent.  per_cell is the reference
+// implementation.  The column kernels work along contiguous columns, using SIMD
+// where available, and skip columns that have no scent in or next to them.  All
+// kernels produce identical results.
+enum class scent_kernel : int {
+    per_cell,
+    columns_scalar,
+    columns_sse2,
+    columns_avx2
+};
+
+// The fastest kernel supported by this build and CPU, used by default.
+scent_kernel best_scent_kernel();
+scent_kernel get_scent_kernel();
+// Selects a kernel, falling back to the best supported one if necessary.
+void set_scent_kernel( scent_kernel kernel );
+
 class scent_map
 {
     protected:
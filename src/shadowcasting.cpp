@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <iterator>
+#include <type_traits>
 
 #include "cuboid_rectangle.h"
 #include "fragment_cloud.h" // IWYU pragma: keep
@@ -10,6 +11,161 @@
 #include "list.h"
 #include "point.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define CATA_SHADOWCASTING_SSE2
+#include <emmintrin.h>
+#endif
+// AVX2 code is compiled with a target attribute and chosen at runtime, which
+// needs GCC or clang.
+#if defined(CATA_SHADOWCASTING_SSE2) && defined(__GNUC__)
+#define CATA_SHADOWCASTING_AVX2
+#include <immintrin.h>
+#endif
+
+static int count_equal_scalar( const float *first, const int step, const int count,
+                               const float value )
+{
+    int i = 0;
+    while( i < count && first[i * step] == value ) {
+        i++;
+    }
+    return i;
+}
+
+static void max_fill_scalar( float *first, const int step, const int count, const float value )
+{
+    for( int i = 0; i < count; i++ ) {
+        first[i * step] = std::max( first[i * step], value );
+    }
+}
+
+#if defined(CATA_SHADOWCASTING_SSE2)
+static int count_equal_sse2( const float *first, const int step, const int count,
+                             const float value )
+{
+    const __m128 wanted = _mm_set1_ps( value );
+    int i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        // When walking backwards, load the four cells ending at cell i.
+        const float *block = step > 0 ? first + i : first - i - 3;
+        if( _mm_movemask_ps( _mm_cmpeq_ps( _mm_loadu_ps( block ), wanted ) ) != 0xf ) {
+            break;
+        }
+    }
+    // Locate the mismatch inside the block, or handle the tail.
+    return i + count_equal_scalar( first + i * step, step, count - i, value );
+}
+
+static void max_fill_sse2( float *first, const int step, const int count, const float value )
+{
+    // Order doesn't matter here, so fill the range front to back.
+    float *begin = step > 0 ? first : first - ( count - 1 );
+    const __m128 wanted = _mm_set1_ps( value );
+    int i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        // maxps picks its second operand on ties, like std::max( old, value ).
+        _mm_storeu_ps( begin + i, _mm_max_ps( wanted, _mm_loadu_ps( begin + i ) ) );
+    }
+    max_fill_scalar( begin + i, 1, count - i, value );
+}
+#endif
+
+#if defined(CATA_SHADOWCASTING_AVX2)
+__attribute__( ( target( "avx2" ) ) )
+static int count_equal_avx2( const float *first, const int step, const int count,
+                             const float value )
+{
+    const __m256 wanted = _mm256_set1_ps( value );
+    int i = 0;
+    for( ; i + 8 <= count; i += 8 ) {
+        const float *block = step > 0 ? first + i : first - i - 7;
+        const __m256 equal = _mm256_cmp_ps( _mm256_loadu_ps( block ), wanted, _CMP_EQ_OQ );
+        if( _mm256_movemask_ps( equal ) != 0xff ) {
+            break;
+        }
+    }
+    return i + count_equal_scalar( first + i * step, step, count - i, value );
+}
+
+__attribute__( ( target( "avx2" ) ) )
+static void max_fill_avx2( float *first, const int step, const int count, const float value )
+{
+    float *begin = step > 0 ? first : first - ( count - 1 );
+    const __m256 wanted = _mm256_set1_ps( value );
+    int i = 0;
+    for( ; i + 8 <= count; i += 8 ) {
+        _mm256_storeu_ps( begin + i, _mm256_max_ps( wanted, _mm256_loadu_ps( begin + i ) ) );
+    }
+    max_fill_scalar( begin + i, 1, count - i, value );
+}
+#endif
+
+shadowcasting_kernel best_shadowcasting_kernel()
+{
+#if defined(CATA_SHADOWCASTING_AVX2)
+    if( __builtin_cpu_supports( "avx2" ) ) {
+        return shadowcasting_kernel::rows_avx2;
+    }
+#endif
+#if defined(CATA_SHADOWCASTING_SSE2)
+    return shadowcasting_kernel::rows_sse2;
+#else
+    return shadowcasting_kernel::rows_scalar;
+#endif
+}
+
+static shadowcasting_kernel active_kernel = best_shadowcasting_kernel();
+
+shadowcasting_kernel get_shadowcasting_kernel()
+{
+    return active_kernel;
+}
+
+void set_shadowcasting_kernel( const shadowcasting_kernel kernel )
+{
+    active_kernel = std::min( kernel, best_shadowcasting_kernel() );
+}
+
+namespace shadowcasting_rows
+{
+
+int count_equal( const float *first, const int step, const int count, const float value )
+{
+    switch( active_kernel ) {
+#if defined(CATA_SHADOWCASTING_AVX2)
+        case shadowcasting_kernel::rows_avx2:
+            return count_equal_avx2( first, step, count, value );
+#endif
+#if defined(CATA_SHADOWCASTING_SSE2)
+        case shadowcasting_kernel::rows_sse2:
+            return count_equal_sse2( first, step, count, value );
+#endif
+        default:
+            return count_equal_scalar( first, step, count, value );
+    }
+}
+
+void max_fill( float *first, const int step, const int count, const float value )
+{
+    switch( active_kernel ) {
+#if defined(CATA_SHADOWCASTING_AVX2)
+        case shadowcasting_kernel::rows_avx2:
+            max_fill_avx2( first, step, count, value );
+            return;
+#endif
+#if defined(CATA_SHADOWCASTING_SSE2)
+        case shadowcasting_kernel::rows_sse2:
+            max_fill_sse2( first, step, count, value );
+            return;
+#endif
+        default:
+            max_fill_scalar( first, step, count, value );
+            return;
+    }
+}
+
+} // namespace shadowcasting_rows
+
 struct slope {
     slope( int_least8_t rise, int_least8_t run ) {
         // Ensure run is always positive for the inequality operators
@@ -155,6 +311,139 @@ static void split_span( cata::list<span<T>> &spans,
     current_transparency = new_transparency;
 }
 
+/**
+ * Row kernel for cast_horizontal_zlight_segment: does exactly what its per-cell
+ * loop does for one row, but a run of equally transparent cells at a time.
+ * floor_cache is the floor that hides the row from the origin, if any.
+ */
+template<int xx_transform, int xy_transform, int yx_transform, int yy_transform, typename T,
+         T( *calc )( const T &, const T &, const int & ),
+         bool( *is_transparent )( const T &, const T & ),
+         T( *accumulate )( const T &, const T &, const int & )>
+static void cast_horizontal_zlight_row(
+    cata::mdarray<T, point_bub_ms> &output_cache,
+    const cata::mdarray<T, point_bub_ms> &input_array,
+    const cata::mdarray<bool, point_bub_ms> *floor_cache,
+    cata::list<span<T>> &spans, typename cata::list<span<T>>::iterator &this_span,
+    const tripoint &offset, const int offset_distance, const T numerator,
+    const int distance, const int delta_z,
+    const slope &trailing_edge_major, const slope &leading_edge_major,
+    bool &started_block, T &current_transparency, T &last_intensity, slope &new_start_minor )
+{
+    const point row_base( offset.x + distance * xy_transform, offset.y + distance * yy_transform );
+    const point step( xx_transform, yx_transform );
+    const auto trailing_edge_minor = [distance]( const int dx ) {
+        return slope( dx * 2 - 1, distance * 2 + 1 );
+    };
+    const auto leading_edge_minor = [distance]( const int dx ) {
+        return slope( dx * 2 + 1, distance * 2 - 1 );
+    };
+    const auto transparency_at = [&]( const point & p ) -> T {
+        if( floor_cache != nullptr && ( *floor_cache )[p.x][p.y] )
+        {
+            return T( LIGHT_TRANSPARENCY_SOLID );
+        }
+        return input_array[p.x][p.y];
+    };
+    const auto dist_at = [&]( const int dx ) {
+        return rl_dist( tripoint_zero, tripoint( dx, distance, delta_z ) ) + offset_distance;
+    };
+
+    // Splitting the span never moves its minor edges past the cells still ahead
+    // in this row, so the range of cells to visit can be worked out up front.
+    int first = 0;
+    int last = distance;
+    shadowcasting_rows::clamp_to_map( row_base.x, xx_transform, MAPSIZE_X, first, last );
+    shadowcasting_rows::clamp_to_map( row_base.y, yx_transform, MAPSIZE_Y, first, last );
+    while( first <= last && ( this_span->start_minor > leading_edge_minor( first ) ||
+                              ( this_span->skip_first_column &&
+                                this_span->start_minor == leading_edge_minor( first ) ) ) ) {
+        first++;
+    }
+    for( int dx = first; dx <= last; dx++ ) {
+        if( this_span->end_minor < trailing_edge_minor( dx ) ) {
+            last = dx - 1;
+            break;
+        }
+    }
+
+    bool started_span = false;
+    for( int dx = first; dx <= last; ) {
+        const point current = row_base + step * dx;
+        const bool floor_block = floor_cache != nullptr && ( *floor_cache )[current.x][current.y];
+        const T new_transparency = transparency_at( current );
+        if( !started_block ) {
+            started_block = true;
+            current_transparency = new_transparency;
+        }
+
+        if( new_transparency == current_transparency ) {
+            int run = 1;
+            if constexpr( std::is_same_v<T, float> ) {
+                if( floor_cache == nullptr && step.x == 0 ) {
+                    const float *row = &input_array[current.x][current.y];
+                    run = shadowcasting_rows::count_equal( row, step.y, last - dx + 1,
+                                                           current_transparency );
+                }
+            }
+            while( dx + run <= last &&
+                   transparency_at( current + step * run ) == current_transparency ) {
+                run++;
+            }
+            // Intensity only depends on the distance, which is constant along the row
+            // unless distances are circular.
+            for( int i = 0; i < run; ) {
+                const int dist = dist_at( dx + i );
+                int same_dist = run - i;
+                if( trigdist ) {
+                    same_dist = 1;
+                    while( i + same_dist < run && dist_at( dx + i + same_dist ) == dist ) {
+                        same_dist++;
+                    }
+                }
+                last_intensity = calc( numerator, this_span->cumulative_value, dist );
+                const point run_start = current + step * i;
+                bool filled = false;
+                if constexpr( std::is_same_v<T, float> ) {
+                    if( floor_cache == nullptr && step.x == 0 ) {
+                        shadowcasting_rows::max_fill( &output_cache[run_start.x][run_start.y],
+                                                      step.y, same_dist, last_intensity );
+                        filled = true;
+                    }
+                }
+                for( int j = 0; !filled && j < same_dist; j++ ) {
+                    const point p = run_start + step * j;
+                    if( floor_cache == nullptr || !( *floor_cache )[p.x][p.y] ) {
+                        output_cache[p.x][p.y] = std::max( output_cache[p.x][p.y], last_intensity );
+                    }
+                }
+                i += same_dist;
+            }
+            dx += run;
+            new_start_minor = leading_edge_minor( dx - 1 );
+            started_span = true;
+            continue;
+        }
+
+        // A change in transparency, handled just like in cast_horizontal_zlight_segment.
+        last_intensity = calc( numerator, this_span->cumulative_value, dist_at( dx ) );
+        if( !floor_block ) {
+            output_cache[current.x][current.y] =
+                std::max( output_cache[current.x][current.y], last_intensity );
+        }
+        if( !started_span ) {
+            new_start_minor = leading_edge_minor( dx );
+            started_span = true;
+        }
+        split_span<T, is_transparent, accumulate>( spans, this_span, current_transparency,
+                new_transparency, last_intensity,
+                distance, new_start_minor,
+                trailing_edge_major, leading_edge_major,
+                trailing_edge_minor( dx ), leading_edge_minor( dx ) );
+        dx++;
+    }
+}
+
 template<int xx_transform, int xy_transform, int yx_transform, int yy_transform, int z_transform, typename T,
          T( *calc )( const T &, const T &, const int & ),
          bool( *is_transparent )( const T &, const T & ),
@@ -167,6 +456,7 @@ void cast_horizontal_zlight_segment(
     const T numerator )
 {
     const int radius = 60 - offset_distance;
+    const bool use_row_kernel = get_shadowcasting_kernel() != shadowcasting_kernel::per_cell;
 
     constexpr int min_z = -OVERMAP_DEPTH;
     constexpr int max_z = OVERMAP_HEIGHT;
@@ -244,7 +534,24 @@ void cast_horizontal_zlight_segment(
 
                 bool started_span = false;
                 const int z_index = current.z + OVERMAP_DEPTH;
-                for( delta.x = 0; delta.x <= distance; delta.x++ ) {
+                if( use_row_kernel ) {
+                    const cata::mdarray<bool, point_bub_ms> *floor_cache = nullptr;
+                    if( current.z < offset.z ) {
+                        floor_cache = floor_caches[z_index + 1];
+                    } else if( current.z > offset.z ) {
+                        floor_cache = floor_caches[z_index];
+                    }
+                    cast_horizontal_zlight_row < xx_transform, xy_transform, yx_transform,
+                                               yy_transform, T, calc, is_transparent, accumulate > (
+                                                   *output_caches[z_index], *input_arrays[z_index],
+                                                   floor_cache, spans, this_span, offset,
+                                                   offset_distance, numerator, distance, delta.z,
+                                                   trailing_edge_major, leading_edge_major,
+                                                   started_block, current_transparency,
+                                                   last_intensity, new_start_minor );
+                }
+                // The per-cell walk, unless the row kernel has already handled this row.
+                for( delta.x = 0; !use_row_kernel && delta.x <= distance; delta.x++ ) {
                     current.x = offset.x + delta.x * xx_transform + delta.y * xy_transform;
                     current.y = offset.y + delta.x * yx_transform + delta.y * yy_transform;
                     // See definition of trailing_edge_major and leading_edge_major for clarification.
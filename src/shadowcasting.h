@@ -115,6 +115,49 @@ inline float accumulate_transparency( const float &cumulative_transparency,
     return ( ( distance - 1 ) * cumulative_transparency + current_transparency ) / distance;
 }
 
+// How castLight and cast_zlight walk the rows of an octant.  per_cell is the
+// reference implementation.  The row kernels handle each run of equally
+// transparent cells at once: calc is evaluated once per run, and the
+// comparisons and output updates along contiguous rows use SIMD where
+// available (float grids only).  All kernels produce bit-identical results.
+enum class shadowcasting_kernel : int {
+    per_cell,
+    rows_scalar,
+    rows_sse2,
+    rows_avx2
+};
+
+// The fastest kernel supported by this build and CPU, used by default.
+shadowcasting_kernel best_shadowcasting_kernel();
+shadowcasting_kernel get_shadowcasting_kernel();
+// Selects a kernel, falling back to the best supported one if necessary.
+void set_shadowcasting_kernel( shadowcasting_kernel kernel );
+
+// Row primitives behind the row kernels.  Rows run through contiguous memory
+// in either direction, so step is 1 or -1.
+namespace shadowcasting_rows
+{
+// Number of leading cells (out of count) equal to value.
+int count_equal( const float *first, int step, int count, float value );
+// Raises each of the count cells to at least value.
+void max_fill( float *first, int step, int count, float value );
+
+// Narrows [lo, hi] to the offsets along a row where base + offset * step lies
+// in [0, size).  A step of 0 means the coordinate is fixed for the row.
+inline void clamp_to_map( const int base, const int step, const int size, int &lo, int &hi )
+{
+    if( step > 0 ) {
+        lo = std::max( lo, -base );
+        hi = std::min( hi, size - 1 - base );
+    } else if( step < 0 ) {
+        lo = std::max( lo, base - size + 1 );
+        hi = std::min( hi, base );
+    } else if( base < 0 || base >= size ) {
+        hi = lo - 1;
+    }
+}
+} // namespace shadowcasting_rows
+
 template<typename T, typename Out, T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
          void( *update_output )( Out &, const T &, quadrant ),
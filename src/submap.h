@@ -281,6 +281,9 @@ class submap
         void mirror( bool horizontally );
 
         void store( JsonOut &jsout ) const;
+        // Everything @ref store writes except the terrain, furniture, trap and
+        // radiation layers.
+        void store_contents( JsonOut &jsout ) const;
         void load( const JsonValue &jv, const std::string &member_name, int version );
 
         // If is_uniform is true, this submap is a solid block of terrain
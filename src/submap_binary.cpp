@@ -0,0 +1,361 @@
+#include "submap_binary.h"
+
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "debug.h"
+#include "flexbuffer_json.h"
+#include "json.h"
+#include "json_loader.h"
+#include "mapdata.h"
+#include "string_formatter.h"
+#include "submap.h"
+#include "trap.h"
+
+// NOLINTNEXTLINE(cata-static-declarations)
+extern const int savegame_version;
+
+static const ter_str_id ter_t_dirt( "t_dirt" );
+
+namespace
+{
+
+constexpr int cells = SEEX * SEEY;
+
+// Cells are visited in the same order as the JSON terrain RLE: row by row.
+point cell_pos( const int cell )
+{
+    return point( cell % SEEX, cell / SEEX );
+}
+
+class writer
+{
+    public:
+        void varint( uint64_t value ) {
+            while( value >= 0x80 ) {
+                out.push_back( static_cast<char>( ( value & 0x7f ) | 0x80 ) );
+                value >>= 7;
+            }
+            out.push_back( static_cast<char>( value ) );
+        }
+
+        void signed_varint( const int64_t value ) {
+            varint( ( static_cast<uint64_t>( value ) << 1 ) ^
+                    static_cast<uint64_t>( value >> 63 ) );
+        }
+
+        void bytes( const std::string_view data ) {
+            varint( data.size() );
+            out.append( data );
+        }
+
+        std::string out;
+};
+
+class reader
+{
+    public:
+        explicit reader( const std::string_view data ) : data( data ) {}
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for( int shift = 0; shift < 64; shift += 7 ) {
+                if( pos >= data.size() ) {
+                    throw std::runtime_error( "unexpected end of binary submap data" );
+                }
+                const uint8_t byte = static_cast<uint8_t>( data[pos++] );
+                value |= static_cast<uint64_t>( byte & 0x7f ) << shift;
+                if( !( byte & 0x80 ) ) {
+                    return value;
+                }
+            }
+            throw std::runtime_error( "malformed integer in binary submap data" );
+        }
+
+        int64_t signed_varint() {
+            const uint64_t value = varint();
+            return static_cast<int64_t>( value >> 1 ) ^ -static_cast<int64_t>( value & 1 );
+        }
+
+        // A count of something that is at most limit.
+        int count( const uint64_t limit ) {
+            const uint64_t value = varint();
+            if( value > limit ) {
+                throw std::runtime_error( string_format(
+                                              "binary submap data has a count of %d, expected at most %d",
+                                              value, limit ) );
+            }
+            return static_cast<int>( value );
+        }
+
+        std::string_view bytes() {
+            const uint64_t size = varint();
+            if( size > data.size() - pos ) {
+                throw std::runtime_error( "unexpected end of binary submap data" );
+            }
+            const std::string_view ret = data.substr( pos, size );
+            pos += size;
+            return ret;
+        }
+
+        void skip( const size_t size ) {
+            if( size > data.size() - pos ) {
+                throw std::runtime_error( "unexpected end of binary submap data" );
+            }
+            pos += size;
+        }
+
+        bool at_end() const {
+            return pos == data.size();
+        }
+
+    private:
+        std::string_view data;
+        size_t pos = 0;
+};
+
+// Ids of all terrain, furniture and traps in a file, each stored once.
+class string_table
+{
+    public:
+        int index_of( const std::string &id ) {
+            const auto inserted = indices.emplace( id, static_cast<int>( strings.size() ) );
+            if( inserted.second ) {
+                strings.push_back( id );
+            }
+            return inserted.first->second;
+        }
+
+        std::vector<std::string> strings;
+
+    private:
+        std::unordered_map<std::string, int> indices;
+};
+
+// Writes runs of equal values as ( length, value ) pairs.
+template<typename Value, typename Encode>
+void write_rle( writer &out, Value( *get )( const submap &, const point & ), const submap &sm,
+                Encode encode )
+{
+    int cell = 0;
+    while( cell < cells ) {
+        const Value value = get( sm, cell_pos( cell ) );
+        int run = 1;
+        while( cell + run < cells && get( sm, cell_pos( cell + run ) ) == value ) {
+            run++;
+        }
+        out.varint( run );
+        encode( value );
+        cell += run;
+    }
+}
+
+// Calls set( cell, value ) for each cell of a layer written by write_rle.
+template<typename Decode, typename Set>
+void read_rle( reader &in, Decode decode, Set set )
+{
+    int cell = 0;
+    while( cell < cells ) {
+        const int run = in.count( cells - cell );
+        if( run == 0 ) {
+            throw std::runtime_error( "empty run in binary submap data" );
+        }
+        const auto value = decode();
+        for( int i = 0; i < run; i++ ) {
+            set( cell_pos( cell++ ), value );
+        }
+    }
+}
+
+ter_id get_ter( const submap &sm, const point &p )
+{
+    return sm.get_ter( p );
+}
+
+furn_id get_furn( const submap &sm, const point &p )
+{
+    return sm.get_furn( p );
+}
+
+trap_id get_trap( const submap &sm, const point &p )
+{
+    return sm.get_trap( p );
+}
+
+int get_radiation( const submap &sm, const point &p )
+{
+    return sm.get_radiation( p );
+}
+
+void write_submap( writer &out, string_table &strings, const tripoint_abs_sm &pos,
+                   const submap &sm )
+{
+    out.signed_varint( pos.x() );
+    out.signed_varint( pos.y() );
+    out.signed_varint( pos.z() );
+    out.varint( savegame_version );
+
+    write_rle( out, &get_ter, sm, [&]( const ter_id & ter ) {
+        out.varint( strings.index_of( ter.id().str() ) );
+    } );
+    write_rle( out, &get_furn, sm, [&]( const furn_id & furn ) {
+        out.varint( strings.index_of( furn.id().str() ) );
+    } );
+    write_rle( out, &get_trap, sm, [&]( const trap_id & trap ) {
+        out.varint( strings.index_of( trap.id().str() ) );
+    } );
+    write_rle( out, &get_radiation, sm, [&]( const int radiation ) {
+        out.signed_varint( radiation );
+    } );
+
+    std::ostringstream contents;
+    JsonOut jsout( contents );
+    jsout.start_object();
+    sm.store_contents( jsout );
+    jsout.end_object();
+    out.bytes( contents.str() );
+}
+
+std::unique_ptr<submap> read_submap( reader &in, const std::vector<std::string> &strings,
+                                     tripoint_abs_sm &pos )
+{
+    const auto coordinate = [&]() {
+        return static_cast<int>( in.signed_varint() );
+    };
+    // Evaluated separately because the order of function arguments is unspecified.
+    const int x = coordinate();
+    const int y = coordinate();
+    const int z = coordinate();
+    pos = tripoint_abs_sm( x, y, z );
+    const int version = static_cast<int>( in.varint() );
+
+    const auto string_at = [&]() -> const std::string & {
+        const uint64_t index = in.varint();
+        if( index >= strings.size() )
+        {
+            throw std::runtime_error( "binary submap data refers to a missing id" );
+        }
+        return strings[index];
+    };
+
+    std::unique_ptr<submap> sm = std::make_unique<submap>();
+    sm->ensure_nonuniform();
+    read_rle( in, [&]() {
+        const std::pair<ter_str_id, furn_str_id> migrated =
+            ter_furn_migrations::migrate( ter_str_id( string_at() ) );
+        if( !migrated.first.is_valid() ) {
+            debugmsg( "invalid ter_str_id '%s'", migrated.first.c_str() );
+            return std::make_pair( ter_t_dirt, migrated.second );
+        }
+        return migrated;
+    }, [&]( const point & p, const std::pair<ter_str_id, furn_str_id> &migrated ) {
+        sm->set_ter( p, migrated.first.id() );
+        if( !migrated.second.is_null() ) {
+            sm->set_furn( p, migrated.second.id() );
+        }
+    } );
+    read_rle( in, [&]() {
+        const std::pair<ter_str_id, furn_str_id> migrated =
+            ter_furn_migrations::migrate( furn_str_id( string_at() ) );
+        if( !migrated.second.is_valid() ) {
+            debugmsg( "invalid furn_str_id '%s'", migrated.second.c_str() );
+            return std::make_pair( migrated.first, furn_str_id::NULL_ID() );
+        }
+        return migrated;
+    }, [&]( const point & p, const std::pair<ter_str_id, furn_str_id> &migrated ) {
+        // Null furniture doesn't replace what a terrain migration put there.
+        if( !migrated.second.is_null() ) {
+            sm->set_furn( p, migrated.second.id() );
+        }
+        if( !migrated.first.is_null() ) {
+            sm->set_ter( p, migrated.first.id() );
+        }
+    } );
+    read_rle( in, [&]() {
+        return trap_str_id( string_at() ).id();
+    }, [&]( const point & p, const trap_id & trap ) {
+        sm->set_trap( p, trap );
+    } );
+    read_rle( in, [&]() {
+        return static_cast<int>( in.signed_varint() );
+    }, [&]( const point & p, const int radiation ) {
+        sm->set_radiation( p, radiation );
+    } );
+
+    const JsonValue contents = json_loader::from_string( std::string( in.bytes() ) );
+    const JsonObject contents_json = contents;
+    for( JsonMember member : contents_json ) {
+        sm->load( member, member.name(), version );
+    }
+    return sm;
+}
+
+} // namespace
+
+namespace submap_binary
+{
+
+bool is_binary( const std::string_view data )
+{
+    return data.substr( 0, magic.size() ) == magic;
+}
+
+void write_quad( std::ostream &out,
+                 const std::vector<std::pair<tripoint_abs_sm, const submap *>> &submaps )
+{
+    string_table strings;
+    writer body;
+    body.varint( submaps.size() );
+    for( const std::pair<tripoint_abs_sm, const submap *> &sm : submaps ) {
+        write_submap( body, strings, sm.first, *sm.second );
+    }
+
+    writer header;
+    header.out = magic;
+    header.varint( format_version );
+    header.varint( strings.strings.size() );
+    for( const std::string &id : strings.strings ) {
+        header.bytes( id );
+    }
+    out << header.out << body.out;
+}
+
+std::vector<std::pair<tripoint_abs_sm, std::unique_ptr<submap>>> read_quad(
+    const std::string_view data )
+{
+    if( !is_binary( data ) ) {
+        throw std::runtime_error( "not a binary submap file" );
+    }
+    reader in( data );
+    in.skip( magic.size() );
+    const uint64_t version = in.varint();
+    if( version != format_version ) {
+        throw std::runtime_error( string_format( "unsupported binary submap format version %d",
+                                  version ) );
+    }
+    // Each string takes at least one byte, which bounds the sizes read below.
+    const int num_strings = in.count( data.size() );
+    std::vector<std::string> strings;
+    strings.reserve( num_strings );
+    for( int i = 0; i < num_strings; i++ ) {
+        strings.emplace_back( in.bytes() );
+    }
+
+    const int num_submaps = in.count( data.size() );
+    std::vector<std::pair<tripoint_abs_sm, std::unique_ptr<submap>>> ret;
+    for( int i = 0; i < num_submaps; i++ ) {
+        tripoint_abs_sm pos;
+        std::unique_ptr<submap> sm = read_submap( in, strings, pos );
+        ret.emplace_back( pos, std::move( sm ) );
+    }
+    if( !in.at_end() ) {
+        throw std::runtime_error( "trailing data after binary submaps" );
+    }
+    return ret;
+}
+
+} // namespace submap_binary
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef CATA_SRC_SUBMAP_BINARY_H
+#define CATA_SRC_SUBMAP_BINARY_H
+
+#include <iosfwd>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "coordinates.h"
+
+class submap;
+
+/**
+ * Compact binary save format for submap quads, an alternative to the JSON one.
+ *
+ * A file starts with @ref magic and a format version, followed by a table of all
+ * terrain, furniture and trap ids used in it.  Each submap then stores its
+ * coordinates, the savegame version it was written with, its terrain, furniture,
+ * trap and radiation layers as run-length encoded runs of ids from the table, and
+ * finally everything else about it (items, fields, vehicles, ...) as a nested
+ * JSON object in the same form @ref submap::store writes.  All integers are
+ * LEB128 varints, signed ones zigzag-encoded.
+ *
+ * Files of either format can be read by @ref mapbuffer, whichever format the
+ * world saves in.
+ */
+namespace submap_binary
+{
+
+constexpr std::string_view magic = "CSMB";
+constexpr int format_version = 1;
+
+// Whether data (the contents of a quad file) is in this format rather than JSON.
+bool is_binary( std::string_view data );
+
+void write_quad( std::ostream &out,
+                 const std::vector<std::pair<tripoint_abs_sm, const submap *>> &submaps );
+
+// Throws std::runtime_error if the data is corrupt.
+std::vector<std::pair<tripoint_abs_sm, std::unique_ptr<submap>>> read_quad( std::string_view data );
+
+} // namespace submap_binary
+
+#endif // CATA_SRC_SUBMAP_BINARY_H
@@ -0,0 +1,124 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+namespace cata
+{
+
+// Set while the current thread is running a pool job, so that nested
+// parallel_for calls degrade to a plain loop instead of deadlocking.
+static thread_local bool in_pool_job = false;
+
+thread_pool::thread_pool( const unsigned int num_workers )
+{
+    workers.reserve( num_workers );
+    for( unsigned int i = 0; i < num_workers; ++i ) {
+        workers.emplace_back( &thread_pool::worker_loop, this );
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        shutting_down = true;
+    }
+    work_ready.notify_all();
+    for( std::thread &worker : workers ) {
+        worker.join();
+    }
+}
+
+void thread_pool::parallel_for( const int begin, const int end,
+                                const std::function<void( int )> &func )
+{
+    if( begin >= end ) {
+        return;
+    }
+    if( workers.empty() || end - begin == 1 || in_pool_job ) {
+        for( int i = begin; i < end; ++i ) {
+            func( i );
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        job = &func;
+        job_end = end;
+        next_index = begin;
+        first_error = nullptr;
+        busy_workers = size();
+        ++generation;
+    }
+    work_ready.notify_all();
+
+    run_jobs();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        work_done.wait( lock, [this]() {
+            return busy_workers == 0;
+        } );
+        job = nullptr;
+        std::swap( error, first_error );
+    }
+    if( error ) {
+        std::rethrow_exception( error );
+    }
+}
+
+void thread_pool::run_jobs()
+{
+    in_pool_job = true;
+    for( int i = next_index++; i < job_end; i = next_index++ ) {
+        try {
+            ( *job )( i );
+        } catch( ... ) {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( !first_error ) {
+                first_error = std::current_exception();
+            }
+        }
+    }
+    in_pool_job = false;
+}
+
+void thread_pool::worker_loop()
+{
+    uint64_t seen_generation = 0;
+    while( true ) {
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            work_ready.wait( lock, [&]() {
+                return shutting_down || generation != seen_generation;
+            } );
+            if( shutting_down ) {
+                return;
+            }
+            seen_generation = generation;
+        }
+        run_jobs();
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( --busy_workers == 0 ) {
+                work_done.notify_one();
+            }
+        }
+    }
+}
+
+thread_pool &get_thread_pool()
+{
+    // Always keep at least one worker so the parallel code paths get exercised
+    // even on single-core machines; the calling thread makes up the rest.
+    static thread_pool pool( std::max( std::thread::hardware_concurrency(), 2U ) - 1 );
+    return pool;
+}
+
+} // namespace cata
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef CATA_SRC_THREAD_POOL_H
+#define CATA_SRC_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cata
+{
+
+/**
+ * A fixed set of worker threads for running independent, data-parallel jobs
+ * (e.g. one job per z-level). Jobs are handed out through @ref parallel_for,
+ * which blocks until every index has been processed, so callers get a simple
+ * barrier between stages without managing threads themselves.
+ *
+ * Jobs must not touch game state that isn't safe to access concurrently. In
+ * particular, nothing run on the pool may open UI (debugmsg, popups, queries).
+ */
+class thread_pool
+{
+    public:
+        explicit thread_pool( unsigned int num_workers );
+        ~thread_pool();
+
+        thread_pool( const thread_pool & ) = delete;
+        thread_pool &operator=( const thread_pool & ) = delete;
+
+        /** Number of worker threads, not counting the calling thread. */
+        unsigned int size() const {
+            return static_cast<unsigned int>( workers.size() );
+        }
+
+        /**
+         * Calls @p func for every index in [begin, end) and returns once all
+         * of them have finished. The calling thread participates in the work.
+         * The order in which indices run is unspecified. If any call throws,
+         * the first exception is rethrown here after all indices are done.
+         */
+        void parallel_for( int begin, int end, const std::function<void( int )> &func );
+
+    private:
+        void worker_loop();
+        void run_jobs();
+
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable work_done;
+
+        // State of the job currently being run, guarded by mutex except
+        // where atomic.
+        const std::function<void( int )> *job = nullptr;
+        int job_end = 0;
+        std::atomic<int> next_index{ 0 };
+        uint64_t generation = 0;
+        unsigned int busy_workers = 0;
+        std::exception_ptr first_error;
+        bool shutting_down = false;
+};
+
+/** Shared pool sized to the hardware, created on first use. */
+thread_pool &get_thread_pool();
+
+} // namespace cata
+
+#endif // CATA_SRC_THREAD_POOL_H
@@ -153,7 +153,7 @@ veh_app_interact::veh_app_interact( vehicle &veh, const point &p )
 // @returns true if a battery part exists on any vehicle connected to veh
 static bool has_battery_in_grid( vehicle *veh )
 {
-    return !veh->search_connected_batteries().empty();
+    return !veh->power_network().batteries.empty();
 }
 
 void veh_app_interact::init_ui_windows()
@@ -252,8 +252,8 @@ void veh_app_interact::draw_info()
 
     // Battery power output
     units::power grid_flow = 0_W;
-    for( const std::pair<vehicle *const, float> &pair : veh->search_connected_vehicles() ) {
-        grid_flow += pair.first->net_battery_charge_rate( /* include_reactors = */ true );
+    for( const vehicle_power_network::node &node : veh->power_network().vehicles ) {
+        grid_flow += node.veh->net_battery_charge_rate( /* include_reactors = */ true );
     }
     print_charge( _( "Grid battery power flow: " ), grid_flow, row );
     row++;
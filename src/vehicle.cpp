@@ -15,7 +15,6 @@
 #include <set>
 #include <sstream>
 #include <tuple>
-#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
@@ -65,6 +64,7 @@
 #include "pimpl.h"
 #include "player_activity.h"
 #include "pocket_type.h"
+#include "profiler.h"
 #include "ret_val.h"
 #include "rng.h"
 #include "sounds.h"
@@ -207,8 +207,12 @@ units::volume vehicle_stack::max_volume() const
 
 // Vehicle class methods.
 
+// Bumped to invalidate every cached vehicle_power_network at once
+static int power_network_generation = 0;
+
 vehicle::vehicle( const vproto_id &proto_id )
 {
+    invalidate_power_networks();
     face.init( 0_degrees );
     move.init( 0_degrees );
 
@@ -229,7 +233,11 @@ vehicle::vehicle( const vproto_id &proto_id )
     }
 }
 
-vehicle::~vehicle() = default;
+vehicle::~vehicle()
+{
+    // other vehicles' networks may point at this one
+    invalidate_power_networks();
+}
 
 turret_cpu::~turret_cpu() = default;
 
@@ -2512,12 +2520,11 @@ std::vector<int> vehicle::parts_at_relative( const point &dp, const bool use_cac
             }
         }
     } else {
-        const auto &iter = relative_parts.find( dp );
-        if( iter != relative_parts.end() ) {
+        if( const std::vector<int> *here = mount_grid.at( dp ) ) {
             if( include_fake ) {
-                return iter->second;
+                return *here;
             } else {
-                for( const int vp : iter->second ) {
+                for( const int vp : *here ) {
                     if( !parts.at( vp ).is_fake ) {
                         res.push_back( vp );
                     }
@@ -2766,18 +2773,74 @@ bool vehicle::has_part( const tripoint &pos, const std::string &flag, bool enabl
 {
     const tripoint relative_pos = pos - global_pos3();
 
-    for( const vpart_reference &vpr : get_all_parts() ) {
-        if( vpr.part().precalc[0] != relative_pos ) {
-            continue;
-        }
-        if( !vpr.part().removed && ( !enabled || vpr.part().enabled ) && !vpr.part().is_broken() &&
-            vpr.part().info().has_flag( flag ) ) {
+    for( const int p : parts_at_tile( relative_pos.xy() ) ) {
+        const vehicle_part &vp = parts[p];
+        if( vp.precalc[0] == relative_pos && !vp.removed && ( !enabled || vp.enabled ) &&
+            !vp.is_broken() && vp.info().has_flag( flag ) ) {
             return true;
         }
     }
     return false;
 }
 
+void vehicle::rebuild_precalc_cache() const
+{
+    point min( INT_MAX, INT_MAX );
+    point max( INT_MIN, INT_MIN );
+    precalc_bounds = inclusive_cuboid<tripoint>( tripoint_zero, tripoint_zero );
+    bool first = true;
+    for( const vehicle_part &vp : parts ) {
+        if( vp.removed ) {
+            continue;
+        }
+        const tripoint &pt = vp.precalc[0];
+        if( first ) {
+            precalc_bounds = inclusive_cuboid<tripoint>( pt, pt );
+            first = false;
+        }
+        precalc_bounds.p_min.x = std::min( precalc_bounds.p_min.x, pt.x );
+        precalc_bounds.p_min.y = std::min( precalc_bounds.p_min.y, pt.y );
+        precalc_bounds.p_min.z = std::min( precalc_bounds.p_min.z, pt.z );
+        precalc_bounds.p_max.x = std::max( precalc_bounds.p_max.x, pt.x );
+        precalc_bounds.p_max.y = std::max( precalc_bounds.p_max.y, pt.y );
+        precalc_bounds.p_max.z = std::max( precalc_bounds.p_max.z, pt.z );
+        if( !vp.is_fake ) {
+            min.x = std::min( min.x, pt.x );
+            min.y = std::min( min.y, pt.y );
+            max.x = std::max( max.x, pt.x );
+            max.y = std::max( max.y, pt.y );
+        }
+    }
+    tile_grid.reset( min, max );
+    for( size_t p = 0; p < parts.size(); p++ ) {
+        const vehicle_part &vp = parts[p];
+        if( !vp.removed && !vp.is_fake ) {
+            tile_grid.at( vp.precalc[0].xy() )->push_back( static_cast<int>( p ) );
+        }
+    }
+    precalc_cache_dirty = false;
+}
+
+const std::vector<int> &vehicle::parts_at_tile( const point &dp ) const
+{
+    static const std::vector<int> none;
+    if( precalc_cache_dirty ) {
+        rebuild_precalc_cache();
+    }
+    const std::vector<int> *here = tile_grid.at( dp );
+    return here != nullptr ? *here : none;
+}
+
+inclusive_cuboid<tripoint> vehicle::occupied_bounds() const
+{
+    if( precalc_cache_dirty ) {
+        rebuild_precalc_cache();
+    }
+    const tripoint origin = global_pos3();
+    return inclusive_cuboid<tripoint>( origin + precalc_bounds.p_min,
+                                       origin + precalc_bounds.p_max );
+}
+
 // NOLINTNEXTLINE(readability-make-member-function-const)
 std::vector<vehicle_part *> vehicle::get_parts_at( const tripoint &pos, const std::string &flag,
         const part_status_flag condition )
@@ -2785,15 +2848,13 @@ std::vector<vehicle_part *> vehicle::get_parts_at( const tripoint &pos, const st
     // TODO: provide access to fake parts via argument ?
     const tripoint relative_pos = pos - global_pos3();
     std::vector<vehicle_part *> res;
-    for( const vpart_reference &vpr : get_all_parts() ) {
-        if( vpr.part().precalc[ 0 ] != relative_pos ) {
-            continue;
-        }
-        if( !vpr.part().removed &&
-            ( flag.empty() || vpr.part().info().has_flag( flag ) ) &&
-            ( !( condition & part_status_flag::enabled ) || vpr.part().enabled ) &&
-            ( !( condition & part_status_flag::working ) || !vpr.part().is_broken() ) ) {
-            res.push_back( &vpr.part() );
+    for( const int p : parts_at_tile( relative_pos.xy() ) ) {
+        vehicle_part &vp = parts[p];
+        if( vp.precalc[0] == relative_pos && !vp.removed &&
+            ( flag.empty() || vp.info().has_flag( flag ) ) &&
+            ( !( condition & part_status_flag::enabled ) || vp.enabled ) &&
+            ( !( condition & part_status_flag::working ) || !vp.is_broken() ) ) {
+            res.push_back( &vp );
         }
     }
     return res;
@@ -2805,15 +2866,46 @@ std::vector<const vehicle_part *> vehicle::get_parts_at( const tripoint &pos,
 {
     const tripoint relative_pos = pos - global_pos3();
     std::vector<const vehicle_part *> res;
-    for( const vpart_reference &vpr : get_all_parts() ) {
-        if( vpr.part().precalc[ 0 ] != relative_pos ) {
-            continue;
+    for( const int p : parts_at_tile( relative_pos.xy() ) ) {
+        const vehicle_part &vp = parts[p];
+        if( vp.precalc[0] == relative_pos && !vp.removed &&
+            ( flag.empty() || vp.info().has_flag( flag ) ) &&
+            ( !( condition & part_status_flag::enabled ) || vp.enabled ) &&
+            ( !( condition & part_status_flag::working ) || !vp.is_broken() ) ) {
+            res.push_back( &vp );
+        }
+    }
+    return res;
+}
+
+// NOLINTNEXTLINE(readability-make-member-function-const)
+std::vector<vehicle_part *> vehicle::get_parts_at( const tripoint &pos, const vpart_bitflags flag,
+        const part_status_flag condition )
+{
+    const tripoint relative_pos = pos - global_pos3();
+    std::vector<vehicle_part *> res;
+    for( const int p : parts_at_tile( relative_pos.xy() ) ) {
+        vehicle_part &vp = parts[p];
+        if( vp.precalc[0] == relative_pos && !vp.removed && vp.info().has_flag( flag ) &&
+            ( !( condition & part_status_flag::enabled ) || vp.enabled ) &&
+            ( !( condition & part_status_flag::working ) || !vp.is_broken() ) ) {
+            res.push_back( &vp );
         }
-        if( !vpr.part().removed &&
-            ( flag.empty() || vpr.part().info().has_flag( flag ) ) &&
-            ( !( condition & part_status_flag::enabled ) || vpr.part().enabled ) &&
-            ( !( condition & part_status_flag::working ) || !vpr.part().is_broken() ) ) {
-            res.push_back( &vpr.part() );
+    }
+    return res;
+}
+
+std::vector<const vehicle_part *> vehicle::get_parts_at( const tripoint &pos,
+        const vpart_bitflags flag, const part_status_flag condition ) const
+{
+    const tripoint relative_pos = pos - global_pos3();
+    std::vector<const vehicle_part *> res;
+    for( const int p : parts_at_tile( relative_pos.xy() ) ) {
+        const vehicle_part &vp = parts[p];
+        if( vp.precalc[0] == relative_pos && !vp.removed && vp.info().has_flag( flag ) &&
+            ( !( condition & part_status_flag::enabled ) || vp.enabled ) &&
+            ( !( condition & part_status_flag::working ) || !vp.is_broken() ) ) {
+            res.push_back( &vp );
         }
     }
     return res;
@@ -3133,9 +3225,9 @@ std::vector<std::vector<int>> vehicle::find_lines_of_parts(
 
 int vehicle::part_at( const point &dp ) const
 {
-    for( const vpart_reference &vp : get_all_parts() ) {
-        if( vp.part().precalc[0].xy() == dp && !vp.part().removed ) {
-            return static_cast<int>( vp.part_index() );
+    for( const int p : parts_at_tile( dp ) ) {
+        if( !parts[p].removed ) {
+            return p;
         }
     }
     return -1;
@@ -3255,28 +3347,70 @@ tripoint vehicle::mount_to_tripoint( const point &mount, const point &offset ) c
     return global_pos3() + mnt_translated;
 }
 
+int vehicle::rotation_table_index( const units::angle &dir )
+{
+    // Facings that were rounded to or built from steer_increments are rarely exact multiples.
+    const double steps = normalize( dir ) / vehicles::steer_increment;
+    const int index = std::lround( steps );
+    if( std::abs( steps - index ) > 1e-6 ) {
+        return -1;
+    }
+    return index % static_cast<int>( 360_degrees / vehicles::steer_increment );
+}
+
+const vehicle::rotation_table *vehicle::rotation_table_for( const units::angle &dir,
+        const point &pivot )
+{
+    const int index = rotation_table_index( dir );
+    if( index < 0 ) {
+        return nullptr;
+    }
+    rotation_table &table = rotation_tables[index];
+    if( table.offsets.size() != parts.size() || table.pivot != pivot ) {
+        tileray tdir( index * vehicles::steer_increment );
+        table.pivot = pivot;
+        table.offsets.resize( parts.size() );
+        for( size_t i = 0; i < parts.size(); i++ ) {
+            // parts sharing a mount are usually adjacent
+            if( i > 0 && parts[i].mount == parts[i - 1].mount ) {
+                table.offsets[i] = table.offsets[i - 1];
+                continue;
+            }
+            tripoint q;
+            coord_translate( tdir, pivot, parts[i].mount, q );
+            table.offsets[i] = q.xy();
+        }
+    }
+    return &table;
+}
+
 void vehicle::precalc_mounts( int idir, const units::angle &dir,
                               const point &pivot )
 {
     if( idir < 0 || idir > 1 ) {
         idir = 0;
     }
-    tileray tdir( dir );
-    std::unordered_map<point, tripoint> mount_to_precalc;
-    for( vehicle_part &p : parts ) {
-        if( p.removed ) {
-            continue;
+    if( const rotation_table *table = rotation_table_for( dir, pivot ) ) {
+        for( size_t i = 0; i < parts.size(); i++ ) {
+            vehicle_part &p = parts[i];
+            if( !p.removed ) {
+                p.precalc[idir].x = table->offsets[i].x;
+                p.precalc[idir].y = table->offsets[i].y;
+            }
         }
-        auto q = mount_to_precalc.find( p.mount );
-        if( q == mount_to_precalc.end() ) {
-            coord_translate( tdir, pivot, p.mount, p.precalc[idir] );
-            mount_to_precalc.insert( { p.mount, p.precalc[idir] } );
-        } else {
-            p.precalc[idir] = q->second;
+    } else {
+        tileray tdir( dir );
+        for( vehicle_part &p : parts ) {
+            if( !p.removed ) {
+                coord_translate( tdir, pivot, p.mount, p.precalc[idir] );
+            }
         }
     }
     pivot_anchor[idir] = pivot;
     pivot_rotation[idir] = dir;
+    if( idir == 0 ) {
+        precalc_cache_dirty = true;
+    }
 }
 
 std::vector<int> vehicle::boarded_parts() const
@@ -3438,9 +3572,9 @@ int64_t vehicle::fuel_left( const itype_id &ftype,
 {
     int64_t fl = 0;
     if( ftype == fuel_type_battery ) {
-        for( const std::pair<const vehicle *const, float> &pair : search_connected_vehicles() ) {
-            const vehicle &veh = *pair.first;
-            const float loss = pair.second;
+        for( const vehicle_power_network::node &node : power_network().vehicles ) {
+            const vehicle &veh = *node.veh;
+            const float loss = node.loss;
             for( const int part_idx : veh.batteries ) {
                 const vehicle_part &vp = veh.parts[part_idx];
                 if( vp.ammo_current() != fuel_type_battery || !filter( vp ) ) {
@@ -3501,15 +3635,7 @@ int vehicle::engine_fuel_left( const vehicle_part &vp ) const
 int vehicle::fuel_capacity( const itype_id &ftype ) const
 {
     if( ftype == fuel_type_battery ) { // batteries get special treatment due to power cables
-        int64_t capacity = 0;
-        for( const std::pair<const vehicle *const, float> &pair : search_connected_vehicles() ) {
-            const vehicle &veh = *pair.first;
-            for( const int part_idx : veh.batteries ) {
-                const vehicle_part &vp = veh.parts[part_idx];
-                capacity += vp.ammo_capacity( fuel_type_battery->ammo->type );
-            }
-        }
-        return capacity;
+        return power_network().capacity;
     }
     const vehicle_part_range vpr = get_all_parts();
     return std::accumulate( vpr.begin(), vpr.end(), int64_t { 0 },
@@ -4948,10 +5074,10 @@ std::pair<int, int> vehicle::connected_battery_power_level() const
     int total_epower_remaining = 0;
     int total_epower_capacity = 0;
 
-    for( const std::pair<const vehicle *const, float> &pair : search_connected_vehicles() ) {
+    for( const vehicle_power_network::node &node : power_network().vehicles ) {
         int epower_remaining;
         int epower_capacity;
-        std::tie( epower_remaining, epower_capacity ) = pair.first->battery_power_level();
+        std::tie( epower_remaining, epower_capacity ) = node.veh->battery_power_level();
         total_epower_remaining += epower_remaining;
         total_epower_capacity += epower_capacity;
     }
@@ -5359,59 +5485,59 @@ void vehicle::get_connected_vehicles( std::unordered_set<vehicle *> &dest )
     }
 }
 
-std::map<vpart_reference, float> vehicle::search_connected_batteries()
+const vehicle_power_network &vehicle::power_network() const
 {
-    std::map<vpart_reference, float> result;
-
-    for( const std::pair<vehicle *const, float> &pair : search_connected_vehicles() ) {
+    vehicle_power_network &net = power_network_cache;
+    if( net.generation == power_network_generation ) {
+        return net;
+    }
+    net.vehicles.clear();
+    net.batteries.clear();
+    net.capacity = 0;
+    double loss = 0.0; // sum of power losses weighted by capacity
+    for( const std::pair<vehicle *const, float> &pair :
+         search_connected_vehicles( const_cast<vehicle *>( this ) ) ) {
         vehicle *veh = pair.first;
-        const float efficiency = pair.second;
+        net.vehicles.push_back( { veh, pair.second } );
         for( const int part_idx : veh->batteries ) {
-            const vpart_reference vpr( *veh, part_idx );
-            if( vpr.part().is_fake ) {
+            const vehicle_part &vp = veh->part( part_idx );
+            if( vp.is_fake ) {
                 continue;
             }
-            result.emplace( vpr, efficiency );
+            const int capacity = vp.ammo_capacity( ammo_battery );
+            net.batteries.push_back( { veh, part_idx, pair.second, capacity } );
+            net.capacity += capacity;
+            loss += pair.second * capacity;
         }
     }
-
-    return result;
+    net.loss = loss / net.capacity;
+    // searching may have loaded vehicles, which invalidates the networks; this one includes them
+    net.generation = power_network_generation;
+    return net;
 }
 
-// helper method to calculate power loss weighted by capacity
-static double weighted_power_loss( const std::map<vpart_reference, float> &batteries )
+void vehicle::invalidate_power_networks()
 {
-    double res = 0.0; // sum of power losses
-    int64_t total_capacity = 0; // sum of capacity of all batteries
-    for( const std::pair<const vpart_reference, float> &pair : batteries ) {
-        vehicle_part &vp = pair.first.part();
-        const int capacity = vp.ammo_capacity( ammo_battery );
-        total_capacity += capacity;
-        res += pair.second * capacity;
-    }
-    return res / total_capacity;
+    power_network_generation++;
 }
 
-// helper method to take a map of batteries, amount of charge, total capacity of batteries
-// and distribute given charge_kj over the batteries as evenly as possible
-static void distribute_charge_evenly( const std::map<vpart_reference, float> &batteries,
-                                      int64_t charge_kj, int64_t total_capacity_kj )
+// helper method to take a power network, amount of charge and distribute given charge_kj
+// over its batteries as evenly as possible
+static void distribute_charge_evenly( const vehicle_power_network &net, int64_t charge_kj )
 {
     int64_t distributed = 0;
-    for( const std::pair<const vpart_reference, float> &pair : batteries ) {
-        vehicle_part &vp = pair.first.part();
-        const int bat_capacity = vp.ammo_capacity( ammo_battery );
-        const float fraction = static_cast<float>( bat_capacity ) / total_capacity_kj;
+    for( const vehicle_power_network::battery &bat : net.batteries ) {
+        vehicle_part &vp = bat.veh->part( bat.part );
+        const float fraction = static_cast<float>( bat.capacity ) / net.capacity;
         const int portion = charge_kj * fraction;
         vp.ammo_set( fuel_type_battery, portion );
         distributed += portion;
     }
     if( distributed < charge_kj ) { // dump indivisible remainder sequentially
-        for( const std::pair<const vpart_reference, float> &pair : batteries ) {
-            vehicle_part &vp = pair.first.part();
+        for( const vehicle_power_network::battery &bat : net.batteries ) {
+            vehicle_part &vp = bat.veh->part( bat.part );
             const int64_t bat_charge = vp.ammo_remaining();
-            const int64_t bat_capacity = vp.ammo_capacity( ammo_battery );
-            const int chargeable = std::min( charge_kj - distributed, bat_capacity - bat_charge );
+            const int chargeable = std::min( charge_kj - distributed, bat.capacity - bat_charge );
             vp.ammo_set( fuel_type_battery, bat_charge + chargeable );
             distributed += chargeable;
             if( distributed >= charge_kj ) {
@@ -5424,12 +5550,22 @@ static void distribute_charge_evenly( const std::map<vpart_reference, float> &ba
     }
 }
 
+// sum of current charge of all batteries in the network
+static int64_t network_charge( const vehicle_power_network &net )
+{
+    int64_t charge = 0;
+    for( const vehicle_power_network::battery &bat : net.batteries ) {
+        charge += bat.veh->part( bat.part ).ammo_remaining();
+    }
+    return charge;
+}
+
 int64_t vehicle::battery_left( bool apply_loss ) const
 {
     int64_t ret = 0;
-    for( const std::pair<const vehicle *const, float> &pair : search_connected_vehicles() ) {
-        const vehicle &veh = *pair.first;
-        const float efficiency = 1.0f - ( apply_loss ? pair.second : 0.0f );
+    for( const vehicle_power_network::node &node : power_network().vehicles ) {
+        const vehicle &veh = *node.veh;
+        const float efficiency = 1.0f - ( apply_loss ? node.loss : 0.0f );
         for( const int part_idx : veh.batteries ) {
             const vehicle_part &vp = veh.parts[part_idx];
             ret += vp.ammo_remaining() * efficiency;
@@ -5447,19 +5583,13 @@ int vehicle::charge_battery( int amount, bool apply_loss )
     if( amount == 0 ) {
         return 0;
     }
-    const std::map<vpart_reference, float> batteries = search_connected_batteries();
-    if( batteries.empty() ) {
+    const vehicle_power_network &net = power_network();
+    if( net.batteries.empty() ) {
         return amount;
     }
-    const double loss = apply_loss ? weighted_power_loss( batteries ) : 0.0;
-    int64_t total_charge = 0; // sum of current charge of all batteries
-    int64_t total_capacity = 0; // sum of capacity of all batteries
-    for( const std::pair<const vpart_reference, float> &pair : batteries ) {
-        vehicle_part &vp = pair.first.part();
-        total_charge += vp.ammo_remaining();
-        total_capacity += vp.ammo_capacity( ammo_battery );
-    }
-    const int64_t chargeable = total_capacity - total_charge;
+    const double loss = apply_loss ? net.loss : 0.0;
+    int64_t total_charge = network_charge( net );
+    const int64_t chargeable = net.capacity - total_charge;
     int64_t lost_amount = roll_remainder( amount * loss );
     int64_t lossy_amount = amount;
     int64_t charged = amount - lost_amount;
@@ -5472,11 +5602,12 @@ int vehicle::charge_battery( int amount, bool apply_loss )
     const int tried_charging = amount;
     amount -= charged + lost_amount;
 
-    distribute_charge_evenly( batteries, total_charge, total_capacity );
+    distribute_charge_evenly( net, total_charge );
 
     add_msg_debug( debugmode::DF_VEHICLE,
                    "batteries: %d, loss: %.3f, tried charging: %d kJ, actual charged: %d kJ, usable: %d kJ, lost: %d kJ, excess: %d kJ",
-                   batteries.size(), loss, tried_charging, lossy_amount, charged, lost_amount, amount );
+                   net.batteries.size(), loss, tried_charging, lossy_amount, charged, lost_amount,
+                   amount );
 
     return amount; // non zero if batteries couldn't absorb the entire amount
 }
@@ -5490,18 +5621,12 @@ int vehicle::discharge_battery( int amount, bool apply_loss )
     if( amount == 0 ) {
         return 0;
     }
-    const std::map<vpart_reference, float> batteries = search_connected_batteries();
-    if( batteries.empty() ) {
+    const vehicle_power_network &net = power_network();
+    if( net.batteries.empty() ) {
         return amount;
     }
-    const double loss = apply_loss ? weighted_power_loss( batteries ) : 0.0;
-    int64_t total_charge = 0; // sum of current charge of all batteries
-    int64_t total_capacity = 0; // sum of capacity of all batteries
-    for( const std::pair<const vpart_reference, float> &pair : batteries ) {
-        vehicle_part &vp = pair.first.part();
-        total_charge += vp.ammo_remaining();
-        total_capacity += vp.ammo_capacity( ammo_battery );
-    }
+    const double loss = apply_loss ? net.loss : 0.0;
+    int64_t total_charge = network_charge( net );
 
     int64_t discharged = amount;
     int64_t lost_amount = roll_remainder( amount * loss );
@@ -5515,11 +5640,11 @@ int vehicle::discharge_battery( int amount, bool apply_loss )
     const int tried_discharging = amount;
     amount -= discharged;
 
-    distribute_charge_evenly( batteries, total_charge, total_capacity );
+    distribute_charge_evenly( net, total_charge );
 
     add_msg_debug( debugmode::DF_VEHICLE,
                    "batteries: %d, loss: %.3f, tried discharging: %d kJ, actual discharged: %d kJ, usable: %d kJ, lost: %d kJ, missing: %d kJ",
-                   batteries.size(), loss, tried_discharging, lossy_amount, discharged, lost_amount,
+                   net.batteries.size(), loss, tried_discharging, lossy_amount, discharged, lost_amount,
                    amount );
 
     return amount; // non zero if batteries couldn't provide the entire amount
@@ -5542,6 +5667,7 @@ void vehicle::do_engine_damage( vehicle_part &vp, int strain )
 
 void vehicle::idle( bool on_map )
 {
+    CATA_PROFILE_ZONE( "vehicle::idle" );
     avg_velocity = ( velocity + avg_velocity ) / 2;
 
     power_parts();
@@ -5629,7 +5755,7 @@ void vehicle::idle( bool on_map )
     }
 
     // Notify player about status of all turrets if they're at controls
-    bool player_at_controls = !get_parts_at( player_character.pos(), "CONTROLS",
+    bool player_at_controls = !get_parts_at( player_character.pos(), VPFLAG_CONTROLS,
                               part_status_flag::working ).empty();
 
     for( vehicle_part *turret : turrets() ) {
@@ -5745,7 +5871,7 @@ void vehicle::disable_smart_controller_if_needed()
 void vehicle::make_active( item_location &loc )
 {
     item &target = *loc;
-    auto cargo_parts = get_parts_at( loc.position(), "CARGO", part_status_flag::any );
+    auto cargo_parts = get_parts_at( loc.position(), VPFLAG_CARGO, part_status_flag::any );
     if( cargo_parts.empty() ) {
         return;
     }
@@ -6098,6 +6224,11 @@ void vehicle::refresh_active_item_cache()
  */
 void vehicle::refresh( const bool remove_fakes )
 {
+    precalc_cache_dirty = true;
+    invalidate_power_networks();
+    for( rotation_table &table : rotation_tables ) {
+        table.offsets.clear();
+    }
     if( no_refresh ) {
         return;
     }
@@ -6111,7 +6242,6 @@ void vehicle::refresh( const bool remove_fakes )
     water_wheels.clear();
     funnels.clear();
     emitters.clear();
-    relative_parts.clear();
     loose_parts.clear();
     wheelcache.clear();
     rail_wheelcache.clear();
@@ -6146,6 +6276,20 @@ void vehicle::refresh( const bool remove_fakes )
     mount_max.x = -123;
     mount_max.y = -123;
 
+    // Size the grid up front so the main loop can file parts into it; fake parts hang at most
+    // one row beside a real part, and surviving fakes may predate the current bounds.
+    point grid_min( 123, 123 );
+    point grid_max( -123, -123 );
+    for( const vehicle_part &vp : parts ) {
+        if( !vp.removed ) {
+            grid_min.x = std::min( grid_min.x, vp.mount.x );
+            grid_min.y = std::min( grid_min.y, vp.mount.y - 1 );
+            grid_max.x = std::max( grid_max.x, vp.mount.x );
+            grid_max.y = std::max( grid_max.y, vp.mount.y + 1 );
+        }
+    }
+    mount_grid.reset( grid_min, grid_max );
+
     int railwheel_xmin = INT_MAX;
     int railwheel_ymin = INT_MAX;
     int railwheel_xmax = INT_MIN;
@@ -6173,10 +6317,10 @@ void vehicle::refresh( const bool remove_fakes )
         mount_max.y = std::max( mount_max.y, pt.y );
 
         // This will keep the parts at point pt sorted
-        std::vector<int>::iterator vii = std::lower_bound( relative_parts[pt].begin(),
-                                         relative_parts[pt].end(),
+        std::vector<int> &parts_here = *mount_grid.at( pt );
+        std::vector<int>::iterator vii = std::lower_bound( parts_here.begin(), parts_here.end(),
                                          static_cast<int>( p ), svpv );
-        relative_parts[pt].insert( vii, p );
+        parts_here.insert( vii, p );
 
         //If it doesn't leak or it's health is less than 50% then The hull has been breached and the air is leaking out
         if( vpi.has_flag( VPFLAG_FLOATS ) && ( vpi.has_flag( VPFLAG_NO_LEAK ) ||
@@ -6325,7 +6469,7 @@ void vehicle::refresh( const bool remove_fakes )
             vehicle_part &part_real = parts.at( real_index );
             if( part_real.has_fake &&
                 static_cast<size_t>( part_real.fake_part_at ) < parts.size() ) {
-                relative_parts[ parts[ part_real.fake_part_at ].mount ].push_back(
+                mount_grid.at( parts[ part_real.fake_part_at ].mount )->push_back(
                     part_real.fake_part_at );
                 return;
             }
@@ -6335,7 +6479,7 @@ void vehicle::refresh( const bool remove_fakes )
             part_fake.fake_part_to = real_index;
             part_fake.mount += edge_info.is_left_edge() ? point_north : point_south;
             if( part_real.info().has_flag( "PROTRUSION" ) ) {
-                for( const int vp : relative_parts.at( part_real.mount ) ) {
+                for( const int vp : *mount_grid.at( part_real.mount ) ) {
                     if( parts.at( vp ).is_fake ) {
                         part_fake.fake_protrusion_on = vp;
                         break;
@@ -6345,7 +6489,7 @@ void vehicle::refresh( const bool remove_fakes )
             int fake_index = parts.size();
             part_real.fake_part_at = fake_index;
             fake_parts.push_back( fake_index );
-            relative_parts[ part_fake.mount ].push_back( fake_index );
+            mount_grid.at( part_fake.mount )->push_back( fake_index );
             edges.emplace( real_mount, edge_info );
             parts.push_back( std::move( part_fake ) );
         }
@@ -6354,8 +6498,8 @@ void vehicle::refresh( const bool remove_fakes )
     // guarantee that the fake parts were removed before being added
     if( remove_fakes && !has_tag( "wreckage" ) && !is_appliance() ) {
         // add all the obstacles first
-        for( const std::pair <const point, std::vector<int>> &rp : relative_parts ) {
-            add_fake_part( rp.first, "OBSTACLE" );
+        for( const point &mount : mount_grid.occupied() ) {
+            add_fake_part( mount, "OBSTACLE" );
         }
         // then add protrusions that hanging on top of fake obstacles.
 
@@ -6365,21 +6509,20 @@ void vehicle::refresh( const bool remove_fakes )
         }
 
         // add fake camera parts so vision isn't blocked by fake parts
-        for( const std::pair <const point, std::vector<int>> &rp : relative_parts ) {
-            add_fake_part( rp.first, "CAMERA" );
+        for( const point &mount : mount_grid.occupied() ) {
+            add_fake_part( mount, "CAMERA" );
         }
         // add fake curtains so vision is correctly blocked
-        for( const std::pair <const point, std::vector<int>> &rp : relative_parts ) {
-            add_fake_part( rp.first, "OPAQUE" );
+        for( const point &mount : mount_grid.occupied() ) {
+            add_fake_part( mount, "OPAQUE" );
         }
     } else {
-        // Always repopulate fake parts in relative_parts cache since we cleared it.
+        // Always repopulate fake parts in mount_grid cache since we cleared it.
         for( const int fake_index : fake_parts ) {
             if( parts[fake_index].removed ) {
                 continue;
             }
-            point pt = parts[fake_index].mount;
-            relative_parts[pt].push_back( fake_index );
+            mount_grid.at( parts[fake_index].mount )->push_back( fake_index );
         }
     }
 
@@ -6408,27 +6551,23 @@ vpart_edge_info vehicle::get_edge_info( const point &mount ) const
     int r_index = -1;
     bool left_side = false;
     bool right_side = false;
-    if( relative_parts.find( forward ) != relative_parts.end() &&
-        !parts.at( relative_parts.at( forward ).front() ).is_fake ) {
-        f_index = relative_parts.at( forward ).front();
-    }
-    if( relative_parts.find( aft ) != relative_parts.end() &&
-        !parts.at( relative_parts.at( aft ).front() ).is_fake ) {
-        a_index = relative_parts.at( aft ).front();
-    }
-    if( relative_parts.find( left ) != relative_parts.end() &&
-        !parts.at( relative_parts.at( left ).front() ).is_fake ) {
-        l_index = relative_parts.at( left ).front();
-        if( parts.at( relative_parts.at( left ).front() ).info().has_flag( "PROTRUSION" ) ) {
-            left_side = true;
+    // first part at mount, or -1 if there are none or it is a fake part
+    const auto real_part_at = [&]( const point & pt ) {
+        const std::vector<int> *here = mount_grid.at( pt );
+        if( here == nullptr || here->empty() || parts.at( here->front() ).is_fake ) {
+            return -1;
         }
+        return here->front();
+    };
+    f_index = real_part_at( forward );
+    a_index = real_part_at( aft );
+    l_index = real_part_at( left );
+    if( l_index != -1 && parts.at( l_index ).info().has_flag( "PROTRUSION" ) ) {
+        left_side = true;
     }
-    if( relative_parts.find( right ) != relative_parts.end() &&
-        !parts.at( relative_parts.at( right ).front() ).is_fake ) {
-        r_index = relative_parts.at( right ).front();
-        if( parts.at( relative_parts.at( right ).front() ).info().has_flag( "PROTRUSION" ) ) {
-            right_side = true;
-        }
+    r_index = real_part_at( right );
+    if( r_index != -1 && parts.at( r_index ).info().has_flag( "PROTRUSION" ) ) {
+        right_side = true;
     }
     return vpart_edge_info( f_index, a_index, l_index, r_index, left_side, right_side );
 }
@@ -6896,6 +7035,10 @@ void vehicle::remove_remote_part( const vehicle_part &vp_local ) const
 void vehicle::shed_loose_parts( const trinary shed_cables, const tripoint_bub_ms *dst )
 {
     map &here = get_map();
+    if( !loose_parts.empty() ) {
+        // cables are retargeted or dropped below
+        invalidate_power_networks();
+    }
     // remove_part rebuilds the loose_parts vector, so iterate over a copy to preserve
     // power transfer lines that still have some slack to them
     std::vector<int> lp = loose_parts;
@@ -6987,7 +7130,7 @@ void vehicle::unlink_cables( const point &mount, Character &remover,
 bool vehicle::enclosed_at( const tripoint &pos )
 {
     refresh_insides();
-    std::vector<vehicle_part *> parts_here = get_parts_at( pos, "BOARDABLE",
+    std::vector<vehicle_part *> parts_here = get_parts_at( pos, VPFLAG_BOARDABLE,
             part_status_flag::working );
     if( !parts_here.empty() ) {
         return parts_here.front()->inside;
@@ -7642,19 +7785,74 @@ bool vehicle::restore_folded_parts( const item &it )
     return true;
 }
 
-const std::set<tripoint> &vehicle::get_points( const bool force_refresh, const bool no_fake ) const
+void vehicle_part_grid::reset( const point &min, const point &max )
+{
+    if( max.x < min.x || max.y < min.y ) {
+        clear();
+        return;
+    }
+    this->min = min;
+    width = max.x - min.x + 1;
+    height = max.y - min.y + 1;
+    // keep the cells' storage around, refresh() rebuilds the grid often
+    cells.resize( static_cast<size_t>( width ) * height );
+    for( std::vector<int> &cell : cells ) {
+        cell.clear();
+    }
+}
+
+void vehicle_part_grid::clear()
+{
+    width = 0;
+    height = 0;
+    cells.clear();
+}
+
+std::vector<int> *vehicle_part_grid::at( const point &p )
+{
+    const point rel = p - min;
+    if( rel.x < 0 || rel.y < 0 || rel.x >= width || rel.y >= height ) {
+        return nullptr;
+    }
+    return &cells[static_cast<size_t>( rel.x ) * height + rel.y];
+}
+
+const std::vector<int> *vehicle_part_grid::at( const point &p ) const
+{
+    return const_cast<vehicle_part_grid *>( this )->at( p );
+}
+
+std::vector<point> vehicle_part_grid::occupied() const
+{
+    std::vector<point> res;
+    for( size_t i = 0; i < cells.size(); i++ ) {
+        if( !cells[i].empty() ) {
+            const int idx = static_cast<int>( i );
+            res.emplace_back( min + point( idx / height, idx % height ) );
+        }
+    }
+    return res;
+}
+
+const std::vector<tripoint> &vehicle::get_points( const bool force_refresh,
+        const bool no_fake ) const
 {
     if( force_refresh || occupied_cache_pos != global_pos3() ||
         occupied_cache_direction != face.dir() ) {
         occupied_cache_pos = global_pos3();
         occupied_cache_direction = face.dir();
         occupied_points.clear();
-        for( const std::pair<const point, std::vector<int>> &part_location : relative_parts ) {
-            if( no_fake && part( part_location.second.front() ).is_fake ) {
+        for( const point &mount : mount_grid.occupied() ) {
+            const int first = mount_grid.at( mount )->front();
+            if( no_fake && part( first ).is_fake ) {
                 continue;
             }
-            occupied_points.insert( global_part_pos3( part_location.second.front() ) );
+            occupied_points.push_back( global_part_pos3( first ) );
         }
+        // rotated mounts may share a tile
+        std::sort( occupied_points.begin(), occupied_points.end() );
+        occupied_points.erase( std::unique( occupied_points.begin(), occupied_points.end() ),
+                               occupied_points.end() );
     }
 
     return occupied_points;
@@ -7817,50 +8015,60 @@ void vehicle::update_time( const time_point &update_to )
     if( funnels.empty() && solar_panels.empty() && wind_turbines.empty() && water_wheels.empty() ) {
         return;
     }
-    // Get one weather data set per vehicle, they don't differ much across vehicle area
-    const weather_sum accum_weather = sum_conditions( update_from, update_to,
-                                      global_square_location() );
-    // make some reference objects to use to check for reload
-    const item water( "water" );
-    const item water_clean( "water_clean" );
+    // Get one weather data set per vehicle, they don't differ much across vehicle area.
+    // Only funnels and solar panels use it, turbines and wheels go by current conditions.
+    weather_sum accum_weather;
+    if( !funnels.empty() || !solar_panels.empty() ) {
+        accum_weather = sum_conditions( update_from, update_to, global_square_location() );
+    }
+    if( !funnels.empty() ) {
+        // make some reference objects to use to check for reload
+        const item water( "water" );
+        const item water_clean( "water_clean" );
 
-    for( int idx : funnels ) {
-        const vehicle_part &pt = parts[idx];
+        for( int idx : funnels ) {
+            const vehicle_part &pt = parts[idx];
 
-        // we need an unbroken funnel mounted on the exterior of the vehicle
-        if( pt.is_unavailable() || !is_sm_tile_outside( here.getabs( global_part_pos3( pt ) ) ) ) {
-            continue;
-        }
+            // we need an unbroken funnel mounted on the exterior of the vehicle
+            if( pt.is_unavailable() ||
+                !is_sm_tile_outside( here.getabs( global_part_pos3( pt ) ) ) ) {
+                continue;
+            }
 
-        // we need an empty tank (or one already containing water) below the funnel
-        auto tank = std::find_if( parts.begin(), parts.end(), [&]( const vehicle_part & e ) {
-            return pt.mount == e.mount && e.is_tank() &&
-                   ( e.can_reload( water ) || e.can_reload( water_clean ) );
-        } );
+            // we need an empty tank (or one already containing water) below the funnel
+            auto tank = std::find_if( parts.begin(), parts.end(), [&]( const vehicle_part & e ) {
+                return pt.mount == e.mount && e.is_tank() &&
+                       ( e.can_reload( water ) || e.can_reload( water_clean ) );
+            } );
 
-        if( tank == parts.end() ) {
-            continue;
-        }
+            if( tank == parts.end() ) {
+                continue;
+            }
 
-        const double area_in_mm2 = std::pow( pt.info().bonus, 2 ) * M_PI;
-        const int qty = roll_remainder( funnel_charges_per_turn( area_in_mm2, accum_weather.rain_amount ) );
-        int c_qty = qty + ( tank->can_reload( water_clean ) ?  tank->ammo_remaining() : 0 );
-        int cost_to_purify = c_qty * itype_water_purifier->charges_to_use();
+            const double area_in_mm2 = std::pow( pt.info().bonus, 2 ) * M_PI;
+            const int qty = roll_remainder( funnel_charges_per_turn( area_in_mm2,
+                                            accum_weather.rain_amount ) );
+            int c_qty = qty + ( tank->can_reload( water_clean ) ?  tank->ammo_remaining() : 0 );
+            int cost_to_purify = c_qty * itype_water_purifier->charges_to_use();
 
-        if( qty > 0 ) {
-            const std::optional<vpart_reference> vp_purifier = vpart_position( *this, idx )
-                    .part_with_tool( itype_water_purifier );
+            if( qty > 0 ) {
+                const std::optional<vpart_reference> vp_purifier = vpart_position( *this, idx )
+                        .part_with_tool( itype_water_purifier );
 
-            if( vp_purifier && ( fuel_left( itype_battery ) > cost_to_purify ) ) {
-                tank->ammo_set( itype_water_clean, c_qty );
-                discharge_battery( cost_to_purify );
-            } else {
-                tank->ammo_set( itype_water, tank->ammo_remaining() + qty );
+                if( vp_purifier && ( fuel_left( itype_battery ) > cost_to_purify ) ) {
+                    tank->ammo_set( itype_water_clean, c_qty );
+                    discharge_battery( cost_to_purify );
+                } else {
+                    tank->ammo_set( itype_water, tank->ammo_remaining() + qty );
+                }
+                invalidate_mass();
             }
-            invalidate_mass();
         }
     }
 
+    // charge once with the sum of all sources, so the power network is only walked
+    // and clamped to its capacity a single time
+    int energy_bat = 0;
     if( !solar_panels.empty() ) {
         units::power epower = 0_W;
         for( const int p : solar_panels ) {
@@ -7873,30 +8081,36 @@ void vehicle::update_time( const time_point &update_to )
         }
         double intensity = accum_weather.radiant_exposure / max_sun_irradiance() / to_seconds<float>
                            ( elapsed );
-        int energy_bat = power_to_energy_bat( epower * intensity, elapsed );
-        if( energy_bat > 0 ) {
-            add_msg_debug( debugmode::DF_VEHICLE, "%s got %d kJ energy from solar panels", name, energy_bat );
-            charge_battery( energy_bat );
+        int solar_bat = power_to_energy_bat( epower * intensity, elapsed );
+        if( solar_bat > 0 ) {
+            add_msg_debug( debugmode::DF_VEHICLE, "%s got %d kJ energy from solar panels", name,
+                           solar_bat );
+            energy_bat += solar_bat;
         }
     }
     if( !wind_turbines.empty() ) {
         // TODO: use accum_weather wind data to backfill wind turbine
         // generation capacity.
         units::power epower = total_wind_epower();
-        int energy_bat = power_to_energy_bat( epower, elapsed );
-        if( energy_bat > 0 ) {
-            add_msg_debug( debugmode::DF_VEHICLE, "%s got %d kJ energy from wind turbines", name, energy_bat );
-            charge_battery( energy_bat );
+        int wind_bat = power_to_energy_bat( epower, elapsed );
+        if( wind_bat > 0 ) {
+            add_msg_debug( debugmode::DF_VEHICLE, "%s got %d kJ energy from wind turbines", name,
+                           wind_bat );
+            energy_bat += wind_bat;
         }
     }
     if( !water_wheels.empty() ) {
         units::power epower = total_water_wheel_epower();
-        int energy_bat = power_to_energy_bat( epower, elapsed );
-        if( energy_bat > 0 ) {
-            add_msg_debug( debugmode::DF_VEHICLE, "%s got %d kJ energy from water wheels", name, energy_bat );
-            charge_battery( energy_bat );
+        int water_bat = power_to_energy_bat( epower, elapsed );
+        if( water_bat > 0 ) {
+            add_msg_debug( debugmode::DF_VEHICLE, "%s got %d kJ energy from water wheels", name,
+                           water_bat );
+            energy_bat += water_bat;
         }
     }
+    if( energy_bat > 0 ) {
+        charge_battery( energy_bat );
+    }
 }
 
 void vehicle::invalidate_mass()
@@ -8072,6 +8286,7 @@ std::set<int> vehicle::advance_precalc_mounts( const point &new_pos, const tripo
 {
     map &here = get_map();
     std::set<int> smzs;
+    precalc_cache_dirty = true;
     // when a vehicle part enters the low end of a down ramp, or the high end of an up ramp,
     // it immediately translates down or up a z-level, respectively, ending up on the low
     // end of an up ramp or high end of a down ramp, respectively.  The two ends are set
@@ -8223,7 +8438,8 @@ tripoint vehicle::exhaust_dest( int part ) const
 {
     point p = parts[part].mount;
     // Move back from engine/muffler until we find an open space
-    while( relative_parts.find( p ) != relative_parts.end() ) {
+    for( const std::vector<int> *here = mount_grid.at( p ); here != nullptr && !here->empty();
+         here = mount_grid.at( p ) ) {
         p.x += ( velocity < 0 ? 1 : -1 );
     }
     point q = coord_translate( p );
@@ -25,6 +25,7 @@
 #include "clzones.h"
 #include "colony.h"
 #include "coordinates.h"
+#include "cuboid_rectangle.h"
 #include "damage.h"
 #include "game_constants.h"
 #include "item.h"
@@ -219,6 +220,56 @@ struct bounding_box {
     point p2;
 };
 
+/**
+ * Dense grid of part index lists covering a rectangle of vehicle-relative points, used to find
+ * the parts at a mount point (or tile) without walking the whole part list.
+ */
+class vehicle_part_grid
+{
+    public:
+        /** Empties every cell and resizes the grid to cover @p min to @p max inclusive */
+        void reset( const point &min, const point &max );
+        void clear();
+        /** Cell at @p p, or nullptr if @p p is outside the grid */
+        std::vector<int> *at( const point &p );
+        const std::vector<int> *at( const point &p ) const;
+        /** Points of all non-empty cells, in the same order a std::map<point, ...> would use */
+        std::vector<point> occupied() const;
+    private:
+        point min;
+        int width = 0;
+        int height = 0;
+        std::vector<std::vector<int>> cells;
+};
+
+/**
+ * Everything reachable from a vehicle over POWER_TRANSFER parts: the connected vehicles
+ * (including the vehicle itself) and their batteries, each with the line loss from the vehicle.
+ * Ordered like the std::map search_connected_vehicles() returns.
+ */
+struct vehicle_power_network {
+    struct node {
+        vehicle *veh;
+        // 0.01 corresponds to 1% charge loss to wire resistance
+        float loss;
+    };
+    struct battery {
+        vehicle *veh;
+        int part;
+        float loss;
+        int capacity;
+    };
+    std::vector<node> vehicles;
+    std::vector<battery> batteries;
+    // sum of the capacity of all batteries
+    int64_t capacity = 0;
+    // line loss of all batteries weighted by their capacity
+    double loss = 0.0;
+    // value of the global network generation this was built at, see
+    // vehicle::invalidate_power_networks
+    int generation = -1;
+};
+
 int mps_to_vmiph( double mps );
 double vmiph_to_mps( int vmiph );
 int cmps_to_vmiph( int cmps );
@@ -875,11 +926,13 @@ class vehicle
         //! @copydoc vehicle::search_connected_vehicles( Vehicle *start )
         void get_connected_vehicles( std::unordered_set<vehicle *> &dest );
 
-        /// Returns a map of connected battery references to power loss factor
-        /// Keys are batteries in vehicles (includes self) connected by POWER_TRANSFER parts
-        /// Values are line loss, 0.01 corresponds to 1% charge loss to wire resistance
+        /// Returns the power network of this vehicle, searching it on first use
+        /// The result is cached until invalidate_power_networks() is called
         /// May load the connected vehicles' submaps
-        std::map<vpart_reference, float> search_connected_batteries();
+        const vehicle_power_network &power_network() const;
+        /// Drops the cached power networks of all vehicles; called whenever a vehicle is
+        /// created, destroyed or refreshed, or when cables move with their vehicle
+        static void invalidate_power_networks();
 
         // constructs a vehicle, if the given \p proto_id is an empty string the vehicle is
         // constructed empty, invalid proto_id will construct empty and raise a debugmsg,
@@ -1173,7 +1226,7 @@ class vehicle
 
         /**
         *  Returns index of part at mount point \p pt which has given \p f flag
-        *  @note does not use relative_parts cache
+        *  @note does not use mount_grid cache
         *  @param pt only returns parts from this mount point
         *  @param f required flag in part's vpart_info flags collection
         *  @param unbroken if true also requires the part to be !is_broken
@@ -1182,7 +1235,7 @@ class vehicle
         int part_with_feature( const point &pt, const std::string &f, bool unbroken ) const;
         /**
         *  Returns part index at mount point \p pt which has given \p f flag
-        *  @note uses relative_parts cache
+        *  @note uses mount_grid cache
         *  @param pt only returns parts from this mount point
         *  @param f required flag in part's vpart_info flags collection
         *  @param unbroken if true also requires the part to be !is_broken()
@@ -1191,7 +1244,7 @@ class vehicle
         int part_with_feature( const point &pt, vpart_bitflags f, bool unbroken ) const;
         /**
         *  Returns \p p or part index at mount point \p pt which has given \p f flag
-        *  @note uses relative_parts cache
+        *  @note uses mount_grid cache
         *  @param p index of part to start searching from
         *  @param f required flag in part's vpart_info flags collection
         *  @param unbroken if true also requires the part to be !is_broken()
@@ -1201,7 +1254,7 @@ class vehicle
         /**
         *  Returns index of part at mount point \p pt which has given \p f flag
         *  and is_available(), or -1 if no such part or it's not is_available()
-        *  @note does not use relative_parts cache
+        *  @note does not use mount_grid cache
         *  @param pt only returns parts from this mount point
         *  @param f required flag in part's vpart_info flags collection
         *  @param unbroken if true also requires the part to be !is_broken
@@ -1211,7 +1264,7 @@ class vehicle
         /**
         *  Returns \p p or part index at mount point \p pt which has given \p f flag
         *  and is_available(), or -1 if no such part or it's not is_available()
-        *  @note uses relative_parts cache
+        *  @note uses mount_grid cache
         *  @param p index of part to start searching from
         *  @param f required flag in part's vpart_info flags collection
         *  @param unbroken if true also requires the part to be !is_broken()
@@ -1221,7 +1274,7 @@ class vehicle
         /**
         *  Returns index of part at mount point \p pt which has link connection
         *  and is_available(), or -1 if no such part or it's not is_available()
-        *  @note does not use relative_parts cache
+        *  @note does not use mount_grid cache
         *  @param pt only returns parts from this mount point
         *  @param to_ports if true, look for part with CABLE_PORTS flag. If false, BATTERY.
         *  Either way, will also look for APPLIANCE
@@ -1255,6 +1308,10 @@ class vehicle
                 part_status_flag condition );
         std::vector<const vehicle_part *> get_parts_at( const tripoint &pos,
                 const std::string &flag, part_status_flag condition ) const;
+        std::vector<vehicle_part *> get_parts_at( const tripoint &pos, vpart_bitflags flag,
+                part_status_flag condition );
+        std::vector<const vehicle_part *> get_parts_at( const tripoint &pos,
+                vpart_bitflags flag, part_status_flag condition ) const;
 
         /** Test if part can be enabled (unbroken, sufficient fuel etc), optionally displaying failures to user */
         bool can_enable( const vehicle_part &pt, bool alert = false ) const;
@@ -1368,6 +1425,9 @@ class vehicle
         // Pre-calculate mount points for (idir=0) - current direction or
         // (idir=1) - next turn direction
         void precalc_mounts( int idir, const units::angle &dir, const point &pivot );
+        // Index of the cached mount rotation used by precalc_mounts for @p dir, or -1 if
+        // @p dir is not (up to rounding error) a whole number of steer_increments.
+        static int rotation_table_index( const units::angle &dir );
 
         // get a list of part indices where is a passenger inside
         std::vector<int> boarded_parts() const;
@@ -1746,8 +1806,12 @@ class vehicle
 
         // Handle given part collision with vehicle, monster/NPC/player or terrain obstacle
         // Returns collision, which has type, impulse, part, & target.
-        veh_collision part_collision( int part, const tripoint &p,
-                                      bool just_detect, bool bash_floor );
+        // check_vehicles false skips looking for other vehicles at p
+        veh_collision part_collision( int part, const tripoint &p, bool just_detect,
+                                      bool bash_floor, bool check_vehicles = true );
+
+        /** Box around every tile a part of this vehicle (fakes included) occupies */
+        inclusive_cuboid<tripoint> occupied_bounds() const;
 
         // Process the trap beneath
         void handle_trap( const tripoint &p, vehicle_part &vp_wheel );
@@ -1943,8 +2007,9 @@ class vehicle
          */
         bool assign_seat( vehicle_part &pt, const npc &who );
 
-        // Update the set of occupied points and return a reference to it
-        const std::set<tripoint> &get_points( bool force_refresh = false, bool no_fake = false ) const;
+        // Update the sorted list of occupied points and return a reference to it
+        const std::vector<tripoint> &get_points( bool force_refresh = false,
+                bool no_fake = false ) const;
 
         /**
         * Consumes specified charges (or fewer) from the vehicle part
@@ -2111,8 +2176,8 @@ class vehicle
         mutable tripoint occupied_cache_pos = { -1, -1, -1 }; // NOLINT(cata-serialize)
         // Vehicle facing when cache was last refreshed.
         mutable units::angle occupied_cache_direction = 0_degrees; // NOLINT(cata-serialize)
-        // Cached points occupied by the vehicle
-        mutable std::set<tripoint> occupied_points; // NOLINT(cata-serialize)
+        // Cached points occupied by the vehicle, sorted and without duplicates
+        mutable std::vector<tripoint> occupied_points; // NOLINT(cata-serialize)
 
         // Master list of parts installed in the vehicle.
         std::vector<vehicle_part> parts; // NOLINT(cata-serialize)
@@ -2202,8 +2267,6 @@ class vehicle
          * spawned with the default constructor).
          */
         vproto_id type;
-        // parts_at_relative(dp) is used a lot (to put it mildly)
-        std::map<point, std::vector<int>> relative_parts; // NOLINT(cata-serialize)
         std::set<label> labels;            // stores labels
         std::set<std::string> tags;        // Properties of the vehicle
         // After fuel consumption, this tracks the remainder of fuel < 1, and applies it the next time.
@@ -2236,6 +2299,28 @@ class vehicle
          */
         mutable point mount_max; // NOLINT(cata-serialize)
         mutable point mount_min; // NOLINT(cata-serialize)
+        // indices of the parts (fakes last) at each mount point, sorted by list_order
+        // and padded by a row on either side for fake parts; rebuilt by refresh()
+        vehicle_part_grid mount_grid; // NOLINT(cata-serialize)
+        // indices of the real parts at each precalc[0] tile, and the box around the
+        // precalc[0] of all parts; rebuilt on demand once precalc_mounts or
+        // advance_precalc_mounts moves the parts
+        mutable vehicle_part_grid tile_grid; // NOLINT(cata-serialize)
+        mutable inclusive_cuboid<tripoint> precalc_bounds; // NOLINT(cata-serialize)
+        mutable bool precalc_cache_dirty = true; // NOLINT(cata-serialize)
+        void rebuild_precalc_cache() const;
+        // parts whose precalc[0] lies over @p dp, relative to pos, in index order
+        const std::vector<int> &parts_at_tile( const point &dp ) const;
+        // precalc offset of every part for one facing and pivot, indexed like parts
+        struct rotation_table {
+            point pivot;
+            std::vector<point> offsets;
+        };
+        // one table per steer_increment facing, filled on first use; emptied by refresh()
+        std::array<rotation_table, 24> rotation_tables; // NOLINT(cata-serialize)
+        // table for @p dir around @p pivot, or nullptr if @p dir has no table
+        const rotation_table *rotation_table_for( const units::angle &dir, const point &pivot );
+        mutable vehicle_power_network power_network_cache; // NOLINT(cata-serialize)
         mutable point mass_center_precalc; // NOLINT(cata-serialize)
         mutable point mass_center_no_precalc; // NOLINT(cata-serialize)
         tripoint autodrive_local_target = tripoint_zero; // current node the autopilot is aiming for
@@ -739,6 +739,34 @@ bool vehicle::collision( std::vector<veh_collision> &colls,
     const int sign_before = sgn( velocity_before );
     bool empty = true;
     map &here = get_map();
+
+    // Broadphase: only look for other vehicles under our parts when one is close enough.
+    // Vehicle-vehicle collisions are skipped when bashing the floor anyway.
+    bool check_vehicles = false;
+    if( !bash_floor ) {
+        const tripoint origin = global_pos3() + dp;
+        inclusive_cuboid<tripoint> swept( origin, origin );
+        for( const vehicle_part &vp : parts ) {
+            if( vp.removed ) {
+                continue;
+            }
+            // rotors also sweep the tiles around them
+            int reach = 0;
+            const vpart_info &vpi = vp.info();
+            if( vpi.has_flag( VPFLAG_ROTOR ) ) {
+                reach = static_cast<int>( std::round( vpi.rotor_info->rotor_diameter / 2.0f ) );
+            }
+            const tripoint dsp = origin + vp.precalc[1];
+            swept.p_min = tripoint( std::min( swept.p_min.x, dsp.x - reach ),
+                                    std::min( swept.p_min.y, dsp.y - reach ),
+                                    std::min( swept.p_min.z, dsp.z ) );
+            swept.p_max = tripoint( std::max( swept.p_max.x, dsp.x + reach ),
+                                    std::max( swept.p_max.y, dsp.y + reach ),
+                                    std::max( swept.p_max.z, dsp.z ) );
+        }
+        check_vehicles = here.may_have_vehicle_in( swept, this );
+    }
+
     for( int p = 0; p < part_count(); p++ ) {
         const vehicle_part &vp = parts.at( p );
         if( vp.removed || !vp.is_real_or_active_fake() ) {
@@ -753,11 +781,12 @@ bool vehicle::collision( std::vector<veh_collision> &colls,
         // Coordinates of where part will go due to movement (dx/dy/dz)
         //  and turning (precalc[1])
         const tripoint dsp = global_pos3() + dp + vp.precalc[1];
-        veh_collision coll = part_collision( p, dsp, just_detect, bash_floor );
+        veh_collision coll = part_collision( p, dsp, just_detect, bash_floor, check_vehicles );
         if( coll.type == veh_coll_nothing && info.has_flag( VPFLAG_ROTOR ) ) {
             size_t radius = static_cast<size_t>( std::round( info.rotor_info->rotor_diameter / 2.0f ) );
             for( const tripoint &rotor_point : here.points_in_radius( dsp, radius ) ) {
-                veh_collision rotor_coll = part_collision( p, rotor_point, just_detect, false );
+                veh_collision rotor_coll = part_collision( p, rotor_point, just_detect, false,
+                                           check_vehicles );
                 if( rotor_coll.type != veh_coll_nothing ) {
                     coll = rotor_coll;
                     if( just_detect ) {
@@ -830,7 +859,7 @@ static void terrain_collision_data( const tripoint &p, bool bash_floor,
 }
 
 veh_collision vehicle::part_collision( int part, const tripoint &p,
-                                       bool just_detect, bool bash_floor )
+                                       bool just_detect, bool bash_floor, bool check_vehicles )
 {
     // Vertical collisions need to be handled differently
     // All collisions have to be either fully vertical or fully horizontal for now
@@ -849,7 +878,9 @@ veh_collision vehicle::part_collision( int part, const tripoint &p,
     }
 
     map &here = get_map();
-    const optional_vpart_position ovp = here.veh_at( p );
+    // Without other vehicles nearby only a critter standing in this one needs the lookup
+    const optional_vpart_position ovp = check_vehicles || critter != nullptr ? here.veh_at( p ) :
+                                        optional_vpart_position( std::nullopt );
     // Disable vehicle/critter collisions when bashing floor
     // TODO: More elegant code
     const bool is_veh_collision = !bash_floor && ovp && &ovp->vehicle() != this;
@@ -870,6 +901,11 @@ veh_collision vehicle::part_collision( int part, const tripoint &p,
         return ret;
     }
 
+    // Nothing to hit on open, flat ground
+    if( !bash_floor && critter == nullptr && here.move_cost_ter_furn( p ) == 2 ) {
+        return ret;
+    }
+
     // Typical rotor tip speed in MPH * 100.
     int rotor_velocity = 45600;
     // Non-vehicle collisions can't happen when the vehicle is not moving
@@ -891,11 +927,11 @@ veh_collision vehicle::part_collision( int part, const tripoint &p,
             tripoint start_pos;
             const units::angle angle =
                 move.dir() + 45_degrees * ( parts[part].mount.x > pivot_point().x ? -1 : 1 );
-            const std::set<tripoint> &cur_points = get_points( true );
+            const std::vector<tripoint> &cur_points = get_points( true );
             // push the animal out of way until it's no longer in our vehicle and not in
             // anyone else's position
             while( get_creature_tracker().creature_at( end_pos, true ) ||
-                   cur_points.find( end_pos ) != cur_points.end() ) {
+                   std::binary_search( cur_points.begin(), cur_points.end(), end_pos ) ) {
                 start_pos = end_pos;
                 calc_ray_end( angle, 2, start_pos, end_pos );
             }
@@ -2087,7 +2123,7 @@ void vehicle::check_falling_or_floating()
     }
     // TODO: Make the vehicle "slide" towards its center of weight
     //  when it's not properly supported
-    const std::set<tripoint> &pts = get_points();
+    const std::vector<tripoint> &pts = get_points();
     if( pts.empty() ) {
         // Dirty vehicle with no parts
         is_falling = false;
@@ -176,14 +176,21 @@ static void proc_weather_sum( const weather_type_id &wtype, weather_sum &data,
 weather_type_id current_weather( const tripoint_abs_ms &location, const time_point &t )
 {
     weather_manager &weather = get_weather();
-    const weather_generator wgen = weather.get_cur_weather_gen();
     if( weather.weather_override != WEATHER_NULL ) {
         return weather.weather_override;
     }
-    return wgen.get_weather_conditions( location, t, g->get_seed() );
+    return weather.get_cur_weather_gen().get_weather_conditions( location, t, g->get_seed() );
+}
+
+weather_sum &weather_sum::operator+=( const weather_sum &rhs )
+{
+    rain_amount += rhs.rain_amount;
+    sunlight += rhs.sunlight;
+    radiant_exposure += rhs.radiant_exposure;
+    wind_amount += rhs.wind_amount;
+    return *this;
 }
 
-////// Funnels.
 weather_sum sum_conditions( const time_point &start, const time_point &end,
                             const tripoint_abs_ms &location )
 {
@@ -191,8 +198,16 @@ weather_sum sum_conditions( const time_point &start, const time_point &end,
     weather_sum data;
 
     weather_manager &weather = get_weather();
+    // an override can be lifted at any time, so only real weather goes through the cache
+    const bool use_daily_sums = weather.weather_override == WEATHER_NULL;
     for( time_point t = start; t < end; t += tick_size ) {
         const time_duration diff = end - t;
+        const time_duration to_midnight = 1_days - time_past_midnight( t );
+        if( use_daily_sums && to_midnight == 1_days && diff >= 1_days ) {
+            data += weather.get_daily_sum( location, t );
+            tick_size = 1_days;
+            continue;
+        }
         if( diff < 10_turns ) {
             tick_size = 1_turns;
         } else if( diff > 7_days ) {
@@ -200,13 +215,20 @@ weather_sum sum_conditions( const time_point &start, const time_point &end,
         } else {
             tick_size = 1_minutes;
         }
+        if( use_daily_sums && diff >= 1_days + to_midnight ) {
+            // stop at midnight so the following whole days come from the cache
+            tick_size = std::min( tick_size, to_midnight );
+        }
 
         weather_type_id wtype = current_weather( location, t );
         proc_weather_sum( wtype, data, t, tick_size );
-        data.wind_amount += get_local_windpower( weather.windspeed,
-                            overmap_buffer.ter( project_to<coords::omt>( location ) ),
-                            location,
-                            weather.winddirection, false ) * to_turns<int>( tick_size );
+    }
+    if( start < end ) {
+        // the current wind is used for the whole interval
+        const oter_id &omter = overmap_buffer.ter( project_to<coords::omt>( location ) );
+        data.wind_amount = get_local_windpower( weather.windspeed, omter, location,
+                                                weather.winddirection, false ) *
+                           to_turns<int>( end - start );
     }
     return data;
 }
@@ -991,6 +1013,29 @@ void weather_manager::clear_temp_cache()
     temperature_cache.clear();
 }
 
+const weather_sum &weather_manager::get_daily_sum( const tripoint_abs_ms &location,
+        const time_point &day )
+{
+    const std::pair<point_abs_omt, int> key( project_to<coords::omt>( location.xy() ),
+            to_days<int>( day - calendar::turn_zero ) );
+    const auto cached = daily_sum_cache.find( key );
+    if( cached != daily_sum_cache.end() ) {
+        return cached->second;
+    }
+    // bases are few, but a long road trip leaves a trail of tiles behind
+    if( daily_sum_cache.size() >= 4096 ) {
+        daily_sum_cache.clear();
+    }
+    // coarser than the minutes sum_conditions samples near the end of an interval,
+    // but weather types last for hours
+    constexpr time_duration tick_size = 10_minutes;
+    weather_sum data;
+    for( time_point t = day; t < day + 1_days; t += tick_size ) {
+        proc_weather_sum( current_weather( location, t ), data, t, tick_size );
+    }
+    return daily_sum_cache.emplace( key, data ).first->second;
+}
+
 const weather_manager &get_weather_const()
 {
     return const_cast<const weather_manager &>( get_weather() );
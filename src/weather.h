@@ -2,7 +2,9 @@
 #ifndef CATA_SRC_WEATHER_H
 #define CATA_SRC_WEATHER_H
 
+#include <map>
 #include <optional>
+#include <utility>
 
 #include "calendar.h"
 #include "catacharset.h"
@@ -114,6 +116,8 @@ struct weather_sum {
     float sunlight = 0.0f;
     float radiant_exposure = 0.0f; // J/m2
     int wind_amount = 0;
+
+    weather_sum &operator+=( const weather_sum &rhs );
 };
 bool is_creature_outside( const Creature &target );
 void wet_character( Character &target, int amount );
@@ -223,6 +227,13 @@ class weather_manager
         time_point nextweather;
         /** temperature cache, cleared every turn, sparse map of map tripoints to temperatures */
         std::unordered_map< tripoint, units::temperature > temperature_cache;
+        /**
+         * Rain and sunlight of whole days by overmap tile and day, used by sum_conditions
+         * to catch up on long absences. Wind is not included, it is taken from the
+         * current wind.
+         */
+        std::map<std::pair<point_abs_omt, int>, weather_sum> daily_sum_cache;
+        const weather_sum &get_daily_sum( const tripoint_abs_ms &location, const time_point &day );
         // Returns outdoor or indoor temperature of given location
         units::temperature get_temperature( const tripoint &location );
         // Returns outdoor or indoor temperature of given location
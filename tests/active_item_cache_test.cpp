@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <list>
+#include <map>
 #include <set>
+#include <vector>
 
+#include "active_item_cache.h"
 #include "calendar.h"
 #include "cata_catch.h"
+#include "cata_scope_helpers.h"
 #include "game_constants.h"
 #include "item.h"
 #include "map.h"
@@ -40,3 +46,98 @@ TEST_CASE( "place_active_item_at_various_coordinates", "[item]" )
         }
     }
 }
+
+static std::map<const item *, int> count_processed( active_item_cache &cache, const int turns )
+{
+    std::map<const item *, int> processed;
+    for( int i = 0; i < turns; i++ ) {
+        for( item_reference &ref : cache.get_for_processing() ) {
+            processed[ref.item_ref.get()]++;
+        }
+        calendar::turn += 1_turns;
+    }
+    return processed;
+}
+
+TEST_CASE( "active_items_are_processed_when_due", "[item]" )
+{
+    restore_on_out_of_scope<time_point> restore_turn( calendar::turn );
+    calendar::turn = calendar::turn_zero + 1_days;
+    active_item_cache cache;
+    std::list<item> food;
+    for( int i = 0; i < 1000; i++ ) {
+        cache.add( food.emplace_back( "apple" ), point( i % SEEX, i / SEEX % SEEY ) );
+    }
+    item &firecracker = food.emplace_back( "firecracker_act", calendar::turn,
+                                           item::default_charges_tag() );
+    firecracker.activate();
+    cache.add( firecracker, point_zero );
+    const int interval = food.front().processing_speed();
+    REQUIRE( interval > 1 );
+    REQUIRE( firecracker.processing_speed() == 1 );
+
+    SECTION( "food once per interval, active items every turn" ) {
+        const std::map<const item *, int> processed = count_processed( cache, interval * 3 );
+        REQUIRE( processed.size() == food.size() );
+        for( const std::pair<const item *const, int> &count : processed ) {
+            CHECK( count.second == ( count.first == &firecracker ? interval * 3 : 3 ) );
+        }
+    }
+
+    SECTION( "calling again in the same turn only returns the active items" ) {
+        cache.get_for_processing();
+        CHECK( cache.get_for_processing().size() == 1 );
+    }
+
+    SECTION( "after a long time away overdue items stay spread over their interval" ) {
+        std::map<const item *, int> phase_before;
+        for( int i = 0; i < interval; i++ ) {
+            for( item_reference &ref : cache.get_for_processing() ) {
+                phase_before[ref.item_ref.get()] = to_turn<int>( calendar::turn ) % interval;
+            }
+            calendar::turn += 1_turns;
+        }
+        calendar::turn += 3_days;
+        std::map<const item *, int> processed;
+        size_t busiest_turn = 0;
+        for( int i = 0; i < interval; i++ ) {
+            const std::vector<item_reference> due = cache.get_for_processing();
+            busiest_turn = std::max( busiest_turn, due.size() );
+            for( const item_reference &ref : due ) {
+                const item *it = ref.item_ref.get();
+                processed[it]++;
+                if( it != &firecracker ) {
+                    CHECK( to_turn<int>( calendar::turn ) % interval == phase_before[it] );
+                }
+            }
+            calendar::turn += 1_turns;
+        }
+        REQUIRE( processed.size() == food.size() );
+        for( const std::pair<const item *const, int> &count : processed ) {
+            CHECK( count.second == ( count.first == &firecracker ? interval : 1 ) );
+        }
+        CHECK( busiest_turn < food.size() / 2 );
+    }
+
+    SECTION( "destroyed items are dropped" ) {
+        food.pop_front();
+        const std::map<const item *, int> processed = count_processed( cache, interval );
+        CHECK( processed.size() == food.size() );
+        CHECK( processed.count( nullptr ) == 0 );
+    }
+}
+
+TEST_CASE( "active_item_processing_benchmark", "[.][item][benchmark]" )
+{
+    restore_on_out_of_scope<time_point> restore_turn( calendar::turn );
+    active_item_cache cache;
+    // A well stocked base.
+    std::list<item> food;
+    for( int i = 0; i < 20000; i++ ) {
+        cache.add( food.emplace_back( "apple" ), point( i % SEEX, i / SEEX % SEEY ) );
+    }
+    BENCHMARK( "one turn with 20000 waiting items" ) {
+        calendar::turn += 1_turns;
+        return cache.get_for_processing().size();
+    };
+}
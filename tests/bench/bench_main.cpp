@@ -0,0 +1,451 @@
+// cata_bench: simulates whole game turns without a user interface and reports how long they
+// took as JSON, so performance can be compared between commits.
+//
+// It loads the same world as the tests, then for each phase wipes the reality bubble, sets
+// up a scene, seeds the random number generator and lets the avatar wait for a number of
+// turns.  Given the same seed and data the phases play out the same way every run.
+//
+// Usage: cata_bench [--turns N] [--seed N] [--phases wait,horde,fire,drive,convoy]
+//                   [--output file] [--user-dir dirname]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "avatar.h"
+#include "cached_options.h"
+#include "calendar.h"
+#include "cata_utility.h"
+#include "compatibility.h"
+#include "debug.h"
+#include "field_type.h"
+#include "game.h"
+#include "game_constants.h"
+#include "global_game_state.h"
+#include "item.h"
+#include "json.h"
+#include "line.h"
+#include "map.h"
+#include "map_iterator.h"
+#include "monster.h"
+#include "point.h"
+#include "profiler.h"
+#include "rng.h"
+#include "type_id.h"
+#include "units.h"
+#include "vehicle.h"
+#include "worldfactory.h"
+
+static const furn_str_id furn_f_null( "f_null" );
+
+static const itype_id itype_2x4( "2x4" );
+
+static const mod_id MOD_INFORMATION_dda( "dda" );
+static const mod_id MOD_INFORMATION_test_data( "test_data" );
+
+static const mtype_id mon_zombie( "mon_zombie" );
+
+static const ter_str_id ter_t_grass( "t_grass" );
+
+static const trait_id trait_DEBUG_NODMG( "DEBUG_NODMG" );
+
+static const vproto_id vehicle_prototype_car( "car" );
+
+namespace
+{
+
+// Every allocation made through operator new, see the replacements below.
+std::atomic<uint64_t> allocations( 0 );
+std::atomic<uint64_t> allocated_bytes( 0 );
+
+void *counted_malloc( const std::size_t size )
+{
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    allocated_bytes.fetch_add( size, std::memory_order_relaxed );
+    // malloc( 0 ) may return nullptr, operator new must not.
+    return std::malloc( size == 0 ? 1 : size );
+}
+
+} // namespace
+
+// The aligned versions are left alone, they are rare and pair up with their own deletes.
+void *operator new( const std::size_t size )
+{
+    void *const ret = counted_malloc( size );
+    if( ret == nullptr ) {
+        throw std::bad_alloc();
+    }
+    return ret;
+}
+
+void *operator new[]( const std::size_t size )
+{
+    return operator new( size );
+}
+
+void *operator new( const std::size_t size, const std::nothrow_t & ) noexcept
+{
+    return counted_malloc( size );
+}
+
+void *operator new[]( const std::size_t size, const std::nothrow_t & ) noexcept
+{
+    return counted_malloc( size );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void *ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete( void *ptr, const std::nothrow_t & ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void *ptr, const std::nothrow_t & ) noexcept
+{
+    std::free( ptr );
+}
+
+namespace
+{
+
+struct phase {
+    std::string name;
+    // Sets up the scene after the bubble has been wiped.
+    std::function<void()> setup;
+    // Runs before each turn.
+    std::function<void()> each_turn;
+};
+
+struct phase_result {
+    std::string name;
+    int turns = 0;
+    std::chrono::duration<double> elapsed{};
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    std::vector<profiler::zone_total> zones;
+};
+
+tripoint bubble_center()
+{
+    return tripoint( HALF_MAPSIZE_X + SEEX / 2, HALF_MAPSIZE_Y + SEEY / 2, 0 );
+}
+
+// Leaves the avatar alone on grass in the middle of the bubble at noon.
+void reset_world( const unsigned int seed )
+{
+    map &here = get_map();
+    avatar &u = get_avatar();
+    if( u.in_vehicle ) {
+        here.unboard_vehicle( u.pos() );
+    }
+    u.controlling_vehicle = false;
+    g->clear_zombies();
+    for( wrapped_vehicle &veh : here.get_vehicles() ) {
+        here.destroy_vehicle( veh.v );
+    }
+    for( const tripoint &p : here.points_on_zlevel( 0 ) ) {
+        here.set( p, ter_t_grass, furn_f_null );
+        here.i_clear( p );
+        here.clear_fields( p );
+    }
+    here.invalidate_map_cache( 0 );
+    here.build_map_cache( 0, true );
+
+    u.setpos( bubble_center() );
+    if( !u.has_trait( trait_DEBUG_NODMG ) ) {
+        // Nothing the phases do should end the run early.
+        u.set_mutation( trait_DEBUG_NODMG );
+    }
+    calendar::turn = calendar::turn_zero + 12_hours;
+    rng_set_engine_seed( seed );
+}
+
+void spawn_horde()
+{
+    const tripoint center = get_avatar().pos();
+    for( int placed = 0; placed < 150; ) {
+        const tripoint p( rng( 0, MAPSIZE_X - 1 ), rng( 0, MAPSIZE_Y - 1 ), 0 );
+        if( rl_dist( p, center ) >= 12 && g->place_critter_at( mon_zombie, p ) != nullptr ) {
+            placed++;
+        }
+    }
+}
+
+// A stack of planks next to the avatar, burning in the middle.
+void start_fire()
+{
+    map &here = get_map();
+    const tripoint center = get_avatar().pos() + point( 12, 0 );
+    for( const tripoint &p : here.points_in_radius( center, 7 ) ) {
+        here.add_item_or_charges( p, item( itype_2x4, calendar::turn ) );
+    }
+    for( const tripoint &p : here.points_in_radius( center, 1 ) ) {
+        here.add_field( p, fd_fire, 3 );
+    }
+}
+
+vehicle *driven = nullptr;
+
+void start_driving()
+{
+    map &here = get_map();
+    avatar &u = get_avatar();
+    driven = here.add_vehicle( vehicle_prototype_car, u.pos(), 0_degrees, 100, 0 );
+    if( driven == nullptr ) {
+        cata_fatal( "Could not place the car." );
+    }
+    driven->tags.insert( "IN_CONTROL_OVERRIDE" );
+    driven->engine_on = true;
+    here.board_vehicle( u.pos(), &u );
+    u.controlling_vehicle = true;
+    driven->cruise_velocity = 1000;
+    driven->velocity = driven->cruise_velocity;
+}
+
+// Keeps steering, so the car goes round in circles near the middle of the bubble.
+void steer()
+{
+    if( driven != nullptr && calendar::once_every( 2_turns ) ) {
+        driven->turn( 15_degrees );
+    }
+}
+
+std::vector<vehicle *> convoy;
+constexpr int convoy_spacing = 10;
+// 60 mph
+constexpr int convoy_velocity = 6000;
+
+// Ten unmanned cars in a column heading east across the bubble, north of the avatar.
+void start_convoy()
+{
+    map &here = get_map();
+    const tripoint start( 16, get_avatar().pos().y - 12, 0 );
+    convoy.clear();
+    for( int i = 0; i < 10; i++ ) {
+        const tripoint pos = start + point( i * convoy_spacing, 0 );
+        vehicle *veh = here.add_vehicle( vehicle_prototype_car, pos, 0_degrees, 100, 0 );
+        if( veh == nullptr ) {
+            cata_fatal( "Could not place convoy car %d.", i );
+        }
+        convoy.push_back( veh );
+    }
+}
+
+// Holds the convoy at highway speed and moves each car that reaches the east edge of the
+// bubble back behind the last one, so the column keeps driving for as many turns as needed.
+void drive_convoy()
+{
+    map &here = get_map();
+    const int length = convoy_spacing * static_cast<int>( convoy.size() );
+    for( vehicle *veh : convoy ) {
+        veh->velocity = convoy_velocity;
+        veh->cruise_velocity = convoy_velocity;
+        if( veh->global_pos3().x > MAPSIZE_X - 16 ) {
+            here.displace_vehicle( *veh, tripoint( -length, 0, 0 ) );
+        }
+    }
+}
+
+// do_turn() without the parts that wait for input or draw.
+void simulate_turn()
+{
+    CATA_PROFILE_ZONE( "turn" );
+    avatar &u = get_avatar();
+    turn_handler::start_turn();
+    while( u.get_moves() > 0 && u.activity ) {
+        u.activity.do_turn( u );
+    }
+    if( u.get_moves() > 0 ) {
+        u.pause();
+    }
+    g->cleanup_dead();
+    turn_handler::process_world();
+    turn_handler::end_turn();
+}
+
+phase_result run_phase( const phase &ph, const int turns, const unsigned int seed )
+{
+    reset_world( seed );
+    driven = nullptr;
+    convoy.clear();
+    if( ph.setup ) {
+        ph.setup();
+    }
+
+    phase_result ret;
+    ret.name = ph.name;
+    profiler::start();
+    const uint64_t allocations_before = allocations;
+    const uint64_t bytes_before = allocated_bytes;
+    const auto start = std::chrono::steady_clock::now();
+    for( ; ret.turns < turns && !get_avatar().is_dead_state(); ret.turns++ ) {
+        if( ph.each_turn ) {
+            ph.each_turn();
+        }
+        simulate_turn();
+    }
+    ret.elapsed = std::chrono::steady_clock::now() - start;
+    ret.allocations = allocations - allocations_before;
+    ret.allocated_bytes = allocated_bytes - bytes_before;
+    profiler::stop();
+    ret.zones = profiler::totals();
+    return ret;
+}
+
+void write_results( std::ostream &out, const std::vector<phase_result> &results,
+                    const int turns, const unsigned int seed )
+{
+    JsonOut jsout( out, true );
+    jsout.start_object();
+    jsout.member( "seed", seed );
+    jsout.member( "turns", turns );
+    jsout.member( "phases" );
+    jsout.start_array();
+    for( const phase_result &result : results ) {
+        const double seconds = result.elapsed.count();
+        jsout.start_object();
+        jsout.member( "name", result.name );
+        jsout.member( "turns", result.turns );
+        jsout.member( "seconds", seconds );
+        jsout.member( "turns_per_second", seconds > 0 ? result.turns / seconds : 0.0 );
+        jsout.member( "allocations", result.allocations );
+        jsout.member( "allocated_bytes", result.allocated_bytes );
+        jsout.member( "zones" );
+        jsout.start_array();
+        for( const profiler::zone_total &zone : result.zones ) {
+            jsout.start_object();
+            jsout.member( "zone", zone.path );
+            jsout.member( "calls", zone.calls );
+            jsout.member( "seconds", std::chrono::duration<double>( zone.total ).count() );
+            jsout.end_object();
+        }
+        jsout.end_array();
+        jsout.end_object();
+    }
+    jsout.end_array();
+    jsout.end_object();
+    out << std::endl;
+}
+
+int usage( const char *name )
+{
+    printf( "Usage: %s [--turns N] [--seed N] [--phases wait,horde,fire,drive,convoy] "
+            "[--output file] [--user-dir dirname]\n", name );
+    return EXIT_FAILURE;
+}
+
+} // namespace
+
+int main( int argc, const char *argv[] )
+{
+    int turns = 600;
+    unsigned int seed = 42;
+    std::string phase_names = "wait,horde,fire,drive,convoy";
+    std::string output;
+    std::string user_dir = "./bench_user_dir/";
+    for( int i = 1; i < argc; i++ ) {
+        const std::string arg = argv[i];
+        if( i + 1 >= argc ) {
+            return usage( argv[0] );
+        }
+        const std::string value = argv[++i];
+        if( arg == "--turns" ) {
+            turns = std::atoi( value.c_str() );
+        } else if( arg == "--seed" ) {
+            seed = static_cast<unsigned int>( std::strtoul( value.c_str(), nullptr, 10 ) );
+        } else if( arg == "--phases" ) {
+            phase_names = value;
+        } else if( arg == "--output" ) {
+            output = value;
+        } else if( arg == "--user-dir" ) {
+            user_dir = value;
+        } else {
+            return usage( argv[0] );
+        }
+    }
+    if( !string_ends_with( user_dir, "/" ) ) {
+        user_dir += "/";
+    }
+
+    const std::vector<phase> all_phases = {
+        { "wait", nullptr, nullptr },
+        { "horde", spawn_horde, nullptr },
+        { "fire", start_fire, nullptr },
+        { "drive", start_driving, steer },
+        { "convoy", start_convoy, drive_convoy },
+    };
+    std::vector<const phase *> phases;
+    for( const std::string &name : string_split( phase_names, ',' ) ) {
+        const auto found = std::find_if( all_phases.begin(), all_phases.end(),
+        [&]( const phase & ph ) {
+            return ph.name == name;
+        } );
+        if( found == all_phases.end() ) {
+            printf( "Unknown phase %s\n", name.c_str() );
+            return usage( argv[0] );
+        }
+        phases.push_back( &*found );
+    }
+
+    // NOLINTNEXTLINE(cata-tests-must-restore-global-state)
+    test_mode = true;
+    reset_floating_point_mode();
+    setupDebug( DebugOutput::std_err );
+    rng_set_engine_seed( seed );
+
+    option_overrides_t no_overrides;
+    std::vector<phase_result> results;
+    try {
+        init_global_game_state( { MOD_INFORMATION_dda, MOD_INFORMATION_test_data }, no_overrides,
+                                user_dir );
+        for( const phase *ph : phases ) {
+            DebugLog( D_INFO, DC_ALL ) << "Running phase " << ph->name;
+            results.push_back( run_phase( *ph, turns, seed ) );
+        }
+    } catch( const std::exception &err ) {
+        DebugLog( D_ERROR, DC_ALL ) << "Terminated:\n" << err.what();
+        return EXIT_FAILURE;
+    }
+    world_generator->delete_world( world_generator->active_world->world_name, true );
+
+    if( output.empty() ) {
+        write_results( std::cout, results, turns, seed );
+    } else if( !write_to_file( output, [&]( std::ostream & fout ) {
+    write_results( fout, results, turns, seed );
+    }, "benchmark results" ) ) {
+        return EXIT_FAILURE;
+    }
+    if( debug_has_error_been_observed() ) {
+        DebugLog( D_INFO, DC_ALL ) << "Errors were logged, the results may not mean much.";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cata_catch.h"
+#include "character.h"
+#include "coordinates.h"
+#include "creature_tracker.h"
+#include "game.h"
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "monster.h"
+#include "npc.h"
+#include "player_helpers.h"
+#include "point.h"
+#include "rng.h"
+
+// A tile in the bubble that is free of monsters and the player.
+static tripoint free_tile( const int z )
+{
+    const creature_tracker &creatures = get_creature_tracker();
+    while( true ) {
+        const tripoint p( rng( 0, MAPSIZE_X - 1 ), rng( 0, MAPSIZE_Y - 1 ), z );
+        if( creatures.creature_at( p, true ) == nullptr ) {
+            return p;
+        }
+    }
+}
+
+static void spawn_monsters( const int count )
+{
+    for( int i = 0; i < count; i++ ) {
+        spawn_test_monster( "mon_zombie", free_tile( rng( -1, 0 ) ) );
+    }
+}
+
+// The monsters matching @p pred, in tracker order like the area queries.
+static std::vector<monster *> all_monsters_where( const std::function<bool( const monster & )>
+        &pred )
+{
+    std::vector<monster *> ret;
+    for( monster &critter : g->all_monsters() ) {
+        if( pred( critter ) ) {
+            ret.push_back( &critter );
+        }
+    }
+    return ret;
+}
+
+static void check_queries()
+{
+    const creature_tracker &creatures = get_creature_tracker();
+    map &here = get_map();
+    for( int i = 0; i < 20; i++ ) {
+        const tripoint_abs_ms center = here.getglobal( free_tile( rng( -1, 0 ) ) );
+        const int radius = rng( 0, 40 );
+        CAPTURE( center, radius );
+        CHECK( creatures.monsters_in_radius( center, radius ) ==
+        all_monsters_where( [&]( const monster & critter ) {
+            return rl_dist( center, critter.get_location() ) <= radius;
+        } ) );
+
+        const tripoint_abs_ms corner = here.getglobal( free_tile( -1 ) );
+        const tripoint_abs_ms min( std::min( center.x(), corner.x() ),
+                                   std::min( center.y(), corner.y() ), -1 );
+        const tripoint_abs_ms max( std::max( center.x(), corner.x() ),
+                                   std::max( center.y(), corner.y() ), rng( -1, 0 ) );
+        CAPTURE( min, max );
+        CHECK( creatures.monsters_in_rectangle( min, max ) ==
+        all_monsters_where( [&]( const monster & critter ) {
+            const tripoint_abs_ms &p = critter.get_location();
+            return p.x() >= min.x() && p.x() <= max.x() && p.y() >= min.y() && p.y() <= max.y() &&
+                   p.z() >= min.z() && p.z() <= max.z();
+        } ) );
+    }
+}
+
+TEST_CASE( "creature_tracker_area_queries_find_the_same_monsters_as_a_scan",
+           "[creature_tracker]" )
+{
+    clear_map( -1, 0 );
+    rng_set_engine_seed( 4 );
+    spawn_monsters( 300 );
+    REQUIRE( g->num_creatures() > 300 );
+
+    SECTION( "after spawning" ) {
+        check_queries();
+    }
+    SECTION( "after monsters move, swap places and die" ) {
+        std::vector<monster *> critters;
+        for( monster &critter : g->all_monsters() ) {
+            critters.push_back( &critter );
+        }
+        for( monster *critter : critters ) {
+            if( one_in( 2 ) ) {
+                critter->setpos( free_tile( rng( -1, 0 ) ) );
+            }
+        }
+        for( size_t i = 0; i + 1 < critters.size(); i += 7 ) {
+            g->swap_critters( *critters[i], *critters[i + 1] );
+        }
+        for( size_t i = 0; i < critters.size(); i += 5 ) {
+            critters[i]->die( nullptr );
+        }
+        check_queries();
+        g->cleanup_dead();
+        check_queries();
+    }
+    clear_map( -1, 0 );
+}
+
+TEST_CASE( "visible_creatures_come_in_the_order_of_all_creatures", "[creature_tracker]" )
+{
+    clear_map( -1, 0 );
+    clear_avatar();
+    set_time_to_day();
+    rng_set_engine_seed( 7 );
+    Character &you = get_player_character();
+    const tripoint center = you.pos();
+    npc &guy = spawn_npc( center.xy() + point( 3, 0 ), "thug" );
+    for( int i = 0; i < 40; i++ ) {
+        const tripoint p = center + tripoint( rng( -8, 8 ), rng( -8, 8 ), 0 );
+        if( get_creature_tracker().creature_at( p, true ) == nullptr ) {
+            spawn_test_monster( "mon_zombie", p );
+        }
+    }
+    const std::vector<const Character *> viewers = { &you, &guy };
+    for( const Character *viewer : viewers ) {
+        // The scan over every creature that the grid query replaced.
+        const std::vector<Creature *> expected = g->get_creatures_if(
+        [viewer]( const Creature & critter ) {
+            return viewer != &critter && viewer->pos() != critter.pos() &&
+                   rl_dist( viewer->pos(), critter.pos() ) <= 10 && viewer->sees( critter );
+        } );
+        REQUIRE( expected.size() > 2 );
+        CHECK( viewer->get_visible_creatures( 10 ) == expected );
+    }
+    CHECK( guy.get_visible_creatures( 10 ).back() == &you );
+    clear_map( -1, 0 );
+}
+
+TEST_CASE( "creature_tracker_radius_query_benchmark", "[.][creature_tracker][benchmark]" )
+{
+    clear_map( -1, 0 );
+    rng_set_engine_seed( 11 );
+    spawn_monsters( 1500 );
+    const creature_tracker &creatures = get_creature_tracker();
+    const tripoint_abs_ms center = get_player_character().get_location();
+
+    BENCHMARK( "scan every monster" ) {
+        int found = 0;
+        for( monster &critter : g->all_monsters() ) {
+            if( rl_dist( center, critter.get_location() ) <= 10 ) {
+                found++;
+            }
+        }
+        return found;
+    };
+    BENCHMARK( "radius query" ) {
+        return creatures.monsters_in_radius( center, 10 ).size();
+    };
+    BENCHMARK( "visible creatures within 10" ) {
+        return get_player_character().get_visible_creatures( 10 ).size();
+    };
+    clear_map( -1, 0 );
+}
@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <iosfwd>
 #include <vector>
 
 #include "avatar.h"
+#include "cached_options.h"
 #include "calendar.h"
 #include "cata_catch.h"
+#include "cata_scope_helpers.h"
 #include "effect.h"
 #include "field.h"
 #include "field_type.h"
@@ -15,6 +18,7 @@
 #include "options_helpers.h"
 #include "player_helpers.h"
 #include "point.h"
+#include "rng.h"
 #include "type_id.h"
 #include "weather.h"
 
@@ -479,6 +483,160 @@ TEST_CASE( "field_API_test", "[field]" )
     fields_test_cleanup();
 }
 
+TEST_CASE( "field_entries_past_inline_storage", "[field]" )
+{
+    // No larger than the std::map it replaced, with room for fire and smoke.
+    CHECK( sizeof( field ) <= 64 );
+
+    field f;
+    const std::vector<field_type_id> types = { fd_fire, fd_smoke, fd_web, fd_acid, fd_blood };
+    REQUIRE( types.size() > static_cast<size_t>( field::inline_capacity ) );
+    CHECK( f.add_field( types[0], 2 ) );
+    field_entry *const first = f.find_field( types[0] );
+    REQUIRE( first );
+    for( size_t i = 1; i < types.size(); i++ ) {
+        CHECK( f.add_field( types[i], 1 ) );
+    }
+    CHECK_FALSE( f.add_field( types[0], 1 ) );
+    CHECK( f.field_count() == types.size() );
+    // Adding entries doesn't move the ones already there.
+    CHECK( f.find_field( types[0] ) == first );
+    CHECK( first->get_field_intensity() == 3 );
+
+    std::vector<field_type_id> seen;
+    for( const field::value_type &fld : f ) {
+        seen.push_back( fld.first );
+        CHECK( fld.second.get_field_type() == fld.first );
+    }
+    CHECK_THAT( seen, Catch::UnorderedEquals( types ) );
+
+    SECTION( "removing while iterating" ) {
+        for( auto it = f.begin(); it != f.end(); ) {
+            if( it->first != types[3] ) {
+                f.remove_field( it++ );
+            } else {
+                ++it;
+            }
+        }
+        CHECK( f.field_count() == 1 );
+        CHECK( f.find_field( types[3] ) );
+        CHECK( f.displayed_field_type() == types[3] );
+        CHECK( f.add_field( types[0], 1 ) );
+        CHECK( f.field_count() == 2 );
+    }
+    SECTION( "copies" ) {
+        const field copy = f;
+        CHECK( f.remove_field( types.back() ) );
+        CHECK( copy.field_count() == types.size() );
+        CHECK( copy.find_field( types.back() ) );
+        CHECK_FALSE( f.find_field( types.back() ) );
+    }
+    SECTION( "clearing" ) {
+        f.clear();
+        CHECK( f.field_count() == 0 );
+        CHECK( f.begin() == f.end() );
+        CHECK_FALSE( f.find_field( types[0] ) );
+    }
+}
+
+// Most of the map burning, with smoke spreading from every fire.
+TEST_CASE( "wildfire_field_processing_benchmark", "[.][field][benchmark]" )
+{
+    fields_test_setup();
+    map &m = get_map();
+    for( const tripoint &p : m.points_on_zlevel() ) {
+        if( ( p.x + p.y ) % 3 != 0 ) {
+            m.ter_set( p, ter_t_tree_walnut );
+        }
+        if( p.x % 4 == 0 ) {
+            m.add_field( p, fd_fire, 2 );
+        }
+    }
+
+    BENCHMARK( "process_fields" ) {
+        calendar::turn += 1_turns;
+        m.process_fields();
+        return m.get_field_intensity( tripoint( 60, 60, 0 ), fd_fire );
+    };
+    fields_test_cleanup();
+}
+
+// Smoke intensities on the z-level of p, after a cloud around it has spread for a while.
+static std::vector<int> spread_smoke_cloud( const tripoint &p )
+{
+    fields_test_setup();
+    rng_set_engine_seed( 4242424242 );
+    map &m = get_map();
+    for( const tripoint &cloud : m.points_in_radius( p, 2 ) ) {
+        m.add_field( cloud, fd_smoke, 3, 1_turns );
+    }
+    for( int i = 0; i < 20; i++ ) {
+        calendar::turn += 1_turns;
+        m.process_fields();
+    }
+    std::vector<int> intensities;
+    for( const tripoint &cursor : m.points_on_zlevel( p.z ) ) {
+        intensities.push_back( m.get_field_intensity( cursor, fd_smoke ) );
+    }
+    fields_test_cleanup();
+    return intensities;
+}
+
+TEST_CASE( "parallel_gas_spreading", "[field]" )
+{
+    restore_on_out_of_scope<bool> restore_parallel( parallel_fields );
+    scoped_weather_override weather_clear( WEATHER_CLEAR );
+    weather_clear.with_windspeed( 0 );
+    // On the corner of four submaps, so the cloud spreads across their borders.
+    const tripoint p( SEEX * 5, SEEY * 5, 0 );
+    const int initial_tiles = 25;
+
+    parallel_fields = true;
+    const std::vector<int> first = spread_smoke_cloud( p );
+    const std::vector<int> second = spread_smoke_cloud( p );
+    CHECK( first == second );
+    CHECK( std::count_if( first.begin(), first.end(), []( const int intensity ) {
+        return intensity > 0;
+    } ) > initial_tiles );
+
+    parallel_fields = false;
+    const std::vector<int> serial = spread_smoke_cloud( p );
+    CHECK( std::count_if( serial.begin(), serial.end(), []( const int intensity ) {
+        return intensity > 0;
+    } ) > initial_tiles );
+}
+
+// A large gas cloud over most of the map, as from a burning city block.
+TEST_CASE( "gas_cloud_field_processing_benchmark", "[.][field][benchmark]" )
+{
+    restore_on_out_of_scope<bool> restore_parallel( parallel_fields );
+    fields_test_setup();
+    map &m = get_map();
+    const auto refill = [&m]() {
+        for( const tripoint &p : m.points_on_zlevel() ) {
+            if( ( p.x + p.y ) % 2 == 0 ) {
+                m.add_field( p, fd_smoke, 3, 1_turns );
+            }
+        }
+    };
+
+    parallel_fields = false;
+    refill();
+    BENCHMARK( "serial" ) {
+        calendar::turn += 1_turns;
+        m.process_fields();
+        return m.get_field_intensity( tripoint( 60, 60, 0 ), fd_smoke );
+    };
+    parallel_fields = true;
+    refill();
+    BENCHMARK( "parallel" ) {
+        calendar::turn += 1_turns;
+        m.process_fields();
+        return m.get_field_intensity( tripoint( 60, 60, 0 ), fd_smoke );
+    };
+    fields_test_cleanup();
+}
+
 TEST_CASE( "player_double_effect_field_test", "[field][player]" )
 {
     fields_test_setup();
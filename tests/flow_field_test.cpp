@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <vector>
+
+#include "cached_options.h"
+#include "cata_catch.h"
+#include "cata_scope_helpers.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "rng.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+static const ter_str_id ter_t_door_c( "t_door_c" );
+static const ter_str_id ter_t_underbrush( "t_underbrush" );
+
+// Open ground with scattered walls and patches of slow undergrowth.
+static void build_maze( map &here )
+{
+    clear_map();
+    const int mapsize = here.getmapsize() * SEEX;
+    for( int x = 0; x < mapsize; x++ ) {
+        for( int y = 0; y < mapsize; y++ ) {
+            const int pattern = ( x * 7 + y * 13 + x * y ) % 23;
+            if( pattern < 4 ) {
+                here.ter_set( tripoint( x, y, 0 ), ter_t_brick_wall );
+            } else if( pattern < 7 ) {
+                here.ter_set( tripoint( x, y, 0 ), ter_t_underbrush );
+            }
+        }
+    }
+}
+
+static int route_cost( const map &here, const tripoint &f, const std::vector<tripoint> &route )
+{
+    int cost = 0;
+    tripoint prev = f;
+    for( const tripoint &p : route ) {
+        cost += here.move_cost( p ) + ( prev.x != p.x && prev.y != p.y ? 1 : 0 );
+        prev = p;
+    }
+    return cost;
+}
+
+static void check_route_valid( const map &here, const tripoint &f, const tripoint &t,
+                               const std::vector<tripoint> &route )
+{
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == t );
+    tripoint prev = f;
+    int bad_steps = 0;
+    for( const tripoint &p : route ) {
+        if( square_dist( prev, p ) != 1 || here.impassable( p ) ) {
+            ++bad_steps;
+        }
+        prev = p;
+    }
+    CHECK( bad_steps == 0 );
+}
+
+static tripoint random_passable_point( const map &here )
+{
+    const int mapsize = here.getmapsize() * SEEX;
+    while( true ) {
+        const tripoint p( rng( 0, mapsize - 1 ), rng( 0, mapsize - 1 ), 0 );
+        if( !here.impassable( p ) ) {
+            return p;
+        }
+    }
+}
+
+static pathfinding_settings horde_settings()
+{
+    pathfinding_settings settings;
+    settings.max_dist = 1000;
+    settings.max_length = 10000;
+    return settings;
+}
+
+TEST_CASE( "shared_target_routes_are_as_cheap_as_exact_routes", "[pathfinding]" )
+{
+    map &here = get_map();
+    build_maze( here );
+    restore_on_out_of_scope<bool> restore_flow_fields( horde_flow_fields );
+    horde_flow_fields = true;
+    const pathfinding_settings settings = horde_settings();
+    const tripoint t = random_passable_point( here );
+
+    int compared = 0;
+    for( int i = 0; i < 30; i++ ) {
+        const tripoint f = random_passable_point( here );
+        if( f == t ) {
+            continue;
+        }
+        CAPTURE( f, t );
+        const std::vector<tripoint> exact = here.route( f, t, settings );
+        const std::vector<tripoint> shared = here.route_to_shared_target( f, t, settings );
+        if( exact.empty() ) {
+            continue;
+        }
+        ++compared;
+        check_route_valid( here, f, t, shared );
+        // A* only searches near the straight line, so it can't be cheaper.
+        CHECK( route_cost( here, f, shared ) <= route_cost( here, f, exact ) );
+    }
+    CHECK( compared > 0 );
+    clear_map();
+}
+
+TEST_CASE( "shared_target_routes_notice_map_changes", "[pathfinding]" )
+{
+    map &here = get_map();
+    clear_map();
+    restore_on_out_of_scope<bool> restore_flow_fields( horde_flow_fields );
+    horde_flow_fields = true;
+    const pathfinding_settings settings = horde_settings();
+
+    // A wall with a single gap between the horde and its target.
+    for( int y = 20; y < 100; y++ ) {
+        if( y != 60 ) {
+            here.ter_set( tripoint( 60, y, 0 ), ter_t_brick_wall );
+        }
+    }
+    const tripoint t( 80, 60, 0 );
+    const std::vector<tripoint> horde = { { 40, 50, 0 }, { 40, 60, 0 }, { 40, 70, 0 } };
+    for( const tripoint &f : horde ) {
+        const std::vector<tripoint> route = here.route_to_shared_target( f, t, settings );
+        check_route_valid( here, f, t, route );
+        CHECK( std::find( route.begin(), route.end(), tripoint( 60, 60, 0 ) ) != route.end() );
+    }
+
+    // Move the gap; the next routes have to use the new one.
+    here.ter_set( tripoint( 60, 60, 0 ), ter_t_brick_wall );
+    here.ter_set( tripoint( 60, 30, 0 ), ter_t_underbrush );
+    for( const tripoint &f : horde ) {
+        const std::vector<tripoint> route = here.route_to_shared_target( f, t, settings );
+        check_route_valid( here, f, t, route );
+        CHECK( std::find( route.begin(), route.end(), tripoint( 60, 30, 0 ) ) != route.end() );
+    }
+    clear_map();
+}
+
+TEST_CASE( "shared_target_routes_open_doors_like_exact_routes", "[pathfinding]" )
+{
+    map &here = get_map();
+    clear_map();
+    restore_on_out_of_scope<bool> restore_flow_fields( horde_flow_fields );
+    horde_flow_fields = true;
+
+    // A wall with a closed door on the way and an open gap far to the side.
+    for( int y = 20; y < 100; y++ ) {
+        here.ter_set( tripoint( 60, y, 0 ), y == 60 ? ter_t_door_c : ter_t_brick_wall );
+    }
+    here.ter_set( tripoint( 60, 25, 0 ), ter_t_underbrush );
+    const tripoint door( 60, 60, 0 );
+    const tripoint gap( 60, 25, 0 );
+    const tripoint t( 80, 60, 0 );
+    const std::vector<tripoint> horde = { { 40, 58, 0 }, { 40, 60, 0 }, { 40, 62, 0 } };
+    const auto passes = []( const std::vector<tripoint> &route, const tripoint & p ) {
+        return std::find( route.begin(), route.end(), p ) != route.end();
+    };
+
+    pathfinding_settings settings = horde_settings();
+    const bool doors = GENERATE( true, false );
+    CAPTURE( doors );
+    settings.allow_open_doors = doors;
+    for( const tripoint &f : horde ) {
+        CAPTURE( f );
+        const std::vector<tripoint> exact = here.route( f, t, settings );
+        const std::vector<tripoint> shared = here.route_to_shared_target( f, t, settings );
+        REQUIRE( !exact.empty() );
+        REQUIRE( !shared.empty() );
+        CHECK( shared.back() == t );
+        CHECK( passes( exact, door ) == doors );
+        CHECK( passes( shared, door ) == doors );
+        CHECK( passes( shared, gap ) == !doors );
+    }
+    clear_map();
+}
+
+TEST_CASE( "shared_target_routes_benchmark", "[.][pathfinding][benchmark]" )
+{
+    map &here = get_map();
+    build_maze( here );
+    restore_on_out_of_scope<bool> restore_flow_fields( horde_flow_fields );
+    horde_flow_fields = true;
+    const pathfinding_settings settings = horde_settings();
+    const tripoint t = random_passable_point( here );
+    std::vector<tripoint> horde;
+    for( int i = 0; i < 50; i++ ) {
+        horde.push_back( random_passable_point( here ) );
+    }
+
+    BENCHMARK( "50 monsters, route" ) {
+        size_t steps = 0;
+        for( const tripoint &f : horde ) {
+            steps += here.route( f, t, settings ).size();
+        }
+        return steps;
+    };
+    BENCHMARK( "50 monsters, route_to_shared_target" ) {
+        // One field per turn.
+        here.set_pathfinding_cache_dirty( t.z );
+        size_t steps = 0;
+        for( const tripoint &f : horde ) {
+            steps += here.route_to_shared_target( f, t, settings ).size();
+        }
+        return steps;
+    };
+    clear_map();
+}
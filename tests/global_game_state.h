@@ -0,0 +1,20 @@
+#pragma once
+#ifndef CATA_TESTS_GLOBAL_GAME_STATE_H
+#define CATA_TESTS_GLOBAL_GAME_STATE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "type_id.h"
+
+using name_value_pair_t = std::pair<std::string, std::string>;
+using option_overrides_t = std::vector<name_value_pair_t>;
+
+// Loads the game data and the given mods into a fresh world in user_dir, with the avatar
+// standing at the origin.  Shared by the tests and the benchmark (tests/bench).
+void init_global_game_state( const std::vector<mod_id> &mods,
+                             option_overrides_t &option_overrides,
+                             const std::string &user_dir );
+
+#endif // CATA_TESTS_GLOBAL_GAME_STATE_H
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cached_options.h"
+#include "cata_catch.h"
+#include "cata_scope_helpers.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "rng.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+static const ter_str_id ter_t_floor( "t_floor" );
+
+// A grid of walled buildings, each with a doorway gap on one side, separated
+// by streets.  Routes between buildings have to find the right gaps.
+static void build_city( map &here )
+{
+    clear_map();
+    const int mapsize = here.getmapsize() * SEEX;
+    constexpr int block = 16;
+    for( int bx = 4; bx + block <= mapsize - 4; bx += block ) {
+        for( int by = 4; by + block <= mapsize - 4; by += block ) {
+            const int size = block - 4;
+            const int gap = ( bx * 3 + by * 5 ) / block % 4;
+            for( int d = 0; d <= size; d++ ) {
+                const std::pair<point, int> walls[] = {
+                    { point( bx + d, by ), 0 }, { point( bx + d, by + size ), 1 },
+                    { point( bx, by + d ), 2 }, { point( bx + size, by + d ), 3 }
+                };
+                for( const std::pair<point, int> &wall : walls ) {
+                    const bool doorway = wall.second == gap && std::abs( d - size / 2 ) <= 1;
+                    here.ter_set( tripoint( wall.first, 0 ),
+                                  doorway ? ter_t_floor : ter_t_brick_wall );
+                }
+            }
+            for( int x = bx + 1; x < bx + size; x++ ) {
+                for( int y = by + 1; y < by + size; y++ ) {
+                    here.ter_set( tripoint( x, y, 0 ), ter_t_floor );
+                }
+            }
+        }
+    }
+}
+
+static int route_cost( const tripoint &f, const std::vector<tripoint> &route )
+{
+    int cost = 0;
+    tripoint prev = f;
+    for( const tripoint &p : route ) {
+        cost += prev.x != p.x && prev.y != p.y ? 3 : 2;
+        prev = p;
+    }
+    return cost;
+}
+
+static void check_route_valid( const map &here, const tripoint &f, const tripoint &t,
+                               const std::vector<tripoint> &route )
+{
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == t );
+    tripoint prev = f;
+    int bad_steps = 0;
+    for( const tripoint &p : route ) {
+        if( square_dist( prev, p ) != 1 || here.impassable( p ) ) {
+            ++bad_steps;
+        }
+        prev = p;
+    }
+    CHECK( bad_steps == 0 );
+}
+
+static tripoint random_passable_point( const map &here )
+{
+    const int mapsize = here.getmapsize() * SEEX;
+    while( true ) {
+        const tripoint p( rng( 0, mapsize - 1 ), rng( 0, mapsize - 1 ), 0 );
+        if( !here.impassable( p ) ) {
+            return p;
+        }
+    }
+}
+
+static pathfinding_settings long_route_settings()
+{
+    pathfinding_settings settings;
+    settings.max_dist = 1000;
+    settings.max_length = 10000;
+    return settings;
+}
+
+TEST_CASE( "hierarchical_pathfinding_matches_exact_routes", "[pathfinding]" )
+{
+    map &here = get_map();
+    build_city( here );
+    restore_on_out_of_scope<bool> restore_hierarchical( hierarchical_pathfinding );
+    const pathfinding_settings settings = long_route_settings();
+
+    int compared = 0;
+    for( int i = 0; i < 40; i++ ) {
+        const tripoint f = random_passable_point( here );
+        const tripoint t = random_passable_point( here );
+        if( rl_dist( f, t ) < pathfinding_hierarchy::min_route_distance ) {
+            continue;
+        }
+        CAPTURE( f, t );
+        hierarchical_pathfinding = false;
+        const std::vector<tripoint> exact = here.route( f, t, settings );
+        hierarchical_pathfinding = true;
+        const std::vector<tripoint> coarse = here.route( f, t, settings );
+        if( exact.empty() ) {
+            continue;
+        }
+        ++compared;
+        check_route_valid( here, f, t, coarse );
+        // The refined route can't be much worse than the optimal one.
+        CHECK( route_cost( f, coarse ) * 5 <= route_cost( f, exact ) * 6 );
+    }
+    CHECK( compared > 0 );
+    clear_map();
+}
+
+TEST_CASE( "hierarchical_pathfinding_notices_map_changes", "[pathfinding]" )
+{
+    map &here = get_map();
+    build_city( here );
+    restore_on_out_of_scope<bool> restore_hierarchical( hierarchical_pathfinding );
+    hierarchical_pathfinding = true;
+    const pathfinding_settings settings = long_route_settings();
+
+    // From a building in one corner of the city to one in the opposite corner.
+    const tripoint f( 10, 10, 0 );
+    const tripoint t( 106, 106, 0 );
+    const std::vector<tripoint> before = here.route( f, t, settings );
+    check_route_valid( here, f, t, before );
+
+    // Block the route halfway; the new one has to go around.
+    const tripoint blocked = before[before.size() / 2];
+    here.ter_set( blocked, ter_t_brick_wall );
+    const std::vector<tripoint> after = here.route( f, t, settings );
+    check_route_valid( here, f, t, after );
+    CHECK( std::find( after.begin(), after.end(), blocked ) == after.end() );
+    clear_map();
+}
+
+TEST_CASE( "hierarchical_pathfinding_benchmark", "[.][pathfinding][benchmark]" )
+{
+    map &here = get_map();
+    build_city( here );
+    restore_on_out_of_scope<bool> restore_hierarchical( hierarchical_pathfinding );
+    const pathfinding_settings settings = long_route_settings();
+    const tripoint f( 2, 2, 0 );
+    const tripoint t( here.getmapsize() * SEEX - 3, here.getmapsize() * SEEY - 3, 0 );
+
+    BENCHMARK( "exact" ) {
+        hierarchical_pathfinding = false;
+        return here.route( f, t, settings ).size();
+    };
+    BENCHMARK( "hierarchical" ) {
+        hierarchical_pathfinding = true;
+        return here.route( f, t, settings ).size();
+    };
+    clear_map();
+}
@@ -0,0 +1,46 @@
+#include <chrono>
+#include <string>
+
+#include "cata_catch.h"
+#include "latency_histogram.h"
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+TEST_CASE( "latency_histogram_buckets_and_percentiles", "[nogame]" )
+{
+    latency_histogram histogram;
+    CHECK( histogram.count() == 0 );
+    CHECK( histogram.percentile( 0.5 ) == latency_histogram::duration::zero() );
+
+    // 90 fast samples and 10 slow ones.
+    for( int i = 0; i < 90; i++ ) {
+        histogram.record( microseconds( 100 ) );
+    }
+    for( int i = 0; i < 10; i++ ) {
+        histogram.record( milliseconds( 20 ) );
+    }
+    CHECK( histogram.count() == 100 );
+    CHECK( histogram.longest() == milliseconds( 20 ) );
+    // 100 us lies in [64, 128) us, 20 ms in [16384, 32768) us.
+    CHECK( histogram.bucket_count( 7 ) == 90 );
+    CHECK( histogram.bucket_count( 15 ) == 10 );
+    CHECK( histogram.percentile( 0.5 ) == microseconds( 128 ) );
+    CHECK( histogram.percentile( 0.95 ) == microseconds( 32768 ) );
+
+    const std::string summary = histogram.to_string();
+    CHECK( summary.find( "100 samples" ) == 0 );
+    CHECK( summary.find( '%' ) == std::string::npos );
+
+    histogram.clear();
+    CHECK( histogram.count() == 0 );
+    CHECK( histogram.bucket_count( 7 ) == 0 );
+}
+
+TEST_CASE( "latency_histogram_keeps_outliers", "[nogame]" )
+{
+    latency_histogram histogram;
+    histogram.record( std::chrono::hours( 1 ) );
+    CHECK( histogram.bucket_count( latency_histogram::num_buckets - 1 ) == 1 );
+    CHECK( histogram.percentile( 1.0 ) == std::chrono::hours( 1 ) );
+}
@@ -0,0 +1,93 @@
+#include <cstddef>
+#include <string>
+
+#include "cata_catch.h"
+#include "lru_cache.h"
+#include "point.h"
+
+TEST_CASE( "flat_lru_cache_basic_operations", "[lru_cache][nogame]" )
+{
+    flat_lru_cache<point, char> cache;
+    CHECK( cache.get( point_zero, -1 ) == -1 );
+
+    cache.insert( 100, point_zero, 1 );
+    cache.insert( 100, point_east, 0 );
+    CHECK( cache.capacity() == 128 );
+    CHECK( cache.get( point_zero, -1 ) == 1 );
+    CHECK( cache.get( point_east, -1 ) == 0 );
+    CHECK( cache.get( point_west, -1 ) == -1 );
+
+    cache.insert( 100, point_zero, 0 );
+    CHECK( cache.get( point_zero, -1 ) == 0 );
+
+    cache.remove( point_zero );
+    CHECK( cache.get( point_zero, -1 ) == -1 );
+    CHECK( cache.get( point_east, -1 ) == 0 );
+
+    cache.clear();
+    CHECK( cache.get( point_east, -1 ) == -1 );
+    // Capacity is kept across clears.
+    CHECK( cache.capacity() == 128 );
+}
+
+TEST_CASE( "flat_lru_cache_keeps_recently_used_entries", "[lru_cache][nogame]" )
+{
+    constexpr int limit = 1024;
+    flat_lru_cache<point, int> cache;
+    // Keep touching one entry while flooding the cache with many times its
+    // capacity; it must survive, while most of the flood is evicted.
+    cache.insert( limit, point_zero, 42 );
+    int survivors = 0;
+    for( int i = 1; i < limit * 8; ++i ) {
+        cache.insert( limit, point( i, -i ), i );
+        REQUIRE( cache.get( point_zero, -1 ) == 42 );
+    }
+    for( int i = 1; i < limit * 8; ++i ) {
+        if( cache.get( point( i, -i ), -1 ) == i ) {
+            ++survivors;
+        }
+    }
+    CHECK( survivors <= limit );
+    // The newest entries are still there.
+    CHECK( cache.get( point( limit * 8 - 1, 1 - limit * 8 ), -1 ) == limit * 8 - 1 );
+}
+
+template<typename Cache>
+static void run_sees_cache_benchmark( const char *name )
+{
+    // Mimics map::sees: keys are packed coordinate pairs, limit is 100000.
+    constexpr int limit = 100000;
+    constexpr int span = 132;
+    Cache cache;
+    for( int x = 0; x < span; ++x ) {
+        for( int y = 0; y < span; ++y ) {
+            cache.insert( limit, point( x << 8 | y, y << 8 | x ), 1 );
+        }
+    }
+    int i = 0;
+    BENCHMARK( std::string( name ) + " hit" ) {
+        ++i;
+        return cache.get( point( ( i % span ) << 8 | ( i / span % span ), ( i / span % span ) << 8 |
+                                 ( i % span ) ), -1 );
+    };
+    BENCHMARK( std::string( name ) + " miss and insert" ) {
+        ++i;
+        const point key( i, -i );
+        const char cached = cache.get( key, -1 );
+        if( cached < 0 ) {
+            cache.insert( limit, key, 0 );
+        }
+        return cached;
+    };
+    BENCHMARK( std::string( name ) + " clear" ) {
+        cache.clear();
+        cache.insert( limit, point( i, i ), 1 );
+        return cache.get( point( i, i ), -1 );
+    };
+}
+
+TEST_CASE( "lru_cache_benchmark", "[.][lru_cache][benchmark][nogame]" )
+{
+    run_sees_cache_benchmark<lru_cache<point, char>>( "lru_cache" );
+    run_sees_cache_benchmark<flat_lru_cache<point, char>>( "flat_lru_cache" );
+}
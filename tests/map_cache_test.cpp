@@ -0,0 +1,164 @@
+#include <array>
+#include <memory>
+
+#include "cached_options.h"
+#include "calendar.h"
+#include "cata_catch.h"
+#include "cata_scope_helpers.h"
+#include "level_cache.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "point.h"
+#include "type_id.h"
+
+static const field_type_str_id field_fd_smoke( "fd_smoke" );
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+static const ter_str_id ter_t_floor( "t_floor" );
+static const ter_str_id ter_t_open_air( "t_open_air" );
+static const ter_str_id ter_t_utility_light( "t_utility_light" );
+static const ter_str_id ter_t_window_frame( "t_window_frame" );
+
+using level_cache_snapshot = std::array<std::unique_ptr<level_cache>, OVERMAP_LAYERS>;
+
+static level_cache_snapshot rebuild_and_snapshot( map &here )
+{
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        here.invalidate_map_cache( z );
+    }
+    here.build_map_cache( 0, true );
+
+    level_cache_snapshot result;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        result[z + OVERMAP_DEPTH] = std::make_unique<level_cache>( here.get_cache_ref( z ) );
+    }
+    return result;
+}
+
+TEST_CASE( "parallel_map_cache_matches_serial", "[map][cache]" )
+{
+    clear_map( -2, 3 );
+    map &here = get_map();
+
+    // Scatter walls, windows, floor gaps and smoke over several z-levels so
+    // that every per-level cache has something non-trivial in it.
+    const int mapsize = here.getmapsize() * SEEX;
+    for( int z = -1; z <= 3; ++z ) {
+        for( int x = 0; x < mapsize; ++x ) {
+            for( int y = 0; y < mapsize; ++y ) {
+                const tripoint p( x, y, z );
+                const int pattern = ( x * 7 + y * 13 + z * 5 ) % 17;
+                if( pattern == 0 ) {
+                    here.ter_set( p, ter_t_brick_wall );
+                } else if( pattern == 1 ) {
+                    here.ter_set( p, ter_t_window_frame );
+                } else if( pattern == 2 && z > 0 ) {
+                    here.ter_set( p, ter_t_open_air );
+                } else if( pattern == 3 && z > 0 ) {
+                    here.ter_set( p, ter_t_floor );
+                } else if( pattern == 4 ) {
+                    here.add_field( p, field_fd_smoke, 2 );
+                }
+            }
+        }
+    }
+
+    restore_on_out_of_scope<bool> restore_parallel( parallel_map_cache );
+
+    parallel_map_cache = false;
+    const level_cache_snapshot serial = rebuild_and_snapshot( here );
+    parallel_map_cache = true;
+    const level_cache_snapshot parallel = rebuild_and_snapshot( here );
+
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        CAPTURE( z );
+        const level_cache &s = *serial[z + OVERMAP_DEPTH];
+        const level_cache &p = *parallel[z + OVERMAP_DEPTH];
+        CHECK( s.no_floor_gaps == p.no_floor_gaps );
+        int mismatches = 0;
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                if( s.outside_cache[x][y] != p.outside_cache[x][y] ||
+                    s.floor_cache[x][y] != p.floor_cache[x][y] ||
+                    s.transparency_cache[x][y] != p.transparency_cache[x][y] ||
+                    s.vision_transparency_cache[x][y] != p.vision_transparency_cache[x][y] ||
+                    s.transparent_cache_wo_fields[x][y] != p.transparent_cache_wo_fields[x][y] ) {
+                    ++mismatches;
+                }
+            }
+        }
+        CHECK( mismatches == 0 );
+    }
+
+    clear_map( -2, 3 );
+}
+
+static void check_lightmap_matches_full_rebuild( map &here, const int z )
+{
+    here.build_map_cache( z );
+    const std::unique_ptr<level_cache> incremental = std::make_unique<level_cache>
+            ( here.get_cache_ref( z ) );
+
+    // Invalidating the map cache recasts every light source.
+    here.invalidate_map_cache( z );
+    here.build_map_cache( z );
+    const level_cache &full = here.get_cache_ref( z );
+
+    int mismatches = 0;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            if( incremental->lm[x][y].values != full.lm[x][y].values ||
+                incremental->sm[x][y] != full.sm[x][y] ) {
+                ++mismatches;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+TEST_CASE( "incremental_lightmap_matches_full_rebuild", "[map][cache][lightmap]" )
+{
+    clear_map();
+    restore_on_out_of_scope<time_point> restore_calendar_turn( calendar::turn );
+    set_time( calendar::turn_zero );
+    map &here = get_map();
+    const int z = 0;
+
+    // A few lamps, each in its own walled room with a doorway.
+    const std::array<point, 3> lamps = {{ { 30, 30 }, { 70, 40 }, { 50, 90 } }};
+    for( const point &lamp : lamps ) {
+        for( int d = -4; d <= 4; ++d ) {
+            here.ter_set( tripoint( lamp + point( d, -4 ), z ), ter_t_brick_wall );
+            here.ter_set( tripoint( lamp + point( d, 4 ), z ), ter_t_brick_wall );
+            here.ter_set( tripoint( lamp + point( -4, d ), z ), ter_t_brick_wall );
+            if( d != 0 ) {
+                here.ter_set( tripoint( lamp + point( 4, d ), z ), ter_t_brick_wall );
+            }
+        }
+        here.ter_set( tripoint( lamp, z ), ter_t_utility_light );
+    }
+    check_lightmap_matches_full_rebuild( here, z );
+
+    SECTION( "unchanged scene" ) {
+        check_lightmap_matches_full_rebuild( here, z );
+    }
+    SECTION( "light source moved" ) {
+        here.ter_set( tripoint( lamps[0], z ), ter_t_floor );
+        here.ter_set( tripoint( lamps[0] + point_east, z ), ter_t_utility_light );
+        check_lightmap_matches_full_rebuild( here, z );
+    }
+    SECTION( "light source removed" ) {
+        here.ter_set( tripoint( lamps[1], z ), ter_t_floor );
+        check_lightmap_matches_full_rebuild( here, z );
+    }
+    SECTION( "doorway closed" ) {
+        here.ter_set( tripoint( lamps[2] + point( 4, 0 ), z ), ter_t_brick_wall );
+        check_lightmap_matches_full_rebuild( here, z );
+    }
+    SECTION( "wall removed far from any light" ) {
+        here.ter_set( tripoint( 120, 120, z ), ter_t_brick_wall );
+        check_lightmap_matches_full_rebuild( here, z );
+    }
+
+    clear_map();
+}
@@ -1,14 +1,17 @@
 #include <bitset>
 #include <cstdio>
 #include <sstream>
+#include <string>
 #include <type_traits>
 
 #include "cata_catch.h"
 #include "game_constants.h"
 #include "json.h"
+#include "json_loader.h"
 #include "lru_cache.h"
 #include "map.h"
 #include "map_memory.h"
+#include "memory_fast.h"
 #include "point.h"
 
 static constexpr tripoint_abs_ms p1{ -SEEX - 2, -SEEY - 3, -1 };
@@ -122,7 +125,77 @@ TEST_CASE( "map_memory_forgets", "[map_memory]" )
     CHECK( mt.get_dec_rotation() == 0 );
 }
 
-// TODO: map memory save / load
+TEST_CASE( "map_memory_tiles_are_small", "[map_memory]" )
+{
+    // Ids are interned rather than stored in each tile.
+    CHECK( sizeof( memorized_tile ) <= 16 );
+    CHECK( memorized_tile::intern( "t_foo" ) == memorized_tile::intern( std::string( "t_foo" ) ) );
+    CHECK( memorized_tile::interned( memorized_tile::intern( "vp_foo" ) ) == "vp_foo" );
+    CHECK( memorized_tile::intern( "" ) == 0 );
+}
+
+static void check_tile( const memorized_tile &mt, char32_t symbol, const std::string &ter,
+                        const std::string &dec )
+{
+    CHECK( mt.symbol == symbol );
+    CHECK( mt.get_ter_id() == ter );
+    CHECK( mt.get_dec_id() == dec );
+}
+
+TEST_CASE( "map_memory_region_save_load", "[map_memory]" )
+{
+    mm_region region;
+    for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
+        for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
+            region.submaps[x][y] = make_shared_fast<mm_submap>();
+        }
+    }
+    memorized_tile wall;
+    wall.symbol = '#';
+    wall.set_ter_id( "t_wall" );
+    memorized_tile chair = wall;
+    chair.set_ter_id( "t_floor" );
+    chair.set_dec_id( "f_chair" );
+    chair.set_dec_rotation( 2 );
+    region.submaps[0][0]->set_tile( point_sm_ms( 1, 1 ), wall );
+    region.submaps[0][0]->set_tile( point_sm_ms( 1, 2 ), chair );
+    region.submaps[1][2]->set_tile( point_sm_ms( 5, 5 ), chair );
+
+    std::ostringstream out;
+    JsonOut jsout( out );
+    region.serialize( jsout );
+    const std::string saved = out.str();
+    // Each id is saved once for the whole region.
+    CHECK( saved.find( "f_chair" ) == saved.rfind( "f_chair" ) );
+
+    mm_region loaded;
+    loaded.deserialize( json_loader::from_string( saved ) );
+    check_tile( loaded.submaps[0][0]->get_tile( point_sm_ms( 1, 1 ) ), '#', "t_wall", "" );
+    check_tile( loaded.submaps[0][0]->get_tile( point_sm_ms( 1, 2 ) ), '#', "t_floor", "f_chair" );
+    CHECK( loaded.submaps[0][0]->get_tile( point_sm_ms( 1, 2 ) ).get_dec_rotation() == 2 );
+    check_tile( loaded.submaps[1][2]->get_tile( point_sm_ms( 5, 5 ) ), '#', "t_floor", "f_chair" );
+    CHECK( loaded.submaps[0][0]->get_tile( point_sm_ms( 0, 0 ) ) == mm_submap::default_tile );
+    CHECK( loaded.submaps[0][1]->is_empty() );
+}
+
+TEST_CASE( "map_memory_loads_version_1_regions", "[map_memory]" )
+{
+    // One submap in the first corner of the region, the rest empty.
+    std::string saved = "{\"version\":1,\"data\":[[[1,35,\"t_wall\",0,0],"
+                        "[142,0,\"t_floor\",0,0,\"f_chair\",0,1],[1,0,\"\",0,0]]";
+    for( size_t i = 1; i < MM_REG_SIZE * MM_REG_SIZE; i++ ) {
+        saved += ",null";
+    }
+    saved += "]}";
+
+    mm_region loaded;
+    loaded.deserialize( json_loader::from_string( saved ) );
+    check_tile( loaded.submaps[0][0]->get_tile( point_sm_ms( 0, 0 ) ), '#', "t_wall", "" );
+    check_tile( loaded.submaps[0][0]->get_tile( point_sm_ms( 5, 5 ) ), 0, "t_floor", "f_chair" );
+    CHECK( loaded.submaps[0][0]->get_tile( point_sm_ms( 5, 5 ) ).get_dec_rotation() == 1 );
+    CHECK( loaded.submaps[0][0]->get_tile( point_sm_ms( SEEX - 1, SEEY - 1 ) ) ==
+           mm_submap::default_tile );
+}
 
 #include <chrono>
 
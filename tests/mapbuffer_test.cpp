@@ -0,0 +1,111 @@
+#include <optional>
+#include <string>
+
+#include "cata_catch.h"
+#include "cata_utility.h"
+#include "coordinates.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapbuffer.h"
+#include "options_helpers.h"
+#include "path_info.h"
+#include "point.h"
+#include "string_formatter.h"
+#include "submap.h"
+#include "submap_binary.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+
+TEST_CASE( "prefetched_submaps_load_like_direct_reads", "[map][mapbuffer]" )
+{
+    clear_map();
+    map &here = get_map();
+    // A quad well outside the reality bubble, so that saving unloads it.
+    const tripoint_abs_omt far_omt = project_to<coords::omt>( here.get_abs_sub() ) + point( 20, 0 );
+    const tripoint_abs_sm far_sm = project_to<coords::sm>( far_omt );
+    {
+        tinymap far_map;
+        far_map.load( far_omt, false );
+        far_map.ter_set( tripoint( 5, 5, far_omt.z() ), ter_t_brick_wall );
+    }
+    MAPBUFFER.save();
+
+    SECTION( "read directly" ) {
+        submap *sm = MAPBUFFER.lookup_submap( far_sm );
+        REQUIRE( sm != nullptr );
+        CHECK( sm->get_ter( point( 5, 5 ) ) == ter_t_brick_wall.id() );
+    }
+    SECTION( "read ahead" ) {
+        MAPBUFFER.prefetch( far_sm );
+        MAPBUFFER.prefetch( far_sm + point_south );
+        REQUIRE( MAPBUFFER.wait_for_prefetch( far_sm ) );
+        const int used = MAPBUFFER.prefetched_quads_used;
+        submap *sm = MAPBUFFER.lookup_submap( far_sm );
+        REQUIRE( sm != nullptr );
+        CHECK( MAPBUFFER.prefetched_quads_used == used + 1 );
+        CHECK( sm->get_ter( point( 5, 5 ) ) == ter_t_brick_wall.id() );
+        // The rest of the quad came with it.
+        CHECK( MAPBUFFER.lookup_submap( far_sm + point_south ) != nullptr );
+    }
+    SECTION( "the oldest requests are dropped first" ) {
+        MAPBUFFER.prefetch( far_sm );
+        REQUIRE( MAPBUFFER.wait_for_prefetch( far_sm ) );
+        // Quads further out that were never saved.
+        const tripoint_abs_sm empty_sm = project_to<coords::sm>( far_omt + point( 100, 0 ) );
+        const int quads = static_cast<int>( mapbuffer::max_prefetched_quads );
+        for( int i = 0; i < quads; i++ ) {
+            MAPBUFFER.prefetch( empty_sm + point( 2 * i, 0 ) );
+        }
+        CHECK( MAPBUFFER.wait_for_prefetch( empty_sm + point( 2 * ( quads - 1 ), 0 ) ) );
+        CHECK_FALSE( MAPBUFFER.wait_for_prefetch( far_sm ) );
+        const int used = MAPBUFFER.prefetched_quads_used;
+        REQUIRE( MAPBUFFER.lookup_submap( far_sm ) != nullptr );
+        CHECK( MAPBUFFER.prefetched_quads_used == used );
+    }
+    MAPBUFFER.clear_outside_reality_bubble();
+}
+
+static bool quad_file_is_binary( const tripoint_abs_omt &om_addr )
+{
+    const tripoint_abs_seg seg = project_to<coords::seg>( om_addr );
+    const cata_path path = PATH_INFO::world_base_save_path_path() / "maps" /
+                           string_format( "%d.%d.%d", seg.x(), seg.y(), seg.z() ) /
+                           string_format( "%d.%d.%d.map", om_addr.x(), om_addr.y(), om_addr.z() );
+    const std::optional<std::string> contents = read_whole_file( path );
+    REQUIRE( contents );
+    return submap_binary::is_binary( *contents );
+}
+
+TEST_CASE( "binary_and_json_quads_load_alike", "[map][mapbuffer]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint_abs_omt far_omt = project_to<coords::omt>( here.get_abs_sub() ) + point( 22, 0 );
+    const tripoint_abs_sm far_sm = project_to<coords::sm>( far_omt );
+    const bool binary = GENERATE( false, true );
+    CAPTURE( binary );
+    {
+        override_option save_binary( "BINARY_SUBMAPS", binary ? "true" : "false" );
+        tinymap far_map;
+        far_map.load( far_omt, false );
+        far_map.ter_set( tripoint( 5, 5, far_omt.z() ), ter_t_brick_wall );
+        MAPBUFFER.save();
+        CHECK( quad_file_is_binary( far_omt ) == binary );
+    }
+
+    // Either format loads, whatever the world saves in now.
+    override_option save_other( "BINARY_SUBMAPS", binary ? "false" : "true" );
+    submap *sm = MAPBUFFER.lookup_submap( far_sm );
+    REQUIRE( sm != nullptr );
+    CHECK( sm->get_ter( point( 5, 5 ) ) == ter_t_brick_wall.id() );
+    MAPBUFFER.clear_outside_reality_bubble();
+
+    // Converting rewrites the quad in the other format without changing it.
+    CHECK( MAPBUFFER.rewrite_saved_quads() > 0 );
+    CHECK( quad_file_is_binary( far_omt ) != binary );
+    sm = MAPBUFFER.lookup_submap( far_sm );
+    REQUIRE( sm != nullptr );
+    CHECK( sm->get_ter( point( 5, 5 ) ) == ter_t_brick_wall.id() );
+    MAPBUFFER.clear_outside_reality_bubble();
+}
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cata_catch.h"
@@ -6,6 +9,7 @@
 #include "coordinates.h"
 #include "game.h"
 #include "item.h"
+#include "line.h"
 #include "map.h"
 #include "map_helpers.h"
 #include "mongroup.h"
@@ -13,6 +17,8 @@
 #include "options.h"
 #include "options_helpers.h"
 #include "player_helpers.h"
+#include "point.h"
+#include "rng.h"
 
 static const mongroup_id GROUP_PETS( "GROUP_PETS" );
 static const mongroup_id GROUP_PET_DOGS( "GROUP_PET_DOGS" );
@@ -412,3 +418,166 @@ TEST_CASE( "mongroup_multi_spawn_restrictions", "[mongroup]" )
         CHECK( counts.count( mon_test_zombie_cop ) > 0 );
     }
 }
+
+// Groups on and around the overmap at the origin, their populations telling them apart.
+static void add_random_groups( mongroup_map &groups,
+                               std::multimap<tripoint_om_sm, mongroup> *reference, const int count )
+{
+    for( int i = 0; i < count; i++ ) {
+        const tripoint_abs_sm pos( rng( -20, 380 ), rng( -20, 380 ), rng( -1, 1 ) );
+        const mongroup group( GROUP_PETS, pos, static_cast<unsigned int>( groups.size() ) );
+        groups.emplace( group.rel_pos(), group );
+        if( reference != nullptr ) {
+            reference->emplace( group.rel_pos(), group );
+        }
+    }
+}
+
+template<typename Groups>
+static std::vector<unsigned int> populations_in_order( const Groups &groups )
+{
+    std::vector<unsigned int> ret;
+    for( const auto &elem : groups ) {
+        ret.push_back( elem.second.population );
+    }
+    return ret;
+}
+
+TEST_CASE( "mongroup_map_finds_nearby_groups_in_order", "[mongroup]" )
+{
+    rng_set_engine_seed( 17 );
+    mongroup_map groups;
+    add_random_groups( groups, nullptr, 2000 );
+
+    const auto check_near = [&]() {
+        for( int i = 0; i < 50; i++ ) {
+            const point_abs_sm center( rng( -40, 400 ), rng( -40, 400 ) );
+            const int radius = one_in( 10 ) ? rng( 100, 500 ) : rng( 0, 40 );
+            CAPTURE( center, radius );
+            std::vector<unsigned int> expected;
+            for( const mongroup_map::value_type &elem : groups ) {
+                if( square_dist( center, elem.second.abs_pos.xy() ) <= radius ) {
+                    expected.push_back( elem.second.population );
+                }
+            }
+            std::vector<unsigned int> actual;
+            for( const mongroup_map::iterator &it : groups.near( center, radius ) ) {
+                actual.push_back( it->second.population );
+            }
+            CHECK( actual == expected );
+        }
+    };
+
+    SECTION( "after adding groups" ) {
+        check_near();
+    }
+    SECTION( "after moving and erasing groups" ) {
+        std::vector<std::pair<mongroup_map::iterator, tripoint_om_sm>> moves;
+        std::vector<const mongroup *> moved;
+        for( auto it = groups.begin(); it != groups.end(); ) {
+            if( one_in( 5 ) ) {
+                it = groups.erase( it );
+                continue;
+            }
+            if( one_in( 2 ) ) {
+                it->second.abs_pos += tripoint( rng( -20, 20 ), rng( -20, 20 ), 0 );
+                moves.emplace_back( it, it->second.rel_pos() );
+                moved.push_back( &it->second );
+            }
+            ++it;
+        }
+        groups.move( moves );
+        for( size_t i = 0; i < moved.size(); i++ ) {
+            // The groups stay where they are in memory, now under their new position.
+            const auto range = groups.equal_range( moves[i].second );
+            CHECK( std::any_of( range.first, range.second,
+            [&]( const mongroup_map::value_type & elem ) {
+                return &elem.second == moved[i];
+            } ) );
+        }
+        check_near();
+    }
+    SECTION( "after clearing" ) {
+        groups.clear();
+        CHECK( groups.near( point_abs_sm( 180, 180 ), 1000 ).empty() );
+        add_random_groups( groups, nullptr, 100 );
+        check_near();
+    }
+}
+
+TEST_CASE( "mongroup_map_moves_groups_like_reinserting_them", "[mongroup]" )
+{
+    rng_set_engine_seed( 3 );
+    mongroup_map groups;
+    std::multimap<tripoint_om_sm, mongroup> reference;
+    // Few positions, so that many groups share them.
+    for( int i = 0; i < 500; i++ ) {
+        const tripoint_abs_sm pos( rng( 0, 4 ), rng( 0, 4 ), 0 );
+        const mongroup group( GROUP_PETS, pos, i );
+        groups.emplace( group.rel_pos(), group );
+        reference.emplace( group.rel_pos(), group );
+    }
+    REQUIRE( populations_in_order( groups ) == populations_in_order( reference ) );
+
+    for( int turn = 0; turn < 10; turn++ ) {
+        // What move_hordes used to do: erase moved groups and insert them again afterwards.
+        const std::vector<tripoint> steps = [&]() {
+            std::vector<tripoint> ret;
+            for( size_t i = 0; i < reference.size(); i++ ) {
+                ret.emplace_back( one_in( 3 ) ? tripoint( rng( -1, 1 ), rng( -1, 1 ), 0 ) :
+                                  tripoint_zero );
+            }
+            return ret;
+        }();
+        std::multimap<tripoint_om_sm, mongroup> moved_reference;
+        size_t i = 0;
+        for( auto it = reference.begin(); it != reference.end(); i++ ) {
+            if( steps[i] == tripoint_zero ) {
+                ++it;
+                continue;
+            }
+            it->second.abs_pos += steps[i];
+            moved_reference.emplace( it->second.rel_pos(), it->second );
+            reference.erase( it++ );
+        }
+        reference.insert( moved_reference.begin(), moved_reference.end() );
+
+        std::vector<std::pair<mongroup_map::iterator, tripoint_om_sm>> moves;
+        i = 0;
+        for( auto it = groups.begin(); it != groups.end(); ++it, i++ ) {
+            if( steps[i] != tripoint_zero ) {
+                it->second.abs_pos += steps[i];
+                moves.emplace_back( it, it->second.rel_pos() );
+            }
+        }
+        groups.move( moves );
+        CHECK( populations_in_order( groups ) == populations_in_order( reference ) );
+    }
+}
+
+TEST_CASE( "mongroup_signal_query_benchmark", "[.][mongroup][benchmark]" )
+{
+    rng_set_engine_seed( 5 );
+    mongroup_map groups;
+    add_random_groups( groups, nullptr, 20000 );
+    const point_abs_sm center( 180, 180 );
+
+    BENCHMARK( "scan every group" ) {
+        int found = 0;
+        for( const mongroup_map::value_type &elem : groups ) {
+            if( rl_dist( center, elem.second.abs_pos.xy() ) <= 12 ) {
+                found++;
+            }
+        }
+        return found;
+    };
+    BENCHMARK( "nearby groups" ) {
+        int found = 0;
+        for( const mongroup_map::iterator &it : groups.near( center, 12 ) ) {
+            if( rl_dist( center, it->second.abs_pos.xy() ) <= 12 ) {
+                found++;
+            }
+        }
+        return found;
+    };
+}
@@ -0,0 +1,102 @@
+#include <vector>
+
+#include "cata_catch.h"
+#include "field_type.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mdarray.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "rng.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+
+static cata::mdarray<pf_special, point_bub_ms> special_copy( const map &here )
+{
+    return here.get_pathfinding_cache_ref( 0 ).special;
+}
+
+static int count_differences( const cata::mdarray<pf_special, point_bub_ms> &a,
+                              const cata::mdarray<pf_special, point_bub_ms> &b, int mapsize )
+{
+    int differences = 0;
+    for( int x = 0; x < mapsize; x++ ) {
+        for( int y = 0; y < mapsize; y++ ) {
+            if( a[x][y] != b[x][y] ) {
+                ++differences;
+            }
+        }
+    }
+    return differences;
+}
+
+// Fire on every other tile of a block, so that it covers several submaps.
+static void toggle_fire( map &here, const point &origin, int size, bool lit )
+{
+    for( int x = origin.x; x < origin.x + size; x++ ) {
+        for( int y = origin.y + x % 2; y < origin.y + size; y += 2 ) {
+            if( lit ) {
+                here.add_field( tripoint( x, y, 0 ), fd_fire, 1 );
+            } else {
+                here.remove_field( tripoint( x, y, 0 ), fd_fire );
+            }
+        }
+    }
+}
+
+TEST_CASE( "pathfinding_cache_updates_changed_points", "[pathfinding]" )
+{
+    map &here = get_map();
+    clear_map();
+    const int mapsize = here.getmapsize() * SEEX;
+    here.get_pathfinding_cache_ref( 0 );
+
+    toggle_fire( here, point( 30, 30 ), 40, true );
+    for( int i = 0; i < 200; i++ ) {
+        const tripoint p( rng( 0, mapsize - 1 ), rng( 0, mapsize - 1 ), 0 );
+        here.ter_set( p, ter_t_brick_wall );
+    }
+    const cata::mdarray<pf_special, point_bub_ms> incremental = special_copy( here );
+    CHECK( ( incremental[30][30] & PF_FIELD ) );
+    CHECK_FALSE( ( incremental[30][31] & PF_FIELD ) );
+
+    here.set_pathfinding_cache_dirty( 0 );
+    CHECK( count_differences( incremental, special_copy( here ), mapsize ) == 0 );
+
+    toggle_fire( here, point( 30, 30 ), 40, false );
+    const cata::mdarray<pf_special, point_bub_ms> cleared = special_copy( here );
+    CHECK_FALSE( ( cleared[30][30] & PF_FIELD ) );
+    here.set_pathfinding_cache_dirty( 0 );
+    CHECK( count_differences( cleared, special_copy( here ), mapsize ) == 0 );
+    clear_map();
+}
+
+TEST_CASE( "pathfinding_cache_fire_and_horde_benchmark", "[.][pathfinding][benchmark]" )
+{
+    map &here = get_map();
+    clear_map();
+    const int mapsize = here.getmapsize() * SEEX;
+    pathfinding_settings settings;
+    settings.max_dist = 1000;
+    settings.max_length = 10000;
+    const tripoint target( mapsize / 2, mapsize / 2, 0 );
+    std::vector<tripoint> horde;
+    for( int i = 0; i < 50; i++ ) {
+        horde.emplace_back( rng( 0, mapsize - 1 ), rng( 0, 10 ), 0 );
+    }
+    bool lit = false;
+
+    BENCHMARK( "fire spreading while 50 monsters route" ) {
+        // Thousands of tiles catch fire or burn out every turn.
+        lit = !lit;
+        toggle_fire( here, point( 10, 20 ), 100, lit );
+        size_t steps = 0;
+        for( const tripoint &f : horde ) {
+            steps += here.route( f, target, settings ).size();
+        }
+        return steps;
+    };
+    toggle_fire( here, point( 10, 20 ), 100, false );
+    clear_map();
+}
@@ -99,6 +99,27 @@ TEST_CASE( "rectangle_overlapping_half_open", "[point]" )
     CHECK( r5.overlaps( r4 ) );
 }
 
+TEST_CASE( "cuboid_overlapping_inclusive", "[point]" )
+{
+    inclusive_cuboid<tripoint> c1( tripoint_zero, tripoint( 2, 2, 0 ) );
+    inclusive_cuboid<tripoint> c2( tripoint( 2, 2, 0 ), tripoint( 3, 3, 1 ) );
+    inclusive_cuboid<tripoint> c3( tripoint( 0, 0, 1 ), tripoint( 2, 2, 1 ) );
+    inclusive_cuboid<tripoint> c4( tripoint( -2, -4, -1 ), tripoint( 4, -1, 1 ) );
+
+    CHECK( c1.overlaps( c1 ) );
+    CHECK( c1.overlaps( c2 ) );
+    CHECK( !c1.overlaps( c3 ) );
+    CHECK( !c1.overlaps( c4 ) );
+
+    CHECK( c2.overlaps( c1 ) );
+    CHECK( c2.overlaps( c3 ) );
+    CHECK( !c2.overlaps( c4 ) );
+
+    CHECK( !c3.overlaps( c1 ) );
+    CHECK( c3.overlaps( c2 ) );
+    CHECK( !c4.overlaps( c3 ) );
+}
+
 TEST_CASE( "rectangle_containment_coord", "[point]" )
 {
     // NOLINTNEXTLINE(cata-use-named-point-constants)
@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cata_catch.h"
+#include "flexbuffer_json.h"
+#include "json_loader.h"
+#include "profiler.h"
+
+// Without the profiler there is nothing to test.
+#if !defined( CATA_NO_PROFILER )
+
+namespace
+{
+
+struct traced_zone {
+    std::string name;
+    int64_t start;
+    int64_t end;
+};
+
+} // namespace
+
+static std::vector<traced_zone> read_trace()
+{
+    std::ostringstream out;
+    profiler::write_trace( out );
+    const JsonValue trace = json_loader::from_string( out.str() );
+    const JsonObject trace_object = trace;
+    trace_object.allow_omitted_members();
+    std::vector<traced_zone> ret;
+    for( const JsonObject event : trace_object.get_array( "traceEvents" ) ) {
+        event.allow_omitted_members();
+        CHECK( event.get_string( "ph" ) == "X" );
+        const int64_t start = event.get_int( "ts" );
+        const int64_t end = start + event.get_int( "dur" );
+        ret.push_back( traced_zone{ event.get_string( "name" ), start, end } );
+    }
+    return ret;
+}
+
+static void run_zones()
+{
+    CATA_PROFILE_ZONE( "outer" );
+    for( int i = 0; i < 2; i++ ) {
+        CATA_PROFILE_ZONE( "inner" );
+    }
+}
+
+TEST_CASE( "profiler_records_nested_zones", "[nogame]" )
+{
+    profiler::start();
+    run_zones();
+    profiler::stop();
+    // Not recording any more.
+    run_zones();
+
+    const std::string report = profiler::report();
+    CAPTURE( report );
+    CHECK( report.find( "\nouter " ) != std::string::npos );
+    CHECK( report.find( "\n  inner " ) != std::string::npos );
+
+    const std::vector<traced_zone> zones = read_trace();
+    REQUIRE( zones.size() == 3 );
+    // Zones are written as they end, the inner ones first.
+    CHECK( zones[0].name == "inner" );
+    CHECK( zones[1].name == "inner" );
+    CHECK( zones[2].name == "outer" );
+    for( int i = 0; i < 2; i++ ) {
+        CHECK( zones[i].start >= zones[2].start );
+        CHECK( zones[i].end <= zones[2].end );
+    }
+    CHECK( zones[0].end <= zones[1].start );
+
+    const std::vector<profiler::zone_total> totals = profiler::totals();
+    REQUIRE( totals.size() == 2 );
+    CHECK( totals[0].path == "outer" );
+    CHECK( totals[0].calls == 1 );
+    CHECK( totals[1].path == "outer/inner" );
+    CHECK( totals[1].calls == 2 );
+    CHECK( totals[1].total <= totals[0].total );
+
+    SECTION( "starting again discards the previous recording" ) {
+        profiler::start();
+        {
+            CATA_PROFILE_ZONE( "other" );
+        }
+        profiler::stop();
+        const std::vector<traced_zone> again = read_trace();
+        REQUIRE( again.size() == 1 );
+        CHECK( again[0].name == "other" );
+        CHECK( profiler::report().find( "outer" ) == std::string::npos );
+    }
+}
+
+TEST_CASE( "profiler_ignores_zones_from_an_earlier_recording", "[nogame]" )
+{
+    profiler::start();
+    {
+        CATA_PROFILE_ZONE( "before restart" );
+        profiler::start();
+        {
+            CATA_PROFILE_ZONE( "after restart" );
+        }
+    }
+    profiler::stop();
+    const std::vector<traced_zone> zones = read_trace();
+    REQUIRE( zones.size() == 1 );
+    CHECK( zones[0].name == "after restart" );
+    // Its parent was from the earlier recording, so it is at the top level now.
+    CHECK( profiler::report().find( "\nafter restart " ) != std::string::npos );
+}
+
+#endif
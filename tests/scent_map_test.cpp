@@ -0,0 +1,120 @@
+#include <array>
+#include <string>
+
+#include "cata_catch.h"
+#include "cata_scope_helpers.h"
+#include "game.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "point.h"
+#include "rng.h"
+#include "scent_map.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+static const ter_str_id ter_t_door_locked( "t_door_locked" );
+
+static const std::array<scent_kernel, 3> column_kernels = {{
+        scent_kernel::columns_scalar, scent_kernel::columns_sse2, scent_kernel::columns_avx2
+    }
+};
+
+static const tripoint scent_center( MAPSIZE_X / 2, MAPSIZE_Y / 2, 0 );
+
+// Walls (NO_SCENT) and locked doors (REDUCE_SCENT) scattered around the center.
+static void place_scent_obstacles( map &here, const int sparseness )
+{
+    for( int x = scent_center.x - 45; x <= scent_center.x + 45; x++ ) {
+        for( int y = scent_center.y - 45; y <= scent_center.y + 45; y++ ) {
+            if( one_in( sparseness ) ) {
+                const ter_str_id &ter = one_in( 2 ) ? ter_t_brick_wall : ter_t_door_locked;
+                here.ter_set( tripoint( x, y, 0 ), ter );
+            }
+        }
+    }
+}
+
+// Scent in a few patches, leaving columns and whole regions without any, with
+// the occasional negative value.
+static void fill_scent( scent_map &scents, const unsigned int seed )
+{
+    rng_set_engine_seed( seed );
+    scents.reset();
+    for( int patch = 0; patch < 6; patch++ ) {
+        const point corner( rng( 0, MAPSIZE_X - 20 ), rng( 0, MAPSIZE_Y - 20 ) );
+        const int size = rng( 1, 19 );
+        for( int x = corner.x; x < corner.x + size; x++ ) {
+            for( int y = corner.y; y < corner.y + size; y++ ) {
+                scents.set( tripoint( x, y, 0 ), one_in( 20 ) ? rng( -50, -1 ) : rng( 0, 10000 ) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "scent_column_kernels_match_per_cell", "[scent]" )
+{
+    const scent_kernel original_kernel = get_scent_kernel();
+    on_out_of_scope restore_kernel( [original_kernel]() {
+        set_scent_kernel( original_kernel );
+    } );
+    map &here = get_map();
+    clear_map();
+
+    for( const int sparseness : { 1000, 8, 3 } ) {
+        place_scent_obstacles( here, sparseness );
+        for( unsigned int seed = 1; seed <= 4; seed++ ) {
+            scent_map expected( *g );
+            fill_scent( expected, seed );
+            set_scent_kernel( scent_kernel::per_cell );
+            for( int turn = 0; turn < 5; turn++ ) {
+                expected.update( scent_center, here );
+            }
+            for( const scent_kernel kernel : column_kernels ) {
+                set_scent_kernel( kernel );
+                if( get_scent_kernel() != kernel ) {
+                    continue;
+                }
+                CAPTURE( sparseness, seed, static_cast<int>( kernel ) );
+                scent_map actual( *g );
+                fill_scent( actual, seed );
+                for( int turn = 0; turn < 5; turn++ ) {
+                    actual.update( scent_center, here );
+                }
+                CHECK( actual.serialize() == expected.serialize() );
+            }
+        }
+    }
+    clear_map();
+}
+
+TEST_CASE( "scent_diffusion_benchmark", "[.][scent][benchmark]" )
+{
+    const scent_kernel original_kernel = get_scent_kernel();
+    on_out_of_scope restore_kernel( [original_kernel]() {
+        set_scent_kernel( original_kernel );
+    } );
+    map &here = get_map();
+    clear_map();
+    place_scent_obstacles( here, 8 );
+    scent_map scents( *g );
+
+    const auto run = [&]( const scent_kernel kernel ) {
+        set_scent_kernel( kernel );
+        fill_scent( scents, 7 );
+        for( int turn = 0; turn < 10; turn++ ) {
+            scents.update( scent_center, here );
+        }
+        return scents.get( scent_center );
+    };
+    BENCHMARK( "per_cell" ) {
+        return run( scent_kernel::per_cell );
+    };
+    BENCHMARK( "columns_scalar" ) {
+        return run( scent_kernel::columns_scalar );
+    };
+    BENCHMARK( "best available columns" ) {
+        return run( best_scent_kernel() );
+    };
+    clear_map();
+}
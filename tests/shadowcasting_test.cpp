@@ -3,11 +3,14 @@
 #include <chrono>
 #include <cstdio>
 #include <functional>
+#include <memory>
+#include <random>
 #include <sstream>
 #include <type_traits>
 #include <vector>
 
 #include "cata_catch.h"
+#include "cata_scope_helpers.h"
 #include "cuboid_rectangle.h"
 #include "game_constants.h"
 #include "level_cache.h"
@@ -1096,6 +1099,211 @@ TEST_CASE( "shadowcasting_floating_wall", "[shadowcasting]" )
     run_spot_check( test_case, expected_results, true );
 }
 
+static const std::array<shadowcasting_kernel, 3> row_kernels = {{
+        shadowcasting_kernel::rows_scalar, shadowcasting_kernel::rows_sse2,
+        shadowcasting_kernel::rows_avx2
+    }
+};
+
+static const char *kernel_name( const shadowcasting_kernel kernel )
+{
+    switch( kernel ) {
+        case shadowcasting_kernel::per_cell:
+            return "per_cell";
+        case shadowcasting_kernel::rows_scalar:
+            return "rows_scalar";
+        case shadowcasting_kernel::rows_sse2:
+            return "rows_sse2";
+        case shadowcasting_kernel::rows_avx2:
+            return "rows_avx2";
+    }
+    return "unknown";
+}
+
+struct kernel_test_grids {
+    std::array<cata::mdarray<float, point_bub_ms>, OVERMAP_LAYERS> transparency = {};
+    std::array<cata::mdarray<bool, point_bub_ms>, OVERMAP_LAYERS> floors = {};
+    std::array<cata::mdarray<float, point_bub_ms>, OVERMAP_LAYERS> seen = {};
+    cata::mdarray<float, point_bub_ms> seen_2d = {};
+    cata::mdarray<four_quadrants, point_bub_ms> lit_2d = {};
+};
+
+// Walls, open air and a couple of denser media, so that spans get split by
+// changes between transparent values too.
+static void fill_kernel_test_grids( kernel_test_grids &grids, const unsigned int one_in )
+{
+    std::uniform_int_distribution<unsigned int> distribution( 0, one_in * 4 );
+    const std::array<float, 4> special = {{
+            LIGHT_TRANSPARENCY_SOLID, LIGHT_TRANSPARENCY_SOLID,
+            LIGHT_TRANSPARENCY_OPEN_AIR * 4, LIGHT_TRANSPARENCY_OPEN_AIR * 16
+        }
+    };
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        grids.transparency[z + OVERMAP_DEPTH].fill_from_callable( [&]() {
+            const unsigned int roll = distribution( rng_get_engine() );
+            return roll < special.size() ? special[roll] : LIGHT_TRANSPARENCY_OPEN_AIR;
+        } );
+        grids.floors[z + OVERMAP_DEPTH].fill_from_callable( [&]() {
+            return distribution( rng_get_engine() ) < 2;
+        } );
+    }
+}
+
+static void run_kernel( kernel_test_grids &grids, const shadowcasting_kernel kernel,
+                        const tripoint &origin, const int offset_distance )
+{
+    set_shadowcasting_kernel( kernel );
+    grids.seen_2d.fill( 0.0f );
+    grids.lit_2d.fill( four_quadrants( 0.0f ) );
+    const cata::mdarray<float, point_bub_ms> &level = grids.transparency[origin.z + OVERMAP_DEPTH];
+    castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+        grids.seen_2d, level, origin.xy(), offset_distance );
+    castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                 accumulate_transparency>( grids.lit_2d, level, origin.xy(), offset_distance );
+
+    array_of_grids_of<float> seen_caches;
+    array_of_grids_of<const float> transparency_caches;
+    array_of_grids_of<const bool> floor_caches;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        grids.seen[z + OVERMAP_DEPTH].fill( 0.0f );
+        seen_caches[z + OVERMAP_DEPTH] = &grids.seen[z + OVERMAP_DEPTH];
+        transparency_caches[z + OVERMAP_DEPTH] = &grids.transparency[z + OVERMAP_DEPTH];
+        floor_caches[z + OVERMAP_DEPTH] = &grids.floors[z + OVERMAP_DEPTH];
+    }
+    cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
+        seen_caches, transparency_caches, floor_caches, origin, offset_distance, 1.0f );
+}
+
+static bool same_value( const float l, const float r )
+{
+    return l == r;
+}
+
+static bool same_value( const four_quadrants &l, const four_quadrants &r )
+{
+    return l.values == r.values;
+}
+
+template<typename Out>
+static int count_mismatches( const cata::mdarray<Out, point_bub_ms> &l,
+                             const cata::mdarray<Out, point_bub_ms> &r )
+{
+    int result = 0;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            result += !same_value( l[x][y], r[x][y] );
+        }
+    }
+    return result;
+}
+
+TEST_CASE( "shadowcasting_row_kernels_match_per_cell", "[shadowcasting]" )
+{
+    const shadowcasting_kernel original_kernel = get_shadowcasting_kernel();
+    on_out_of_scope restore_kernel( [original_kernel]() {
+        set_shadowcasting_kernel( original_kernel );
+    } );
+    restore_on_out_of_scope<bool> restore_trigdist( trigdist );
+
+    std::unique_ptr<kernel_test_grids> expected = std::make_unique<kernel_test_grids>();
+    std::unique_ptr<kernel_test_grids> actual = std::make_unique<kernel_test_grids>();
+    for( int i = 0; i < 12; i++ ) {
+        trigdist = i % 2 == 0;
+        fill_kernel_test_grids( *expected, i < 6 ? 5 : 50 );
+        actual->transparency = expected->transparency;
+        actual->floors = expected->floors;
+        const tripoint origin( rng( 0, MAPSIZE_X - 1 ), rng( 0, MAPSIZE_Y - 1 ), rng( -2, 2 ) );
+        const int offset_distance = i % 3 == 0 ? 10 : 0;
+        CAPTURE( trigdist, origin, offset_distance );
+        run_kernel( *expected, shadowcasting_kernel::per_cell, origin, offset_distance );
+
+        for( const shadowcasting_kernel kernel : row_kernels ) {
+            run_kernel( *actual, kernel, origin, offset_distance );
+            CAPTURE( kernel_name( get_shadowcasting_kernel() ) );
+            // The row kernels must be exact, not just agree on what is visible.
+            CHECK( count_mismatches( actual->seen_2d, expected->seen_2d ) == 0 );
+            CHECK( count_mismatches( actual->lit_2d, expected->lit_2d ) == 0 );
+            for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+                CAPTURE( z );
+                CHECK( count_mismatches( actual->seen[z + OVERMAP_DEPTH],
+                                         expected->seen[z + OVERMAP_DEPTH] ) == 0 );
+            }
+        }
+    }
+}
+
+static long long count_nonzero( const cata::mdarray<float, point_bub_ms> &grid )
+{
+    long long result = 0;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            result += grid[x][y] != 0.0f;
+        }
+    }
+    return result;
+}
+
+TEST_CASE( "shadowcasting_row_kernels_benchmark", "[.][shadowcasting][benchmark]" )
+{
+    const shadowcasting_kernel original_kernel = get_shadowcasting_kernel();
+    on_out_of_scope restore_kernel( [original_kernel]() {
+        set_shadowcasting_kernel( original_kernel );
+    } );
+    constexpr int iterations = 2000;
+    const tripoint origin( 65, 65, 0 );
+    std::unique_ptr<kernel_test_grids> grids = std::make_unique<kernel_test_grids>();
+
+    for( const unsigned int one_in : { 10U, 1000U } ) {
+        fill_kernel_test_grids( *grids, one_in );
+        for( const shadowcasting_kernel kernel : {
+                 shadowcasting_kernel::per_cell, shadowcasting_kernel::rows_scalar,
+                 shadowcasting_kernel::rows_sse2, shadowcasting_kernel::rows_avx2
+             } ) {
+            set_shadowcasting_kernel( kernel );
+            if( get_shadowcasting_kernel() != kernel ) {
+                continue;
+            }
+            // Cells lit by a single cast, to turn timings into cells per second.
+            run_kernel( *grids, kernel, origin, 0 );
+            const long long cells_2d = count_nonzero( grids->seen_2d );
+            long long cells_3d = 0;
+            for( const cata::mdarray<float, point_bub_ms> &level : grids->seen ) {
+                cells_3d += count_nonzero( level );
+            }
+
+            const cata::mdarray<float, point_bub_ms> &level = grids->transparency[OVERMAP_DEPTH];
+            const auto start_2d = std::chrono::high_resolution_clock::now();
+            for( int i = 0; i < iterations; i++ ) {
+                castLightAll<float, float, sight_calc, sight_check, update_light,
+                             accumulate_transparency>( grids->seen_2d, level, origin.xy() );
+            }
+            const auto end_2d = std::chrono::high_resolution_clock::now();
+
+            array_of_grids_of<float> seen_caches;
+            array_of_grids_of<const float> transparency_caches;
+            array_of_grids_of<const bool> floor_caches;
+            for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+                seen_caches[z + OVERMAP_DEPTH] = &grids->seen[z + OVERMAP_DEPTH];
+                transparency_caches[z + OVERMAP_DEPTH] = &grids->transparency[z + OVERMAP_DEPTH];
+                floor_caches[z + OVERMAP_DEPTH] = &grids->floors[z + OVERMAP_DEPTH];
+            }
+            const auto start_3d = std::chrono::high_resolution_clock::now();
+            for( int i = 0; i < iterations / 10; i++ ) {
+                cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
+                    seen_caches, transparency_caches, floor_caches, origin, 0, 1.0f );
+            }
+            const auto end_3d = std::chrono::high_resolution_clock::now();
+
+            const double seconds_2d = std::chrono::duration<double>( end_2d - start_2d ).count();
+            const double seconds_3d = std::chrono::duration<double>( end_3d - start_3d ).count();
+            printf( "%s, one obstacle in %u: 2D %.1f Mcells/s, 3D %.1f Mcells/s\n",
+                    kernel_name( kernel ), one_in,
+                    cells_2d * iterations / seconds_2d / 1e6,
+                    cells_3d * ( iterations / 10 ) / seconds_3d / 1e6 );
+        }
+    }
+}
+
 // Some random edge cases aren't matching.
 TEST_CASE( "shadowcasting_runoff", "[.]" )
 {
@@ -4,12 +4,15 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "calendar.h"
 #include "cata_catch.h"
 #include "colony.h"
 #include "construction.h"
+#include "coordinates.h"
 #include "field.h"
 #include "game_constants.h"
 #include "item.h"
@@ -20,6 +23,7 @@
 #include "point.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "submap_binary.h"
 #include "trap.h"
 #include "type_id.h"
 #include "vehicle.h"
@@ -1487,3 +1491,59 @@ TEST_CASE( "submap_ter_furn_migration", "[submap][load]" )
     REQUIRE( furn_sw == furn_test_f_migration_new_id );
     REQUIRE( furn_se == furn_test_f_migration_new_id );
 }
+
+static std::string store_to_string( const submap &sm )
+{
+    std::ostringstream out;
+    JsonOut jsout( out );
+    jsout.start_object();
+    sm.store( jsout );
+    jsout.end_object();
+    return out.str();
+}
+
+TEST_CASE( "submap_binary_round_trip", "[submap][load]" )
+{
+    const std::vector<std::pair<std::string, const JsonValue *>> fixtures = {
+        { "empty", &submap_empty }, { "terrain_rle", &submap_terrain_rle },
+        { "furniture", &submap_furniture }, { "trap", &submap_trap }, { "rad", &submap_rad },
+        { "item", &submap_item }, { "field", &submap_field }, { "graffiti", &submap_graffiti },
+        { "spawns", &submap_spawns }, { "vehicle", &submap_vehicle },
+        { "construction", &submap_construction }, { "computer", &submap_computer },
+        { "cosmetic", &submap_cosmetic }, { "pre_migration", &submap_pre_migration }
+    };
+    for( const std::pair<std::string, const JsonValue *> &fixture : fixtures ) {
+        CAPTURE( fixture.first );
+        submap sm;
+        load_from_jsin( sm, *fixture.second );
+        const tripoint_abs_sm pos( 3, -2, 1 );
+
+        std::ostringstream out;
+        submap_binary::write_quad( out, { { pos, &sm } } );
+        const std::string data = out.str();
+        REQUIRE( submap_binary::is_binary( data ) );
+        // The tile layers shrink to a few bytes, everything else stays the same size.
+        CHECK( data.size() < store_to_string( sm ).size() );
+
+        std::vector<std::pair<tripoint_abs_sm, std::unique_ptr<submap>>> loaded =
+            submap_binary::read_quad( data );
+        REQUIRE( loaded.size() == 1 );
+        CHECK( loaded[0].first == pos );
+        CHECK( store_to_string( *loaded[0].second ) == store_to_string( sm ) );
+    }
+}
+
+TEST_CASE( "submap_binary_rejects_corrupt_data", "[submap][load]" )
+{
+    submap sm;
+    load_from_jsin( sm, submap_item );
+    std::ostringstream out;
+    submap_binary::write_quad( out, { { tripoint_abs_sm( 0, 0, 0 ), &sm } } );
+    const std::string data = out.str();
+
+    CHECK_FALSE( submap_binary::is_binary( submap_empty_ss ) );
+    CHECK_THROWS( submap_binary::read_quad( submap_empty_ss ) );
+    const std::string_view truncated = std::string_view( data ).substr( 0, data.size() / 2 );
+    CHECK_THROWS( submap_binary::read_quad( truncated ) );
+    CHECK_THROWS( submap_binary::read_quad( data + "x" ) );
+}
@@ -1,3 +1,6 @@
+#include <optional>
+#include <vector>
+
 #include "calendar.h"
 #include "cata_utility.h"
 #include "cata_catch.h"
@@ -290,3 +293,78 @@ TEST_CASE( "Temperature_controlled_location", "[temperature]" )
                     temperatures::normal ) ) );
     }
 }
+
+static std::vector<item> spawn_food( const int count )
+{
+    std::vector<item> food;
+    for( int i = 0; i < count; i++ ) {
+        food.emplace_back( i % 3 == 0 ? "water" : "meat" );
+    }
+    return food;
+}
+
+TEST_CASE( "Batched_temperature_processing_matches_single_items", "[temperature]" )
+{
+    map &here = get_map();
+    const tripoint pos( 60, 60, 0 );
+    set_map_temperature( units::from_fahrenheit( 70 ) );
+    std::vector<item> single = spawn_food( 10 );
+    std::vector<item> batched = spawn_food( 10 );
+    for( item &it : single ) {
+        it.process_temperature_rot( 1, pos, here, nullptr );
+    }
+    {
+        item_temperature_batch batch( pos, here );
+        for( item &it : batched ) {
+            it.process_temperature_rot( 1, pos, here, nullptr );
+        }
+    }
+
+    // Long enough to go through the hourly weather samples.
+    calendar::turn += 3_days + 17_minutes;
+    for( item &it : single ) {
+        it.process_temperature_rot( 1, pos, here, nullptr );
+    }
+    {
+        item_temperature_batch batch( pos, here );
+        CHECK( item_temperature_batch::find( pos, here ) == &batch );
+        CHECK( item_temperature_batch::find( pos + tripoint_east, here ) == nullptr );
+        for( item &it : batched ) {
+            it.process_temperature_rot( 1, pos, here, nullptr );
+        }
+    }
+    CHECK( item_temperature_batch::find( pos, here ) == nullptr );
+
+    for( size_t i = 0; i < single.size(); i++ ) {
+        CAPTURE( i, single[i].typeId().str() );
+        CHECK( units::to_kelvin( batched[i].temperature ) ==
+               units::to_kelvin( single[i].temperature ) );
+        CHECK( batched[i].get_rot() == single[i].get_rot() );
+    }
+}
+
+TEST_CASE( "Batched_temperature_processing_benchmark", "[.][temperature][benchmark]" )
+{
+    map &here = get_map();
+    const tripoint pos( 60, 60, 0 );
+    std::vector<item> food = spawn_food( 200 );
+    const time_point start = calendar::turn;
+    const auto catch_up = [&]( const bool batched ) {
+        std::optional<item_temperature_batch> batch;
+        if( batched ) {
+            batch.emplace( pos, here );
+        }
+        // A pantry that was out of the reality bubble for a week.
+        for( item &it : food ) {
+            it.set_last_temp_check( start - 7_days );
+            it.process_temperature_rot( 1, pos, here, nullptr );
+        }
+        return units::to_kelvin( food.front().temperature );
+    };
+    BENCHMARK( "each item on its own" ) {
+        return catch_up( false );
+    };
+    BENCHMARK( "one batch for the tile" ) {
+        return catch_up( true );
+    };
+}
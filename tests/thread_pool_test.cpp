@@ -0,0 +1,48 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "cata_catch.h"
+#include "thread_pool.h"
+
+TEST_CASE( "thread_pool_runs_every_index_once", "[thread_pool]" )
+{
+    cata::thread_pool pool( 3 );
+    std::vector<std::atomic<int>> counts( 100 );
+    for( int round = 0; round < 10; ++round ) {
+        pool.parallel_for( 0, 100, [&]( int i ) {
+            ++counts[i];
+        } );
+    }
+    for( const std::atomic<int> &count : counts ) {
+        CHECK( count == 10 );
+    }
+}
+
+TEST_CASE( "thread_pool_nested_parallel_for_runs_inline", "[thread_pool]" )
+{
+    cata::thread_pool pool( 2 );
+    std::atomic<int> total{ 0 };
+    pool.parallel_for( 0, 4, [&]( int ) {
+        pool.parallel_for( 0, 4, [&]( int ) {
+            ++total;
+        } );
+    } );
+    CHECK( total == 16 );
+}
+
+TEST_CASE( "thread_pool_propagates_exceptions", "[thread_pool]" )
+{
+    cata::thread_pool pool( 2 );
+    CHECK_THROWS_AS( pool.parallel_for( 0, 8, []( int i ) {
+        if( i == 5 ) {
+            throw std::runtime_error( "job failed" );
+        }
+    } ), std::runtime_error );
+    // The pool is still usable afterwards.
+    std::atomic<int> total{ 0 };
+    pool.parallel_for( 0, 8, [&]( int ) {
+        ++total;
+    } );
+    CHECK( total == 8 );
+}
@@ -14,6 +14,8 @@
 #include "weather.h"
 #include "weather_type.h"
 
+static const ammotype ammo_battery( "battery" );
+
 static const efftype_id effect_blind( "blind" );
 
 static const itype_id fuel_type_battery( "battery" );
@@ -145,6 +147,8 @@ TEST_CASE( "power_loss_to_cables", "[vehicle][power]" )
     const optional_vpart_position ovp_first = here.veh_at( placements[0] );
     REQUIRE( ovp_first.has_value() );
     vehicle &v = ovp_first->vehicle(); // charge first battery
+    REQUIRE( v.power_network().vehicles.size() == placements.size() );
+    REQUIRE( v.power_network().batteries.size() == batteries.size() );
     struct preset_t {
         const int charge;                // how much charge to expect
         const int max_charge_excess;     // minimum expect to spill out
@@ -170,6 +174,40 @@ TEST_CASE( "power_loss_to_cables", "[vehicle][power]" )
     }
 }
 
+TEST_CASE( "power_network_follows_battery_changes", "[vehicle][power]" )
+{
+    clear_vehicles();
+    reset_player();
+    build_test_map( ter_id( "t_pavement" ) );
+    map &here = get_map();
+
+    vehicle *veh = here.add_vehicle( vehicle_prototype_none, tripoint( 4, 10, 0 ), 0_degrees, 0, 0 );
+    REQUIRE( veh != nullptr );
+    REQUIRE( veh->install_part( point_zero, vpart_frame ) != -1 );
+    const int first = veh->install_part( point_zero, vpart_small_storage_battery );
+    REQUIRE( first != -1 );
+    const int capacity = veh->part( first ).ammo_capacity( ammo_battery );
+    REQUIRE( veh->power_network().batteries.size() == 1 );
+    REQUIRE( veh->fuel_capacity( fuel_type_battery ) == capacity );
+
+    WHEN( "a second battery is installed" ) {
+        REQUIRE( veh->install_part( point_east, vpart_frame ) != -1 );
+        REQUIRE( veh->install_part( point_east, vpart_small_storage_battery ) != -1 );
+        THEN( "the cached network picks it up" ) {
+            CHECK( veh->power_network().batteries.size() == 2 );
+            CHECK( veh->fuel_capacity( fuel_type_battery ) == 2 * capacity );
+        }
+    }
+    WHEN( "the battery is removed" ) {
+        veh->remove_part( veh->part( first ) );
+        veh->part_removal_cleanup();
+        THEN( "the cached network drops it" ) {
+            CHECK( veh->power_network().batteries.empty() );
+            CHECK( veh->charge_battery( 100 ) == 100 );
+        }
+    }
+}
+
 TEST_CASE( "Solar_power", "[vehicle][power]" )
 {
     clear_vehicles();
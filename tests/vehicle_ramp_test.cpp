@@ -132,7 +132,7 @@ static void ramp_transition_angled( const vproto_id &veh_id, const units::angle
     int cycles = 0;
     const int target_z = use_ramp ? ( up ? 1 : -1 ) : 0;
 
-    std::set<tripoint> vpts = veh.get_points();
+    std::vector<tripoint> vpts = veh.get_points();
     while( veh.engine_on && veh.safe_velocity() > 0 && cycles < 10 ) {
         clear_creatures();
         CAPTURE( cycles );
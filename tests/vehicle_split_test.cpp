@@ -29,7 +29,8 @@ TEST_CASE( "vehicle_split_section", "[vehicle]" )
         vehicle *veh_ptr = here.add_vehicle( vehicle_prototype_cross_split_test,
                                              vehicle_origin, dir, 0, 0 );
         REQUIRE( veh_ptr != nullptr );
-        std::set<tripoint> original_points = veh_ptr->get_points( true );
+        const std::vector<tripoint> &original_list = veh_ptr->get_points( true );
+        std::set<tripoint> original_points( original_list.begin(), original_list.end() );
 
         here.destroy( vehicle_origin );
         veh_ptr->part_removal_cleanup();
@@ -45,8 +46,8 @@ TEST_CASE( "vehicle_split_section", "[vehicle]" )
             CHECK( vehs[ 3 ].v->part_count() == 3 );
             std::vector<std::set<tripoint>> all_points;
             for( int i = 0; i < 4; i++ ) {
-                const std::set<tripoint> &veh_points = vehs[ i ].v->get_points( true );
-                all_points.push_back( veh_points );
+                const std::vector<tripoint> &veh_points = vehs[ i ].v->get_points( true );
+                all_points.emplace_back( veh_points.begin(), veh_points.end() );
             }
             for( int i = 0; i < 4; i++ ) {
                 std::set<tripoint> &veh_points = all_points[ i ];
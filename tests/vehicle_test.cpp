@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <optional>
 #include <vector>
 
@@ -15,9 +16,12 @@
 #include "point.h"
 #include "type_id.h"
 #include "units.h"
+#include "units_utility.h"
 #include "veh_appliance.h"
 #include "vehicle.h"
 #include "veh_type.h"
+#include "vpart_position.h"
+#include "vpart_range.h"
 
 static const damage_type_id damage_pure( "pure" );
 
@@ -780,3 +784,140 @@ TEST_CASE( "autopilot_tests", "[vehicle][autopilot]" )
     CHECK( test_autopilot_moving( vehicle_prototype_car, vpart_id::NULL_ID() ) == 0 );
     CHECK( test_autopilot_moving( vehicle_prototype_car, vpart_programmable_autopilot ) == 9 );
 }
+
+// the mount and tile grids must agree with a plain walk over the part list
+static void check_part_lookups( const vehicle &veh )
+{
+    for( const vpart_reference &vp : veh.get_all_parts() ) {
+        if( vp.part().removed ) {
+            continue;
+        }
+        std::vector<int> cached = veh.parts_at_relative( vp.mount(), true );
+        std::vector<int> scanned = veh.parts_at_relative( vp.mount(), false );
+        std::sort( cached.begin(), cached.end() );
+        CHECK( cached == scanned );
+
+        const tripoint pos = veh.global_part_pos3( vp.part() );
+        std::vector<const vehicle_part *> expected;
+        std::vector<const vehicle_part *> expected_cargo;
+        for( const vpart_reference &other : veh.get_all_parts() ) {
+            if( !other.part().removed && veh.global_part_pos3( other.part() ) == pos ) {
+                expected.push_back( &other.part() );
+                if( other.info().has_flag( "CARGO" ) ) {
+                    expected_cargo.push_back( &other.part() );
+                }
+            }
+        }
+        CHECK( veh.get_parts_at( pos, "", part_status_flag::any ) == expected );
+        CHECK( veh.get_parts_at( pos, "CARGO", part_status_flag::any ) == expected_cargo );
+        CHECK( veh.get_parts_at( pos, VPFLAG_CARGO, part_status_flag::any ) == expected_cargo );
+        CHECK( veh.part_at( ( pos - veh.global_pos3() ).xy() ) ==
+               veh.index_of_part( expected.front() ) );
+    }
+}
+
+TEST_CASE( "vehicle_part_lookups_match_part_scan", "[vehicle]" )
+{
+    clear_map();
+    map &here = get_map();
+    const units::angle dir = GENERATE( 0_degrees, 45_degrees, 90_degrees, 225_degrees );
+    CAPTURE( to_degrees( dir ) );
+    vehicle *veh_ptr = here.add_vehicle( vehicle_prototype_car, tripoint( 60, 60, 0 ), dir, 0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    check_part_lookups( *veh_ptr );
+
+    WHEN( "a part is removed" ) {
+        std::optional<vpart_reference> cargo;
+        for( const vpart_reference &vp : veh_ptr->get_any_parts( VPFLAG_CARGO ) ) {
+            cargo = vp;
+            break;
+        }
+        REQUIRE( cargo );
+        veh_ptr->remove_part( cargo->part() );
+        veh_ptr->part_removal_cleanup();
+        check_part_lookups( *veh_ptr );
+    }
+}
+
+TEST_CASE( "vehicle_broadphase_finds_nearby_vehicles", "[vehicle]" )
+{
+    clear_map();
+    map &here = get_map();
+    const units::angle dir = GENERATE( 0_degrees, 45_degrees, 180_degrees );
+    CAPTURE( to_degrees( dir ) );
+    vehicle *veh_ptr = here.add_vehicle( vehicle_prototype_car, tripoint( 60, 60, 0 ), dir, 0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+
+    const inclusive_cuboid<tripoint> bounds = veh_ptr->occupied_bounds();
+    for( const vpart_reference &vp : veh_ptr->get_all_parts() ) {
+        CHECK( bounds.contains( vp.pos() ) );
+    }
+    const tripoint pos = veh_ptr->global_pos3();
+    CHECK( here.may_have_vehicle_in( inclusive_cuboid<tripoint>( pos, pos ), nullptr ) );
+    CHECK_FALSE( here.may_have_vehicle_in( inclusive_cuboid<tripoint>( pos, pos ), veh_ptr ) );
+    const inclusive_cuboid<tripoint> far_away( pos + tripoint( 20, 20, 0 ),
+            pos + tripoint( 30, 30, 0 ) );
+    CHECK_FALSE( here.may_have_vehicle_in( far_away, nullptr ) );
+}
+
+TEST_CASE( "vehicle_rotation_tables_match_coord_translate", "[vehicle]" )
+{
+    clear_map();
+    map &here = get_map();
+    vehicle *veh_ptr = here.add_vehicle( vehicle_prototype_car, tripoint( 60, 60, 0 ), 0_degrees,
+                                         0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    const units::angle dir = GENERATE( 0_degrees, 15_degrees, 90_degrees, 255_degrees,
+                                       -30_degrees, 37_degrees );
+    CAPTURE( to_degrees( dir ) );
+    const point pivot = veh_ptr->pivot_point();
+    // the second pass is served from the table the first one filled
+    for( int pass = 0; pass < 2; pass++ ) {
+        veh_ptr->precalc_mounts( 1, dir, pivot );
+        for( const vpart_reference &vp : veh_ptr->get_all_parts() ) {
+            tripoint expected = vp.part().precalc[1];
+            veh_ptr->coord_translate( dir, pivot, vp.mount(), expected );
+            CHECK( vp.part().precalc[1] == expected );
+        }
+    }
+
+    const std::vector<tripoint> &points = veh_ptr->get_points( true );
+    CHECK( std::is_sorted( points.begin(), points.end() ) );
+    CHECK( std::adjacent_find( points.begin(), points.end() ) == points.end() );
+    for( const vpart_reference &vp : veh_ptr->get_all_parts() ) {
+        CHECK( std::binary_search( points.begin(), points.end(), vp.pos() ) );
+    }
+}
+
+TEST_CASE( "vehicle_rotation_tables_cover_rounded_facings", "[vehicle]" )
+{
+    clear_map();
+    map &here = get_map();
+    vehicle *veh_ptr = here.add_vehicle( vehicle_prototype_car, tripoint( 60, 60, 0 ), 0_degrees,
+                                         0, 0 );
+    REQUIRE( veh_ptr != nullptr );
+    const point pivot = veh_ptr->pivot_point();
+    std::vector<units::angle> facings;
+    // what steering produces: rounded to a steer_increment, or turned by one repeatedly
+    for( int deg = -360; deg <= 360; deg += 7 ) {
+        facings.push_back( round_to_multiple_of( units::from_degrees( deg ),
+                           vehicles::steer_increment ) );
+    }
+    units::angle turned = 0_degrees;
+    for( int i = 0; i < 200; i++ ) {
+        turned = normalize( turned + ( i % 3 == 0 ? -1 : 1 ) * vehicles::steer_increment );
+        facings.push_back( turned );
+    }
+    for( const units::angle &dir : facings ) {
+        CAPTURE( to_degrees( dir ) );
+        CHECK( vehicle::rotation_table_index( dir ) >= 0 );
+        veh_ptr->precalc_mounts( 1, dir, pivot );
+        for( const vpart_reference &vp : veh_ptr->get_all_parts() ) {
+            tripoint expected = vp.part().precalc[1];
+            veh_ptr->coord_translate( dir, pivot, vp.mount(), expected );
+            CHECK( vp.part().precalc[1] == expected );
+        }
+    }
+    CHECK( vehicle::rotation_table_index( 37_degrees ) < 0 );
+    CHECK( vehicle::rotation_table_index( 15_degrees + 0.001_degrees ) < 0 );
+}
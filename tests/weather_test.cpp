@@ -471,3 +471,36 @@ TEST_CASE( "local_wind_chill_calculation", "[weather][wind_chill]" )
     }
 }
 
+
+TEST_CASE( "sum_conditions_caches_whole_days", "[weather]" )
+{
+    weather_manager &weather = get_weather();
+    weather.daily_sum_cache.clear();
+    const tripoint_abs_ms location( 100, 100, 0 );
+    const time_point midnight = calendar::turn_zero + 10_days;
+
+    const weather_sum days = sum_conditions( midnight, midnight + 3_days, location );
+    CHECK( weather.daily_sum_cache.size() == 3 );
+    weather_sum by_day;
+    for( int day = 0; day < 3; day++ ) {
+        by_day += weather.get_daily_sum( location, midnight + day * 1_days );
+    }
+    CHECK( weather.daily_sum_cache.size() == 3 );
+    CHECK( days.rain_amount == by_day.rain_amount );
+    CHECK( days.radiant_exposure == Approx( by_day.radiant_exposure ) );
+    CHECK( days.sunlight == Approx( by_day.sunlight ) );
+
+    // partial days on either side are sampled as before, only the middle is cached
+    const weather_sum longer = sum_conditions( midnight - 5_hours, midnight + 3_days + 2_hours,
+                               location );
+    CHECK( weather.daily_sum_cache.size() == 3 );
+    CHECK( longer.radiant_exposure >= days.radiant_exposure );
+    CHECK( longer.rain_amount >= days.rain_amount );
+
+    GIVEN( "an overridden weather" ) {
+        weather.daily_sum_cache.clear();
+        scoped_weather_override clear_weather( WEATHER_CLEAR );
+        sum_conditions( midnight, midnight + 3_days, location );
+        CHECK( weather.daily_sum_cache.empty() );
+    }
+}